@@ -0,0 +1,88 @@
+// Wakeup cost of a coroutine on the IoLoop against a dedicated thread.
+//
+// Both sides bounce a token between two eventfds. With threads every
+// hand-over is a context switch, on the IoLoop it is a resume on the loop
+// thread after epoll_wait.
+#include <benchmark/benchmark.h>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+
+#include "IoLoop.hpp"
+
+namespace {
+
+void signal(int fd) {
+  uint64_t one = 1;
+  if (write(fd, &one, sizeof(one)) < 0)
+    std::abort();
+}
+
+void drain(int fd) {
+  uint64_t value = 0;
+  if (read(fd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+    std::abort();
+}
+
+// Echo every ping as a pong until the loop shuts down
+Task echo(IoLoop &io, int ping, int pong) {
+  while (true) {
+    co_await io.readable(ping);
+    drain(ping);
+    signal(pong);
+  }
+}
+
+} // namespace
+
+static void BM_CoroutineRoundTrip(benchmark::State &state) {
+  int ping = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  int pong = eventfd(0, EFD_CLOEXEC);
+
+  IoLoop io;
+  echo(io, ping, pong);
+  io.start();
+
+  for (auto _ : state) {
+    signal(ping);
+    drain(pong);
+  }
+
+  io.shutdown();
+  close(ping);
+  close(pong);
+}
+BENCHMARK(BM_CoroutineRoundTrip)->UseRealTime();
+
+static void BM_ThreadRoundTrip(benchmark::State &state) {
+  int ping = eventfd(0, EFD_CLOEXEC);
+  int pong = eventfd(0, EFD_CLOEXEC);
+  std::atomic<bool> running{true};
+
+  // The old Device model: one blocked thread per source
+  std::thread worker([&] {
+    while (true) {
+      drain(ping);
+      if (!running.load())
+        return;
+      signal(pong);
+    }
+  });
+
+  for (auto _ : state) {
+    signal(ping);
+    drain(pong);
+  }
+
+  running.store(false);
+  signal(ping);
+  worker.join();
+  close(ping);
+  close(pong);
+}
+BENCHMARK(BM_ThreadRoundTrip)->UseRealTime();
@@ -0,0 +1,356 @@
+// End-to-end latency: serial byte written to the pty -> weight in a frame.
+//
+// Runs the real Device -> SDLManager path on the offscreen video driver with
+// the software renderer. A generator thread writes indicator lines into a
+// pty; the render loop reads every frame back, identifies the weight shown
+// by its pixels and reports how long each new value took to appear. The
+// wake scenario loads the scale while the display is blanked, the input
+// scenario taps the weight and waits for the QR code (and back).
+#include <pty.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Config.hpp"
+#include "Device.hpp"
+#include "Graphics.hpp"
+#include "IoLoop.hpp"
+#include "WeightPipeline.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Values shown during a run, every one is fingerprinted before measuring
+constexpr int32_t VALUES[] = {1111, 2222, 3333, 4444, 5555, 6666, 7777, 8888};
+
+// Frames still rendered after the generator is done
+constexpr auto DRAIN_TIME = std::chrono::milliseconds(500);
+
+// Same seed every run, so runs are comparable between commits
+constexpr uint32_t SEED = 20240601;
+
+// Idle timeouts of the wake scenario, short to keep the run quick
+constexpr auto WAKE_DIM_AFTER = std::chrono::milliseconds(100);
+constexpr auto WAKE_BLANK_AFTER = std::chrono::milliseconds(300);
+
+// Loads measured from a blanked display
+constexpr int WAKE_RUNS = 20;
+
+// A run that does not blank or show the load within this is missed
+constexpr auto WAKE_TIMEOUT = std::chrono::seconds(3);
+
+// Time between lines in the wake scenario, the indicator's 50 Hz
+constexpr auto WAKE_LINE_PERIOD = std::chrono::milliseconds(20);
+
+// Taps measured, each switches between weight and QR code
+constexpr int INPUT_RUNS = 20;
+
+/**
+ * @brief How the generator writes lines.
+ */
+struct Scenario {
+  const char *name;
+  std::chrono::microseconds period; // Time between two writes.
+  std::chrono::microseconds jitter; // Random extra delay, up to this much.
+  int linesPerWrite;                // Lines in one write (bursts).
+  int writesPerValue;               // Writes before the value changes.
+  int changes;                      // Values measured.
+};
+
+constexpr Scenario SCENARIOS[] = {
+    // Indicator streaming at 50 Hz, a new weight every 200 ms
+    {"steady", std::chrono::milliseconds(20), {}, 1, 10, 60},
+    // Adapter delivering 5 buffered lines at once
+    {"burst", std::chrono::milliseconds(100), {}, 5, 2, 60},
+    // Irregular timing, 5 to 45 ms between lines
+    {"jitter", std::chrono::milliseconds(5), std::chrono::milliseconds(40), 1,
+     8, 60},
+};
+
+/**
+ * @brief A value the generator started sending.
+ */
+struct Sent {
+  int32_t value;
+  Clock::time_point at;
+};
+
+// FNV-1a over the weight rows of a frame
+uint64_t fingerprint(const std::vector<uint32_t> &pixels) {
+  uint64_t hash = 1469598103934665603ull;
+  for (uint32_t pixel : pixels) {
+    hash ^= pixel;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// Writes a scenario into the pty master and records every value change
+void generate(int master, const Scenario &scenario, std::vector<Sent> &sent,
+              std::mutex &mutex) {
+  std::mt19937 random(SEED);
+  std::uniform_int_distribution<int64_t> jitter(0, scenario.jitter.count());
+
+  auto next = Clock::now();
+  int32_t value = VALUES[0];
+
+  for (int change = 0; change < scenario.changes; ++change) {
+    // Never repeat the previous value, the change would not be visible
+    int32_t previous = value;
+    while (value == previous)
+      value = VALUES[random() % std::size(VALUES)];
+
+    for (int write = 0; write < scenario.writesPerValue; ++write) {
+      std::string lines;
+      for (int line = 0; line < scenario.linesPerWrite; ++line) {
+        // A burst carries older samples first, the new value last
+        bool last = line == scenario.linesPerWrite - 1;
+        lines += std::to_string(last || write > 0 ? value : previous + line);
+        lines += '\n';
+      }
+
+      std::this_thread::sleep_until(next);
+      if (write == 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sent.push_back(Sent{value, Clock::now()});
+      }
+      if (::write(master, lines.data(), lines.size()) < 0)
+        std::cerr << "[Latency] pty write failed\n";
+
+      next += scenario.period + std::chrono::microseconds(jitter(random));
+    }
+  }
+}
+
+void writeLine(int master, int32_t value) {
+  char line[16];
+  auto [end, ec] = std::to_chars(line, line + sizeof(line) - 1, value);
+  *end++ = '\n';
+  if (::write(master, line, static_cast<std::size_t>(end - line)) < 0)
+    std::cerr << "[Latency] pty write failed\n";
+}
+
+void report(const char *name, std::vector<int64_t> &latencies, int missed) {
+  if (latencies.empty()) {
+    std::cout << "[Latency] " << name << ": no value seen\n";
+    return;
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  auto at = [&latencies](std::size_t percent) {
+    return latencies[std::min(latencies.size() - 1,
+                              latencies.size() * percent / 100)];
+  };
+
+  std::printf("[Latency] %-7s n=%-4zu p50=%6.2f ms  p99=%6.2f ms  "
+              "max=%6.2f ms  missed=%d\n",
+              name, latencies.size(), at(50) / 1000.0, at(99) / 1000.0,
+              latencies.back() / 1000.0, missed);
+}
+
+} // namespace
+
+int main() {
+  // Headless and with a readable back buffer, keep what the caller set
+  setenv("SDL_VIDEODRIVER", "offscreen", 0);
+  setenv("SDL_RENDER_DRIVER", "software", 0);
+
+  int master = -1;
+  int slave = -1;
+  char name[64];
+  if (openpty(&master, &slave, name, nullptr, nullptr) < 0) {
+    std::cerr << "[Latency] openpty failed\n";
+    return 1;
+  }
+
+  AppConfig config;
+  config.port = name;
+
+  SDLManager sdl("latency-bench", config);
+
+  // Weight rows only, the trend and price lie outside
+  SDL_Rect area{0, WEIGHT_Y, WINDOW_WIDTH, WEIGHT_HEIGHT};
+  std::vector<uint32_t> pixels(static_cast<std::size_t>(area.w) * area.h);
+  int pitch = area.w * static_cast<int>(sizeof(uint32_t));
+  TrendSeries trend{};
+
+  // Fingerprint every value once, the same text always gives the same pixels
+  std::unordered_map<uint64_t, int32_t> shown;
+  WeightPipeline pipeline;
+  for (int32_t value : VALUES) {
+    sdl.render(pipeline.process(value), "bench", "", trend);
+    if (!sdl.readPixels(area, pixels.data(), pitch))
+      return 1;
+    shown[fingerprint(pixels)] = value;
+  }
+  if (shown.size() != std::size(VALUES)) {
+    std::cerr << "[Latency] Values are not told apart, is the font loaded?\n";
+    return 1;
+  }
+
+  IoLoop io;
+  Device device(io, config);
+  io.start();
+
+  for (const Scenario &scenario : SCENARIOS) {
+    std::vector<Sent> sent;
+    sent.reserve(scenario.changes);
+    std::mutex mutex;
+
+    std::thread generator(generate, master, std::cref(scenario),
+                          std::ref(sent), std::ref(mutex));
+
+    std::vector<int64_t> latencies;
+    std::size_t matched = 0;
+    int32_t last = 0;
+    Clock::time_point drainUntil = Clock::time_point::max();
+
+    while (Clock::now() < drainUntil) {
+      sdl.render(device.getReading(), "bench", "", trend);
+      auto frame = Clock::now();
+
+      if (!sdl.readPixels(area, pixels.data(), pitch))
+        break;
+
+      auto value = shown.find(fingerprint(pixels));
+      if (value != shown.end() && value->second != last) {
+        last = value->second;
+
+        // Newest send of this value, older ones were overtaken
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::size_t i = sent.size(); i-- > matched;) {
+          if (sent[i].value == last) {
+            latencies.push_back(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    frame - sent[i].at)
+                    .count());
+            matched = i + 1;
+            break;
+          }
+        }
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if (drainUntil == Clock::time_point::max() &&
+          sent.size() == static_cast<std::size_t>(scenario.changes))
+        drainUntil = Clock::now() + DRAIN_TIME;
+    }
+
+    generator.join();
+    report(scenario.name, latencies,
+           scenario.changes - static_cast<int>(latencies.size()));
+  }
+
+  // Empty scale until blanked, then a load: time to its first frame
+  sdl.setIdleTimeouts(WAKE_DIM_AFTER, WAKE_BLANK_AFTER);
+  std::vector<int64_t> wakes;
+  int missed = 0;
+
+  for (int run = 0; run < WAKE_RUNS; ++run) {
+    int32_t value = VALUES[run % std::size(VALUES)];
+    auto next = Clock::now();
+    auto giveUp = next + WAKE_TIMEOUT;
+
+    while (sdl.getDisplayState() != DisplayState::BLANKED &&
+           Clock::now() < giveUp) {
+      if (Clock::now() >= next) {
+        writeLine(master, 0);
+        next += WAKE_LINE_PERIOD;
+      }
+      sdl.render(device.getReading(), "bench", "", trend);
+    }
+
+    auto loadedAt = Clock::now();
+    giveUp = loadedAt + WAKE_TIMEOUT;
+    next = loadedAt;
+    bool seen = false;
+
+    while (!seen && Clock::now() < giveUp) {
+      if (Clock::now() >= next) {
+        writeLine(master, value);
+        next += WAKE_LINE_PERIOD;
+      }
+      sdl.render(device.getReading(), "bench", "", trend);
+      auto frame = Clock::now();
+
+      if (!sdl.readPixels(area, pixels.data(), pitch))
+        break;
+
+      auto shownValue = shown.find(fingerprint(pixels));
+      if (shownValue != shown.end() && shownValue->second == value) {
+        wakes.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                            frame - loadedAt)
+                            .count());
+        seen = true;
+      }
+    }
+
+    if (!seen)
+      ++missed;
+  }
+  report("wake", wakes, missed);
+
+  // Tap on the weight: time to the frame that switched the view
+  sdl.setIdleTimeouts({}, {});
+  WeightReading fixed = pipeline.process(VALUES[0]);
+  std::vector<int64_t> taps;
+  missed = 0;
+
+  for (int run = 0; run < INPUT_RUNS; ++run) {
+    sdl.render(fixed, "bench", "", trend);
+    if (!sdl.readPixels(area, pixels.data(), pitch))
+      break;
+    bool weightShown = shown.count(fingerprint(pixels)) != 0;
+
+    SDL_Event tap{};
+    tap.type = SDL_FINGERDOWN;
+    tap.tfinger.timestamp = SDL_GetTicks();
+    tap.tfinger.x = 0.5f;
+    tap.tfinger.y = 0.5f;
+    auto tappedAt = Clock::now();
+    SDL_PushEvent(&tap);
+
+    auto giveUp = tappedAt + WAKE_TIMEOUT;
+    bool switched = false;
+    while (!switched && Clock::now() < giveUp) {
+      sdl.pollEvents();
+      sdl.render(fixed, "bench", "", trend);
+      auto frame = Clock::now();
+
+      if (!sdl.readPixels(area, pixels.data(), pitch))
+        break;
+      if ((shown.count(fingerprint(pixels)) != 0) != weightShown) {
+        taps.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                           frame - tappedAt)
+                           .count());
+        switched = true;
+      }
+    }
+
+    if (!switched)
+      ++missed;
+  }
+  report("input", taps, missed);
+
+  InputStats inputs = sdl.getInputStats();
+  std::cout << "[Latency] input events " << inputs.events << ", filtered "
+            << inputs.filtered << ", SDL timestamps max "
+            << inputs.maxLatencyMs << " ms\n";
+
+  device.stop();
+  close(slave);
+  close(master);
+  return 0;
+}
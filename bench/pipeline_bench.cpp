@@ -0,0 +1,121 @@
+// Parser, weight pipeline, trend, billing and payload formatting benchmarks.
+#include <benchmark/benchmark.h>
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include "Billing.hpp"
+#include "TrendBuffer.hpp"
+#include "WeightPipeline.hpp"
+
+namespace {
+
+// Noisy samples around 1.3 kg, the way the indicator sends them
+constexpr const char *LINES[] = {"1337", "1338", "1336", "1337",
+                                 "1339", "1337", "1335", "1337"};
+
+Tariff benchTariff() {
+  Tariff tariff;
+  tariff.pricePerKg = 9900;
+  tariff.brackets = {{500, 14900}, {2000, 12900}};
+  tariff.minimumCharge = 500;
+  tariff.rounding = 5;
+  tariff.division = 1;
+  return tariff;
+}
+
+} // namespace
+
+// One serial line: parse the digits and run the pipeline
+static void BM_ParseAndProcess(benchmark::State &state) {
+  WeightPipeline pipeline;
+  std::size_t i = 0;
+
+  for (auto _ : state) {
+    const char *line = LINES[i++ % std::size(LINES)];
+    int32_t raw = 0;
+    std::from_chars(line, line + std::strlen(line), raw);
+    benchmark::DoNotOptimize(pipeline.process(raw));
+  }
+}
+BENCHMARK(BM_ParseAndProcess);
+
+static void BM_FormatWeight(benchmark::State &state) {
+  WeightPipeline pipeline;
+  WeightReading reading = pipeline.process(1337);
+  char text[WEIGHT_TEXT_LENGTH];
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(formatWeight(reading, text, sizeof(text)));
+  }
+}
+BENCHMARK(BM_FormatWeight);
+
+static void BM_TrendPush(benchmark::State &state) {
+  TrendBuffer<TREND_COLUMNS> trend{TREND_WINDOW};
+  auto now = std::chrono::steady_clock::now();
+  int32_t value = 0;
+
+  for (auto _ : state) {
+    now += std::chrono::milliseconds(20);
+    trend.push(++value & 0xFFF, now);
+  }
+  benchmark::ClobberMemory();
+}
+BENCHMARK(BM_TrendPush);
+
+static void BM_TrendCopy(benchmark::State &state) {
+  TrendBuffer<TREND_COLUMNS> trend{TREND_WINDOW};
+  TrendSeries series{};
+  auto now = std::chrono::steady_clock::now();
+  for (int i = 0; i < 2000; ++i) {
+    now += std::chrono::milliseconds(20);
+    trend.push(i, now);
+  }
+
+  for (auto _ : state) {
+    trend.copy(series, now);
+    benchmark::DoNotOptimize(series.data());
+  }
+}
+BENCHMARK(BM_TrendCopy);
+
+// Table lookup per frame, see Billing::buildTable()
+static void BM_BillingQuote(benchmark::State &state) {
+  Billing billing(benchTariff());
+  WeightPipeline pipeline;
+  WeightReading reading{};
+  for (int i = 0; i < 16; ++i)
+    reading = pipeline.process(1337);
+  int32_t grams = 0;
+
+  for (auto _ : state) {
+    reading.net = 1 + (grams++ % (MAX_WEIGHT - 1));
+    benchmark::DoNotOptimize(billing.quote(reading));
+  }
+}
+BENCHMARK(BM_BillingQuote);
+
+static void BM_BillingBuildTable(benchmark::State &state) {
+  Billing billing;
+  Tariff tariff = benchTariff();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(billing.setTariff(tariff));
+  }
+}
+BENCHMARK(BM_BillingBuildTable);
+
+static void BM_FormatPriceAndPayload(benchmark::State &state) {
+  char price[PRICE_TEXT_LENGTH];
+  char payload[PAYLOAD_TEXT_LENGTH];
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(formatPrice(1725, "SEK", price, sizeof(price)));
+    benchmark::DoNotOptimize(
+        formatPayload(1725, "SEK", 1337, payload, sizeof(payload)));
+  }
+}
+BENCHMARK(BM_FormatPriceAndPayload);
@@ -0,0 +1,271 @@
+// Text layout, texture upload and compositor benchmarks.
+//
+// SDL runs on the offscreen video driver with the software renderer, so the
+// benchmarks need no display or GPU.
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "Assets.hpp"
+#include "Billing.hpp"
+#include "Compositor.hpp"
+#include "Config.hpp"
+#include "GlyphAtlas.hpp"
+#include "Graphics.hpp"
+#include "LabelCache.hpp"
+#include "TexturePool.hpp"
+#include "WeightPipeline.hpp"
+
+namespace {
+
+// Weight sized like on screen, the largest text that is drawn
+constexpr int MASK_WIDTH = 1200;
+constexpr int MASK_HEIGHT = 400;
+
+// Glyph run of the full-frame benchmarks, drawn centered like the weight
+constexpr const char *GLYPH_RUN = "13.37";
+
+/**
+ * @brief Headless SDL with a renderer and the configured font.
+ */
+struct Offscreen {
+  Offscreen() {
+    setenv("SDL_VIDEODRIVER", "offscreen", 0);
+    setenv("SDL_RENDER_DRIVER", "software", 0);
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0 || TTF_Init() < 0)
+      std::cerr << "SDL_Error occured: " << SDL_GetError() << "\n";
+
+    window.reset(SDL_CreateWindow("bench", 0, 0, 64, 64, SDL_WINDOW_HIDDEN));
+    renderer.reset(
+        SDL_CreateRenderer(window.get(), -1, SDL_RENDERER_SOFTWARE));
+
+    if (!decodeGlyphs(assetPath(AppConfig{}.font), assets))
+      std::cerr << "[Bench] Font missing, text benchmarks compose nothing\n";
+  }
+
+  ~Offscreen() {
+    assets = AssetSet{};
+    renderer.reset();
+    window.reset();
+    TTF_Quit();
+    SDL_Quit();
+  }
+
+  sdl_unique<SDL_Window> window;
+  sdl_unique<SDL_Renderer> renderer;
+  AssetSet assets;
+};
+
+Offscreen &offscreen() {
+  static Offscreen instance;
+  return instance;
+}
+
+} // namespace
+
+// Layout of the weight: measuring and composing the glyphs
+static void BM_AtlasCompose(benchmark::State &state) {
+  Offscreen &sdl = offscreen();
+  if (!sdl.assets.weightGlyphs) {
+    state.SkipWithError("no font");
+    return;
+  }
+  const GlyphAtlas &atlas = *sdl.assets.weightGlyphs;
+
+  sdl_unique<SDL_Surface> target(SDL_CreateRGBSurfaceWithFormat(
+      0, atlas.getMaxAdvance() * static_cast<int>(WEIGHT_TEXT_LENGTH - 1),
+      atlas.getHeight(), 32, SDL_PIXELFORMAT_ARGB8888));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(atlas.measure("1337"));
+    benchmark::DoNotOptimize(atlas.compose("1337", target.get()));
+  }
+}
+BENCHMARK(BM_AtlasCompose);
+
+// A weight change as render() does it: compose and upload
+static void BM_TexturePoolUpdate(benchmark::State &state) {
+  Offscreen &sdl = offscreen();
+  if (!sdl.assets.weightGlyphs) {
+    state.SkipWithError("no font");
+    return;
+  }
+  const GlyphAtlas &atlas = *sdl.assets.weightGlyphs;
+
+  TexturePool pool;
+  std::size_t slot = pool.reserve(
+      sdl.renderer.get(),
+      atlas.getMaxAdvance() * static_cast<int>(WEIGHT_TEXT_LENGTH - 1),
+      atlas.getHeight());
+
+  const char *values[] = {"1337", "1338"};
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pool.update(slot, atlas, values[i++ & 1]));
+  }
+  pool.clear();
+}
+BENCHMARK(BM_TexturePoolUpdate);
+
+// Repeated labels: a lookup, the texture is already uploaded
+static void BM_LabelCacheHit(benchmark::State &state) {
+  Offscreen &sdl = offscreen();
+  if (!sdl.assets.labelGlyphs) {
+    state.SkipWithError("no font");
+    return;
+  }
+  const GlyphAtlas &atlas = *sdl.assets.labelGlyphs;
+
+  LabelCache cache;
+  cache.reserve(sdl.renderer.get(),
+                atlas.getMaxAdvance() *
+                    static_cast<int>(LABEL_CACHE_TEXT_LENGTH),
+                atlas.getHeight());
+
+  const char *labels[] = {"Stable", "17.25 SEK", "Step on the scale"};
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache.get(atlas, labels[i++ % 3]));
+  }
+  state.counters["hit_ratio"] = static_cast<double>(cache.getStats().hits) /
+                                static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_LabelCacheHit);
+
+// Every label new: compose and upload into the oldest entry
+static void BM_LabelCacheMiss(benchmark::State &state) {
+  Offscreen &sdl = offscreen();
+  if (!sdl.assets.labelGlyphs) {
+    state.SkipWithError("no font");
+    return;
+  }
+  const GlyphAtlas &atlas = *sdl.assets.labelGlyphs;
+
+  LabelCache cache;
+  cache.reserve(sdl.renderer.get(),
+                atlas.getMaxAdvance() *
+                    static_cast<int>(LABEL_CACHE_TEXT_LENGTH),
+                atlas.getHeight());
+
+  char price[PRICE_TEXT_LENGTH];
+  int32_t amount = 0;
+  for (auto _ : state) {
+    formatPrice(++amount, "SEK", price, sizeof(price));
+    benchmark::DoNotOptimize(cache.get(atlas, price));
+  }
+}
+BENCHMARK(BM_LabelCacheMiss);
+
+// Software compositor, built-in kernel against the scalar reference
+static void blendBenchmark(benchmark::State &state, bool scalar) {
+  std::vector<uint32_t> pixels(MASK_WIDTH * MASK_HEIGHT, 0xFF202020u);
+  std::vector<uint8_t> mask(MASK_WIDTH * MASK_HEIGHT);
+  for (std::size_t i = 0; i < mask.size(); ++i)
+    mask[i] = static_cast<uint8_t>(i * 7);
+
+  int pitch = MASK_WIDTH * static_cast<int>(sizeof(uint32_t));
+  for (auto _ : state) {
+    if (scalar)
+      blendMaskScalar(pixels.data(), pitch, mask.data(), MASK_WIDTH,
+                      MASK_WIDTH, MASK_HEIGHT, 0xFFFFFFFFu);
+    else
+      blendMask(pixels.data(), pitch, mask.data(), MASK_WIDTH, MASK_WIDTH,
+                MASK_HEIGHT, 0xFFFFFFFFu);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * MASK_WIDTH * MASK_HEIGHT * 4);
+  state.SetLabel(scalar ? "scalar" : getCompositorName());
+}
+
+static void BM_BlendMask(benchmark::State &state) {
+  blendBenchmark(state, false);
+}
+BENCHMARK(BM_BlendMask);
+
+static void BM_BlendMaskScalar(benchmark::State &state) {
+  blendBenchmark(state, true);
+}
+BENCHMARK(BM_BlendMaskScalar);
+
+/**
+ * @brief A 1920x1080 frame and one glyph run, as a texture and as a mask.
+ */
+struct FullFrame {
+  explicit FullFrame(const GlyphAtlas &atlas)
+      : frame(SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT,
+                                             32, SDL_PIXELFORMAT_ARGB8888)),
+        width(atlas.measure(GLYPH_RUN)), height(atlas.getHeight()),
+        mask(static_cast<std::size_t>(width) * height) {
+    sdl_unique<SDL_Surface> glyphs(SDL_CreateRGBSurfaceWithFormat(
+        0, width, height, 32, SDL_PIXELFORMAT_ARGB8888));
+    SDL_FillRect(glyphs.get(), NULL, 0);
+    atlas.compose(GLYPH_RUN, glyphs.get());
+    atlas.composeMask(GLYPH_RUN, mask.data(), width, width, height);
+
+    renderer.reset(SDL_CreateSoftwareRenderer(frame.get()));
+    texture.reset(SDL_CreateTextureFromSurface(renderer.get(), glyphs.get()));
+    SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_BLEND);
+
+    rect = SDL_Rect{(WINDOW_WIDTH - width) / 2, (WINDOW_HEIGHT - height) / 2,
+                    width, height};
+  }
+
+  sdl_unique<SDL_Surface> frame;
+  int width;
+  int height;
+  std::vector<uint8_t> mask;
+  sdl_unique<SDL_Renderer> renderer;
+  sdl_unique<SDL_Texture> texture;
+  SDL_Rect rect{};
+};
+
+// The same glyph run at 1920x1080 through SDL's software renderer
+static void BM_FrameRenderCopy(benchmark::State &state) {
+  Offscreen &sdl = offscreen();
+  if (!sdl.assets.weightGlyphs) {
+    state.SkipWithError("no font");
+    return;
+  }
+  FullFrame full(*sdl.assets.weightGlyphs);
+  if (!full.texture) {
+    state.SkipWithError(SDL_GetError());
+    return;
+  }
+
+  for (auto _ : state) {
+    SDL_RenderCopy(full.renderer.get(), full.texture.get(), NULL, &full.rect);
+    SDL_RenderFlush(full.renderer.get());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * full.width * full.height);
+  state.SetLabel("SDL software");
+}
+BENCHMARK(BM_FrameRenderCopy);
+
+// ... and through the compositor, as compositeWeight() does
+static void BM_FrameCompositor(benchmark::State &state) {
+  Offscreen &sdl = offscreen();
+  if (!sdl.assets.weightGlyphs) {
+    state.SkipWithError("no font");
+    return;
+  }
+  FullFrame full(*sdl.assets.weightGlyphs);
+  SDL_Surface *frame = full.frame.get();
+
+  auto *pixels = static_cast<uint8_t *>(frame->pixels) +
+                 full.rect.y * frame->pitch + full.rect.x * 4;
+  uint32_t color = SDL_MapRGBA(frame->format, TEXT_COLOR.r, TEXT_COLOR.g,
+                               TEXT_COLOR.b, TEXT_COLOR.a);
+
+  for (auto _ : state) {
+    blendMask(reinterpret_cast<uint32_t *>(pixels), frame->pitch,
+              full.mask.data(), full.width, full.width, full.height, color);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * full.width * full.height);
+  state.SetLabel(getCompositorName());
+}
+BENCHMARK(BM_FrameCompositor);
@@ -0,0 +1,128 @@
+// Vibration analysis and notch filtering at indicator rates of 100 Hz to
+// 2 kHz. Rate benchmarks process one second of input per iteration.
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Spectrum.hpp"
+#include "VibrationFilter.hpp"
+
+namespace {
+
+// A conveyor at 7 Hz and its third harmonic on top of 1.3 kg
+constexpr double BASE_GRAMS = 1337.0;
+constexpr double DISTURBANCE_HZ = 7.0;
+constexpr double HARMONIC_HZ = 21.0;
+
+std::vector<float> disturbed(int rate, std::size_t count) {
+  std::vector<float> samples(count);
+  for (std::size_t n = 0; n < count; ++n) {
+    double t = static_cast<double>(n) / rate;
+    samples[n] = static_cast<float>(
+        BASE_GRAMS + 4.0 * std::sin(2.0 * M_PI * DISTURBANCE_HZ * t) +
+        1.5 * std::sin(2.0 * M_PI * HARMONIC_HZ * t));
+  }
+  return samples;
+}
+
+void rates(benchmark::internal::Benchmark *bench) {
+  for (int rate : {100, 250, 500, 1000, 2000})
+    bench->Arg(rate);
+}
+
+} // namespace
+
+// One window through every bin, built-in kernel against the scalar reference
+static void goertzelBenchmark(benchmark::State &state, bool scalar) {
+  std::vector<float> samples = disturbed(1000, VIBRATION_WINDOW);
+  std::array<float, VIBRATION_BINS> coefficients{};
+  std::array<float, VIBRATION_BINS> power{};
+  for (std::size_t k = 0; k < VIBRATION_BINS; ++k)
+    coefficients[k] =
+        goertzelCoefficient(static_cast<double>(k) / VIBRATION_WINDOW);
+
+  for (auto _ : state) {
+    if (scalar)
+      goertzelBankScalar(samples.data(), samples.size(), coefficients.data(),
+                         coefficients.size(), power.data());
+    else
+      goertzelBank(samples.data(), samples.size(), coefficients.data(),
+                   coefficients.size(), power.data());
+    benchmark::DoNotOptimize(power.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VIBRATION_WINDOW *
+                          VIBRATION_BINS);
+  state.SetLabel(scalar ? "scalar" : getSpectrumName());
+}
+
+static void BM_GoertzelBank(benchmark::State &state) {
+  goertzelBenchmark(state, false);
+}
+BENCHMARK(BM_GoertzelBank);
+
+static void BM_GoertzelBankScalar(benchmark::State &state) {
+  goertzelBenchmark(state, true);
+}
+BENCHMARK(BM_GoertzelBankScalar);
+
+// Worker cost per second of input, one analysis every VIBRATION_HOP samples
+static void BM_VibrationAnalysis(benchmark::State &state) {
+  int rate = static_cast<int>(state.range(0));
+  std::size_t analyses = static_cast<std::size_t>(rate) / VIBRATION_HOP;
+  std::vector<float> samples =
+      disturbed(rate, VIBRATION_WINDOW + analyses * VIBRATION_HOP);
+  VibrationAnalyzer analyzer;
+  std::array<VibrationPeak, VIBRATION_NOTCHES> peaks{};
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < analyses; ++i)
+      benchmark::DoNotOptimize(
+          analyzer.analyze(samples.data() + i * VIBRATION_HOP, peaks));
+  }
+  state.SetItemsProcessed(state.iterations() * rate);
+}
+BENCHMARK(BM_VibrationAnalysis)->Apply(rates);
+
+// Reader cost per second of input with both notches switched in
+static void BM_NotchCascade(benchmark::State &state) {
+  int rate = static_cast<int>(state.range(0));
+  std::vector<float> samples = disturbed(rate, static_cast<std::size_t>(rate));
+
+  NotchSet set;
+  set.count = 2;
+  set.notches[0] = NotchCoefficients::at(DISTURBANCE_HZ / rate);
+  set.notches[1] = NotchCoefficients::at(HARMONIC_HZ / rate);
+  set.ids = {1, 2};
+  NotchCascade cascade;
+  cascade.set(set);
+
+  for (auto _ : state) {
+    for (float sample : samples)
+      benchmark::DoNotOptimize(cascade.process(sample));
+  }
+  state.SetItemsProcessed(state.iterations() * rate);
+}
+BENCHMARK(BM_NotchCascade)->Apply(rates);
+
+// Whole reader path, analysis handed to the worker as in Device
+static void BM_VibrationFilter(benchmark::State &state) {
+  int rate = static_cast<int>(state.range(0));
+  std::vector<float> samples = disturbed(rate, static_cast<std::size_t>(rate));
+  auto period = std::chrono::nanoseconds(1000000000 / rate);
+  auto now = std::chrono::steady_clock::now();
+  VibrationFilter filter;
+
+  for (auto _ : state) {
+    for (float sample : samples) {
+      now += period;
+      benchmark::DoNotOptimize(
+          filter.filter(static_cast<int32_t>(std::lround(sample)), now));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * rate);
+}
+BENCHMARK(BM_VibrationFilter)->Apply(rates);
@@ -0,0 +1,75 @@
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+#include <cstdint>
+
+/**
+ * @brief Route SDL's allocator through the allocation counter.
+ *
+ * Must be called before SDL_Init() so every SDL, SDL_image and SDL_ttf
+ * allocation is counted. Does nothing unless built with
+ * PPW_COUNT_ALLOCATIONS.
+ */
+void installAllocationHooks();
+
+/**
+ * @brief Heap allocations made so far by operator new and SDL_malloc.
+ *
+ * @return running total, always 0 unless built with PPW_COUNT_ALLOCATIONS.
+ */
+uint64_t getAllocationCount();
+
+/**
+ * @brief Resident set size of the process, read from /proc/self/statm.
+ *
+ * Does not allocate, safe to call from the render loop.
+ *
+ * @return bytes, 0 if unavailable.
+ */
+uint64_t getResidentBytes();
+
+/**
+ * @class AllocationGuard
+ *
+ * @brief Marks a steady state section of the calling thread.
+ *
+ * @details
+ * Built with PPW_ALLOCATION_GUARD, a heap allocation on the thread while an
+ * enabled guard is alive aborts the process with a message. Otherwise the
+ * guard does nothing. Guards nest, the outer state is restored.
+ */
+class AllocationGuard {
+public:
+  explicit AllocationGuard(bool enabled = true);
+  ~AllocationGuard();
+
+  AllocationGuard(const AllocationGuard &) = delete;
+  AllocationGuard &operator=(const AllocationGuard &) = delete;
+
+private:
+  bool previous = false; // State of the enclosing guard.
+};
+
+/**
+ * @class AllocationExemption
+ *
+ * @brief Lifts the guard of the calling thread for one call.
+ *
+ * @details
+ * For calls that may allocate inside a steady state section by design, such
+ * as a read back that the driver stages on the heap. Allocations are still
+ * counted; the enclosing guard is restored on destruction.
+ */
+class AllocationExemption {
+public:
+  AllocationExemption();
+  ~AllocationExemption();
+
+  AllocationExemption(const AllocationExemption &) = delete;
+  AllocationExemption &operator=(const AllocationExemption &) = delete;
+
+private:
+  bool previous = false; // State of the enclosing guard.
+};
+
+#endif
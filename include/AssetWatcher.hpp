@@ -0,0 +1,132 @@
+#ifndef ASSETWATCHER_HPP
+#define ASSETWATCHER_HPP
+
+// File change notification
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// C++ Standard
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Assets.hpp"
+#include "Billing.hpp"
+#include "Config.hpp"
+
+// Quiet time after the last change before reloading (editors write twice)
+constexpr int RELOAD_SETTLE_MS = 150;
+
+// Room for a batch of inotify events
+constexpr std::size_t INOTIFY_BUFFER_LENGTH = 4096;
+
+/**
+ * @brief Everything that changed since the last frame boundary.
+ *
+ * Empty members mean "unchanged".
+ */
+struct AssetUpdate {
+  std::optional<AppConfig> config; // New configuration (port settings).
+  std::optional<Tariff> tariff;    // New tariff, already validated.
+  AssetSet assets;                 // Newly decoded images and glyphs.
+
+  /**
+   * @brief True if nothing changed.
+   */
+  bool empty() const { return !config && !tariff && assets.empty(); }
+
+  /**
+   * @brief Take every change of a newer update.
+   */
+  void merge(AssetUpdate &&newer);
+};
+
+/**
+ * @class AssetWatcher
+ *
+ * @brief Reloads configuration and assets when their files change.
+ *
+ * @details
+ * A background thread watches the asset directories with inotify. Once
+ * writes have settled it parses the configuration and tariff and decodes
+ * the changed images and font into CPU side surfaces, all off the render
+ * thread. The result is picked up by main with take() between two frames,
+ * so textures are swapped at a frame boundary and an ongoing weighing is not
+ * touched.
+ */
+class AssetWatcher {
+public:
+  /**
+   * @brief Start watching.
+   *
+   * @param config configuration currently in use.
+   */
+  explicit AssetWatcher(const AppConfig &config);
+
+  /**
+   * @brief Stop the thread and close the descriptors.
+   */
+  ~AssetWatcher();
+
+  /**
+   * @brief Take the pending update, never blocks.
+   *
+   * @param out receives the update if there is one.
+   *
+   * @return true if out holds an update.
+   */
+  bool take(AssetUpdate &out);
+
+private:
+  /**
+   * @brief Watch loop, runs until stop is signaled.
+   */
+  void run();
+
+  /**
+   * @brief Watch the directories holding the configured files.
+   */
+  void watchDirectories();
+
+  /**
+   * @brief Read every queued event and remember changed files.
+   */
+  void readEvents(std::vector<std::string> &changed);
+
+  /**
+   * @brief Reload what changed and publish it.
+   *
+   * @param changed full paths of the written files.
+   */
+  void reload(const std::vector<std::string> &changed);
+
+  /**
+   * @brief Hand an update over to take().
+   */
+  void publish(AssetUpdate &&update);
+
+  AppConfig config; // Configuration as seen by the watcher thread.
+
+  int inotifyFd = -1;
+  int wakeFd = -1;
+  std::unordered_map<int, std::string> directories; // Watch -> directory.
+
+  std::mutex mutex{};
+  AssetUpdate pending{};          // Guarded by mutex.
+  std::atomic<bool> ready{false}; // pending holds an update.
+
+  std::thread worker;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef ASSETS_HPP
+#define ASSETS_HPP
+
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "GlyphAtlas.hpp"
+#include "GraphicSdlDefines.hpp"
+
+// Font sizes in points
+constexpr int WEIGHT_FONT_SIZE = 400;
+constexpr int LABEL_FONT_SIZE = 48;
+// Color of all text
+constexpr SDL_Color TEXT_COLOR{255, 255, 255, 255};
+
+/**
+ * @brief Decoded assets, ready to be turned into textures.
+ *
+ * Only CPU side data, so it can be decoded on any thread and handed to the
+ * render thread. Empty members mean "keep the current one".
+ */
+struct AssetSet {
+  sdl_unique<SDL_Surface> logo;           // Logo (bottom right).
+  sdl_unique<SDL_Surface> image;          // QR template.
+  std::optional<GlyphAtlas> weightGlyphs; // Glyphs of the weight font.
+  std::optional<GlyphAtlas> labelGlyphs;  // Glyphs of the label font.
+
+  /**
+   * @brief True if nothing was decoded.
+   */
+  bool empty() const {
+    return !logo && !image && !weightGlyphs && !labelGlyphs;
+  }
+
+  /**
+   * @brief Take every decoded member of a newer set.
+   */
+  void merge(AssetSet &&newer);
+};
+
+/**
+ * @brief Decode an image (.png) into a surface.
+ *
+ * @param filepath path to the image.
+ *
+ * @return the surface, empty on failure.
+ */
+sdl_unique<SDL_Surface> decodeImage(const std::string &filepath);
+
+/**
+ * @brief Rasterize the weight and label atlases of a font (.ttf).
+ *
+ * The font is only open while the glyphs are rendered, the atlases keep
+ * plain surfaces. Calls from several threads are serialized.
+ *
+ * @param filepath path to the font.
+ * @param out receives both atlases.
+ *
+ * @return false if the font could not be opened, out is left untouched.
+ */
+bool decodeGlyphs(const std::string &filepath, AssetSet &out);
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef BILLING_HPP
+#define BILLING_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Config.hpp"
+#include "WeightPipeline.hpp"
+
+// Returned by Billing::quote() when the reading can not be billed
+constexpr int32_t NO_PRICE = -1;
+
+// Amounts are kept in minor units (cents), 2 decimals
+constexpr int PRICE_DECIMALS = 2;
+
+// Longest text produced by formatPrice() including the terminator
+constexpr std::size_t PRICE_TEXT_LENGTH = 24;
+
+// Longest payload produced by formatPayload() including the terminator
+constexpr std::size_t PAYLOAD_TEXT_LENGTH = 64;
+
+// Most brackets accepted in a tariff
+constexpr std::size_t MAX_TARIFF_BRACKETS = 8;
+
+/**
+ * @brief A tier of the tariff.
+ *
+ * The part of the weight between the previous bracket and upTo is charged at
+ * pricePerKg.
+ */
+struct TariffBracket {
+  int32_t upTo = 0;       // Upper bound in grams.
+  int32_t pricePerKg = 0; // Minor units per kilogram.
+};
+
+/**
+ * @brief Prices of the scale.
+ *
+ * Without brackets the whole weight is charged at pricePerKg, with brackets
+ * pricePerKg is the rate above the last one.
+ */
+struct Tariff {
+  std::string currency = "SEK";
+  int32_t pricePerKg = 0;                // Minor units per kilogram.
+  std::vector<TariffBracket> brackets{}; // Ascending by upTo.
+  int32_t minimumCharge = 0;             // Least amount of a sale.
+  int32_t rounding = 1;                  // Amount step in minor units.
+  int32_t division = 1;                  // Billed weight step in grams.
+};
+
+/**
+ * @class Billing
+ *
+ * @brief Turns net weights into prices.
+ *
+ * @details
+ * The tariff is evaluated once for every weight division up to MAX_WEIGHT
+ * into a flat table, so pricing a reading is a bounds check and a lookup.
+ * Quoting never allocates; only loading a tariff does.
+ */
+class Billing {
+public:
+  /**
+   * @brief Start without a tariff, every quote is NO_PRICE.
+   */
+  Billing() = default;
+
+  /**
+   * @brief Start with a tariff.
+   */
+  explicit Billing(const Tariff &tariff);
+
+  /**
+   * @brief Load a tariff file and rebuild the table.
+   *
+   * The current tariff is kept if the file is missing or invalid.
+   *
+   * @param filepath path to the tariff file.
+   *
+   * @return false if the file could not be used.
+   */
+  bool load(const char *filepath);
+
+  /**
+   * @brief Replace the tariff and rebuild the table.
+   *
+   * @return false if the tariff is invalid, the current one is kept.
+   */
+  bool setTariff(const Tariff &newTariff);
+
+  /**
+   * @brief Price of a reading.
+   *
+   * @param reading processed reading.
+   *
+   * @return amount in minor units, or NO_PRICE if the reading is unstable,
+   * out of range or below one division.
+   */
+  int32_t quote(const WeightReading &reading) const;
+
+  /**
+   * @brief Price of a net weight, ignoring stability.
+   *
+   * @param grams net weight in grams.
+   *
+   * @return amount in minor units, or NO_PRICE outside the table.
+   */
+  int32_t priceOf(int32_t grams) const;
+
+  /**
+   * @brief Current tariff.
+   */
+  const Tariff &getTariff() const;
+
+private:
+  /**
+   * @brief Evaluate the tariff for every division.
+   */
+  void buildTable();
+
+  /**
+   * @brief Evaluate the tariff for one weight, used to build the table.
+   */
+  int32_t evaluate(int32_t grams) const;
+
+  Tariff tariff{};
+  std::vector<int32_t> table{}; // Price per division, empty without tariff.
+};
+
+/**
+ * @brief Parse a tariff file.
+ *
+ * Read with readSettings(). Keys are currency,
+ * per_kg, bracket (grams and per_kg), minimum, rounding and division.
+ * Prices are in minor units.
+ *
+ * @param filepath path to the tariff file.
+ * @param out parsed tariff.
+ *
+ * @return false if the file could not be read or has errors.
+ */
+bool loadTariff(const char *filepath, Tariff &out);
+
+/**
+ * @brief Check a tariff before it is used.
+ */
+bool validTariff(const Tariff &tariff);
+
+/**
+ * @brief Format an amount as displayed text, e.g. "12.50 SEK".
+ *
+ * Never allocates.
+ *
+ * @return the amount of characters written (without terminator).
+ */
+std::size_t formatPrice(int32_t amount, std::string_view currency,
+                        char *buffer, std::size_t length);
+
+/**
+ * @brief Format the QR payload of a sale.
+ *
+ * "PPW;amount=12.50;currency=SEK;net=1337", never allocates. The payload
+ * is empty for NO_PRICE and when it does not fit the buffer.
+ *
+ * @return the amount of characters written (without terminator).
+ */
+std::size_t formatPayload(int32_t amount, std::string_view currency,
+                          int32_t net, char *buffer, std::size_t length);
+
+#endif
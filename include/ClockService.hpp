@@ -0,0 +1,121 @@
+#ifndef CLOCKSERVICE_HPP
+#define CLOCKSERVICE_HPP
+
+// Wall clock timer
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// C++ Standard
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <string_view>
+
+#include "IoLoop.hpp"
+
+// Layout of the clock label
+constexpr const char *TIME_FORMAT = "%d/%m-%y %H:%M";
+
+// Room for a label, "dd/mm-yy hh:mm" and the terminator
+constexpr std::size_t TIME_LABEL_LENGTH = std::size("dd/mm-yy hh:mm");
+
+// Label slots: published, previous (may still be read) and next
+constexpr std::size_t TIME_LABEL_SLOTS = 3;
+
+/**
+ * @class ClockService
+ *
+ * @brief Minute aligned wall clock label.
+ *
+ * @details
+ * A coroutine on the IoLoop sleeps on a CLOCK_REALTIME timerfd armed with
+ * TFD_TIMER_ABSTIME for the next minute boundary, so it wakes once per
+ * minute and exactly on it. The label for that minute is formatted ahead of
+ * time and published with a single atomic store when the timer fires.
+ *
+ * TFD_TIMER_CANCEL_ON_SET wakes the coroutine early when the wall clock is
+ * set (NTP step, manual date change), the label is then formatted for the
+ * new time and the timer armed again.
+ *
+ * Readers never lock: a published slot is not written again until two more
+ * labels have been published.
+ */
+class ClockService {
+public:
+  /**
+   * @brief Publish the current time and spawn the timer coroutine.
+   *
+   * Call before IoLoop::start().
+   *
+   * @param io loop the coroutine runs on.
+   */
+  explicit ClockService(IoLoop &io);
+
+  /**
+   * @brief Shut the loop down and close the timer.
+   */
+  ~ClockService();
+
+  /**
+   * @brief Current label, safe from any thread.
+   *
+   * The view stays valid until two more labels are published, normally two
+   * minutes.
+   */
+  std::string_view label() const;
+
+private:
+  /**
+   * @brief Coroutine that publishes a label on every minute boundary.
+   */
+  Task run();
+
+  /**
+   * @brief Arm the timer for an absolute wall clock time.
+   *
+   * @return false if the timer could not be armed.
+   */
+  bool arm(std::chrono::system_clock::time_point at);
+
+  /**
+   * @brief Format the label of a point in time into a slot.
+   */
+  void format(std::size_t slot, std::chrono::system_clock::time_point at);
+
+  /**
+   * @brief Make a formatted slot the current label.
+   */
+  void publish(std::size_t slot);
+
+  IoLoop &io;
+  int timerFd = -1;
+
+  std::array<std::array<char, TIME_LABEL_LENGTH>, TIME_LABEL_SLOTS> labels{};
+  std::atomic<std::size_t> current{0}; // Published slot.
+};
+
+/**
+ * @brief Start of the minute after a point in time.
+ */
+std::chrono::system_clock::time_point
+nextMinute(std::chrono::system_clock::time_point at);
+
+/**
+ * @brief Format the clock label of a point in time (local time).
+ *
+ * Never allocates.
+ *
+ * @param at point in time to format.
+ * @param buffer output, at least TIME_LABEL_LENGTH bytes.
+ * @param length size of buffer.
+ *
+ * @return the amount of characters written (without terminator).
+ */
+std::size_t formatClock(std::chrono::system_clock::time_point at,
+                        char *buffer, std::size_t length);
+
+#endif
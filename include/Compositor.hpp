@@ -0,0 +1,41 @@
+#ifndef COMPOSITOR_HPP
+#define COMPOSITOR_HPP
+
+#include <cstdint>
+
+// Top byte of a 32-bit pixel, alpha or padding
+constexpr uint32_t OPAQUE = 0xFF000000u;
+
+/**
+ * @brief Blend a coverage mask in a solid color over 32-bit pixels.
+ *
+ * Every channel becomes (color * a + dst * (255 - a)) / 255, rounded, where
+ * a is the mask value and the color is taken as opaque. Works for any 32-bit
+ * layout as long as color is mapped to the same layout.
+ *
+ * The kernel is chosen at build time: NEON on aarch64, AVX2 or SSE2 on x86
+ * and a scalar loop everywhere else.
+ *
+ * @param dst top left pixel to blend into.
+ * @param dstPitch bytes between two rows of dst.
+ * @param mask top left coverage value.
+ * @param maskPitch bytes between two rows of mask.
+ * @param width pixels per row.
+ * @param height rows.
+ * @param color pixel value of the text color.
+ */
+void blendMask(uint32_t *dst, int dstPitch, const uint8_t *mask,
+               int maskPitch, int width, int height, uint32_t color);
+
+/**
+ * @brief Scalar reference of blendMask(), always available.
+ */
+void blendMaskScalar(uint32_t *dst, int dstPitch, const uint8_t *mask,
+                     int maskPitch, int width, int height, uint32_t color);
+
+/**
+ * @brief Name of the kernel blendMask() was built with.
+ */
+const char *getCompositorName();
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef CONFIG_HPP
+#define CONFIG_HPP
+
+#include <SDL2/SDL.h>
+#include <arpa/inet.h>
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "WeightPipeline.hpp"
+
+// Root of the runtime assets (images, fonts and configuration)
+#ifdef RPI
+constexpr const char *ASSET_ROOT = "assets";
+#else
+constexpr const char *ASSET_ROOT = ASSET_DIR;
+#endif
+
+// Runtime configuration, relative to ASSET_ROOT
+constexpr const char *CONFIG_FILE = "ppw.conf";
+
+// Default serial port of the indicator
+constexpr const char *PORT_A = "/dev/ttyACM0";
+
+// Default baud rate of the indicator
+constexpr int32_t DEFAULT_BAUD = 9600;
+
+// Minutes of an empty scale before the screen is dimmed, then blanked
+constexpr int32_t DEFAULT_DIM_AFTER = 10;
+constexpr int32_t DEFAULT_BLANK_AFTER = 30;
+
+// Longest gap between two frames and two serial reader wakeups before the
+// watchdog records an incident
+constexpr std::chrono::milliseconds DEFAULT_FRAME_DEADLINE{1000};
+constexpr std::chrono::milliseconds DEFAULT_SERIAL_DEADLINE{10000};
+
+// Budget from the shutdown request (GPIO edge or window close) to the end of
+// the teardown
+constexpr std::chrono::milliseconds SHUTDOWN_BUDGET{50};
+
+// Keys and their actions, see InputManager::setKeymap()
+constexpr const char *DEFAULT_KEYMAP =
+    "Space:toggle, Return:toggle, T:tare, Escape:quit";
+
+// Bindings a keymap holds at most
+constexpr std::size_t MAX_KEY_BINDINGS = 16;
+
+// Idle-screen playlist: seconds of an empty scale before it starts, seconds
+// an image is shown and frames per second of animations
+constexpr int32_t DEFAULT_PLAYLIST_AFTER = 20;
+constexpr int32_t DEFAULT_PLAYLIST_SECONDS = 8;
+constexpr int32_t DEFAULT_PLAYLIST_FPS = 25;
+constexpr int32_t MAX_PLAYLIST_FPS = 60;
+
+// Root of sysfs, a copy of the files below it stands in for tests
+constexpr const char *SYSFS_ROOT = "/sys";
+
+// Operator screen: display index meaning none, frames per second at most
+constexpr int32_t OPERATOR_OFF = -1;
+constexpr int32_t DEFAULT_OPERATOR_FPS = 10;
+constexpr int32_t MAX_OPERATOR_FPS = 30;
+
+// Highest rate of frames published to the shared-memory mirror
+constexpr int32_t MAX_MIRROR_FPS = 60;
+
+// Local API over TCP: port (0 off) and the IPv4 address it is bound to,
+// loopback keeps set_qr away from the shop network
+constexpr int32_t DEFAULT_API_PORT = 0;
+constexpr const char *DEFAULT_API_ADDRESS = "127.0.0.1";
+
+/**
+ * @brief Settings that can change without a rebuild.
+ *
+ * Asset paths are relative to ASSET_ROOT unless they start with '/'.
+ */
+struct AppConfig {
+  std::string port = PORT_A;
+  int32_t baud = DEFAULT_BAUD;
+  std::string logo = "img/pandema.png";
+  std::string image = "img/qr.png";
+  std::string font = "fonts/Lato-Light.ttf";
+  std::string tariff = "tariff.conf";
+  int32_t dimAfter = DEFAULT_DIM_AFTER;     // Minutes, 0 never dims.
+  int32_t blankAfter = DEFAULT_BLANK_AFTER; // Minutes, 0 never blanks.
+  std::chrono::milliseconds frameDeadline = DEFAULT_FRAME_DEADLINE;
+  std::chrono::milliseconds serialDeadline = DEFAULT_SERIAL_DEADLINE;
+  bool watchdogRestart = false; // Rebuild the renderer on a frame miss.
+  int32_t mirrorFps = 0;        // Frames mirrored per second, 0 off.
+  bool vibrationFilter = true;  // Notch periodic platform vibration.
+  WeightUnit unit = WeightUnit::GRAM;
+  int32_t division = 1; // Display step in displayed digits.
+  WeightRounding rounding = WeightRounding::NEAREST;
+  std::string keymap = DEFAULT_KEYMAP;
+  std::string playlist; // Idle-screen images and directories, empty off.
+  int32_t playlistAfter = DEFAULT_PLAYLIST_AFTER;     // Seconds.
+  int32_t playlistSeconds = DEFAULT_PLAYLIST_SECONDS; // Seconds per image.
+  int32_t playlistFps = DEFAULT_PLAYLIST_FPS;
+  bool adaptiveQuality = true;            // Less non-essential work when hot.
+  std::string sysfsRoot = SYSFS_ROOT;     // Thermal zone and CPU frequency.
+  int32_t operatorDisplay = OPERATOR_OFF; // SDL display of the operator.
+  int32_t operatorFps = DEFAULT_OPERATOR_FPS;
+  int32_t apiPort = DEFAULT_API_PORT; // Read at start.
+  std::string apiAddress = DEFAULT_API_ADDRESS;
+
+  bool operator==(const AppConfig &other) const {
+    return port == other.port && baud == other.baud && logo == other.logo &&
+           image == other.image && font == other.font &&
+           tariff == other.tariff && dimAfter == other.dimAfter &&
+           blankAfter == other.blankAfter &&
+           frameDeadline == other.frameDeadline &&
+           serialDeadline == other.serialDeadline &&
+           watchdogRestart == other.watchdogRestart &&
+           mirrorFps == other.mirrorFps &&
+           vibrationFilter == other.vibrationFilter &&
+           unit == other.unit && division == other.division &&
+           rounding == other.rounding &&
+           keymap == other.keymap && playlist == other.playlist &&
+           playlistAfter == other.playlistAfter &&
+           playlistSeconds == other.playlistSeconds &&
+           playlistFps == other.playlistFps &&
+           adaptiveQuality == other.adaptiveQuality &&
+           sysfsRoot == other.sysfsRoot &&
+           operatorDisplay == other.operatorDisplay &&
+           operatorFps == other.operatorFps && apiPort == other.apiPort &&
+           apiAddress == other.apiAddress;
+  }
+  bool operator!=(const AppConfig &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Callback for one setting, returns false if the value is invalid.
+ */
+using SettingHandler =
+    std::function<bool(std::string_view key, std::string_view value)>;
+
+/**
+ * @brief Read a settings file line by line.
+ *
+ * Lines are "key = value", '#' starts a comment and blank lines are skipped.
+ * Errors are reported with file and line.
+ *
+ * @param filepath file to read.
+ * @param handler called for every setting.
+ *
+ * @return false if the file could not be read or a setting was rejected.
+ */
+bool readSettings(const char *filepath, const SettingHandler &handler);
+
+/**
+ * @brief Parse the runtime configuration.
+ *
+ * Keys are port, baud, logo, image, font, tariff, dim_after, blank_after,
+ * frame_deadline, serial_deadline (ms, 0 unwatched), watchdog_restart
+ * (0 or 1), mirror_fps (0 off), vibration_filter (0 or 1), unit (g, kg or
+ * lb), division, rounding (nearest or down), keymap, playlist,
+ * playlist_after, playlist_seconds, playlist_fps, adaptive_quality (0 or 1),
+ * sysfs_root, operator_display (-1 off), operator_fps, api_port (0 off) and
+ * api_address (IPv4). Missing keys keep their defaults.
+ *
+ * @param filepath path to the configuration.
+ * @param out parsed configuration.
+ *
+ * @return false if the file could not be read or has errors.
+ */
+bool loadConfig(const char *filepath, AppConfig &out);
+
+/**
+ * @brief Callback for one key binding, returns false if it is invalid.
+ */
+using KeyBindingHandler =
+    std::function<bool(std::string_view key, std::string_view action)>;
+
+/**
+ * @brief Split a keymap into its bindings.
+ *
+ * Entries are "key:action" separated by commas; the last colon splits an
+ * entry, so ':' itself is a key name. Empty entries are skipped.
+ *
+ * @param keymap entries of the keymap setting.
+ * @param handler called for every binding, trimmed.
+ *
+ * @return false if an entry has no colon or a binding was rejected.
+ */
+bool readKeymap(std::string_view keymap, const KeyBindingHandler &handler);
+
+/**
+ * @brief True if a keymap only binds SDL key names to toggle, tare or quit.
+ *
+ * Checked against SDL's scancode names and single characters, which needs
+ * no SDL_Init(). At most MAX_KEY_BINDINGS.
+ */
+bool validKeymap(std::string_view keymap);
+
+/**
+ * @brief Weight pipeline settings of a configuration.
+ *
+ * Unit, division and rounding come from the configuration, the motion and
+ * zero tracking tunables keep their defaults.
+ */
+WeightConfig toWeightConfig(const AppConfig &config);
+
+/**
+ * @brief Full path of an asset.
+ *
+ * @param relative path below ASSET_ROOT, or an absolute path.
+ */
+std::string assetPath(std::string_view relative);
+
+/**
+ * @brief Remove spaces, tabs and carriage returns around text.
+ */
+std::string_view trimSetting(std::string_view text);
+
+/**
+ * @brief Parse the next integer of a setting and advance past it.
+ *
+ * @return false if text does not start with an integer.
+ */
+bool parseSetting(std::string_view &text, int32_t &out);
+
+#endif
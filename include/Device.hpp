@@ -3,128 +3,276 @@
 
 // Serial/terminal communication
 #include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
 #include <termios.h>
 #include <unistd.h>
 
 // C++ Standard
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
 #include <cstdint>
 #include <iostream>
 #include <string>
 #include <string_view>
 #include <vector>
 
-// Timestamp
-#include <ctime>
-
 // Thread safe specifics
 #include <atomic>
 #include <chrono>
 #include <mutex>
-#include <thread>
+
+#include "AllocationCounter.hpp"
+#include "Config.hpp"
+#include "FixedText.hpp"
+#include "Heartbeat.hpp"
+#include "IoLoop.hpp"
+#include "TrendBuffer.hpp"
+#include "VibrationFilter.hpp"
+#include "WeightPipeline.hpp"
 
 constexpr uint8_t DELAY = 16;
 constexpr uint8_t BUFFER_LENGTH = 32;
 
-// Test port
-constexpr const char *PORT_A = "/dev/ttyACM0";
+// Longest line accepted from the indicator, longer lines are byte errors
+constexpr std::size_t MAX_LINE_LENGTH = 16;
+
+// A reading older than this is stale (the indicator sends every DELAY ms)
+constexpr std::chrono::milliseconds LINK_STALE_AFTER{250};
+
+// Silence after which the port is reopened
+constexpr std::chrono::milliseconds LINK_REOPEN_AFTER{3000};
+
+// Reconnect backoff, doubled after every failed attempt
+constexpr std::chrono::milliseconds RECONNECT_MIN_DELAY{100};
+constexpr std::chrono::milliseconds RECONNECT_MAX_DELAY{5000};
+
+/**
+ * @brief State of the serial link to the indicator.
+ */
+enum class LinkState : uint8_t {
+  DISCONNECTED, // Port is not open.
+  SILENT,       // Port is open but no weight for LINK_STALE_AFTER.
+  ONLINE,       // Weights are arriving.
+};
+
+/**
+ * @brief Health of the serial link.
+ */
+struct LinkStatus {
+  LinkState state = LinkState::DISCONNECTED;
+  uint32_t frameRate = 0;  // Weights per second over the last second.
+  uint64_t frames = 0;     // Weights received since start.
+  uint64_t errors = 0;     // Lines that were not a weight.
+  uint32_t reconnects = 0; // Times the port was opened again.
+};
 
 /**
  * @class Device
  * @brief Class for handling the Raspberry Pi serial port reading.
  * @details Poll a serial port for incoming weight and present the result to
- * SDL Window.
+ * SDL Window. The serial reader is a coroutine on a shared IoLoop thread.
  */
 class Device {
 public:
   /**
    * @brief Constructor that initiates state variable and connects to port
+   *
+   * Spawns the reader coroutine on the loop, call before
+   * IoLoop::start().
+   *
+   * @param io loop the reader runs on.
+   * @param config serial port and baud rate of the indicator.
    */
-  Device();
+  explicit Device(IoLoop &io, const AppConfig &config = AppConfig{});
 
   /**
-   * @brief Destructor that sets the state and joins threads.
+   * @brief Destructor that shuts the loop down and closes the port.
+   *
+   * The reader refers to this object, so the loop is shut down first.
    */
   ~Device();
 
   /**
-   * @brief Thread function that runs readFromSerial().
+   * @brief Request the loop running the reader to stop.
+   *
+   * Returns at once, the loop thread is joined by the destructor. Safe to
+   * call more than once.
    */
-  void pollWeight();
+  void stop();
 
   /**
-   * @brief Thread function that runs readTime().
+   * @brief Switch to another serial port.
+   *
+   * The reader reopens the port between two reads, the weight pipeline (tare,
+   * zero, trend) is kept. Nothing happens if port and baud are unchanged.
+   *
+   * @param newPort path of the serial port.
+   * @param newBaud baud rate of the port.
    */
-  void pollTime();
+  void setPort(const std::string &newPort, int32_t newBaud);
 
   /**
    * @brief Getter for the weight.
    *
-   * Gets the current weight in main logic.
+   * Gets the latest processed reading (gross, tare, net and range) in main
+   * logic. The reading is flagged stale unless the link is ONLINE, so a
+   * lost indicator shows on the next frame.
    */
-  uint16_t getWeight();
+  WeightReading getReading();
 
   /**
-   * @brief Getter for the clock string
+   * @brief Health of the serial link.
+   */
+  LinkStatus getLinkStatus();
+
+  /**
+   * @brief Tare the scale on the next stable reading.
+   */
+  void tare();
+
+  /**
+   * @brief Turn the vibration filter on or off, any thread.
+   */
+  void setVibrationFilter(bool enabled);
+
+  /**
+   * @brief Switch unit, division or rounding, any thread.
    *
-   * Gets the current timePoint string
+   * Applied from the next sample on, tare and zero are kept.
    */
-  std::string_view getTimepoint() const;
+  void setWeightConfig(const WeightConfig &config);
 
-private:
   /**
-   * @brief Convert incoming weight from serial > int.
+   * @brief Beaten on every wakeup of the reader, for the watchdog.
+   *
+   * Set before the loop is started.
    */
-  uint16_t convertWeight();
+  void setHeartbeat(Heartbeat *heartbeat);
 
   /**
-   * @brief Reads fd and until condtion is met.
+   * @brief Copy the net weight trend of the last TREND_WINDOW.
    *
-   * Pushes a weight that is later converted to an int.
+   * @param out decimated series, oldest column first.
    */
-  void readFromSerial();
+  void copyTrend(TrendSeries &out);
 
+private:
   /**
-   * @brief Set the current time point.
+   * @brief Convert incoming weight from serial > reading.
+   *
+   * Parses the raw grams and runs them through the weight pipeline.
+   *
+   * @return false if the line was not a number.
    */
-  void setTime();
+  bool convertWeight();
 
   /**
-   * @brief set the current timepoint
+   * @brief Reads fd and until condtion is met.
+   *
+   * Coroutine that pushes a weight that is later converted to an int, and
+   * keeps the port open (reconnect, hotplug, silence).
    */
-  void initiateTime();
+  Task readFromSerial();
 
   /**
    * @brief Opens fd and configures the serial port.
    *
-   * Called in the constructor to start a succesful connection before reading
-   * from it.
+   * Called by the reader thread before the first read and whenever the port
+   * changes.
    *
    * @return true if succesful.
    */
   bool connectToPort();
 
+  /**
+   * @brief Close the port, the reader retries with backoff.
+   *
+   * @param reason logged with the close.
+   */
+  void closePort(const char *reason);
+
+  /**
+   * @brief Count a received weight for the link statistics (mutex held).
+   */
+  void countFrame(std::chrono::steady_clock::time_point now);
+
+  /**
+   * @brief State of the link at a point in time (mutex held).
+   */
+  LinkState linkState(std::chrono::steady_clock::time_point now) const;
+
+  /**
+   * @brief Watch the directory of the port for the device (re)appearing.
+   */
+  void watchPortDirectory();
+
+  /**
+   * @brief Read hotplug events.
+   *
+   * @return true if the port was created or its permissions changed.
+   */
+  bool portAppeared();
+
   /**
    * @brief Configuarion of a port to represent a common RS232
    *
    * @param settings of configured port.
-   * @param baud rating of port, must match both ends.
+   * @param rate baud rate of port, must match both ends.
    */
-  void configureSerial(termios &settings, int baud);
+  void configureSerial(termios &settings, int32_t rate);
+
+  /**
+   * @brief Loop running the reader coroutine.
+   */
+  IoLoop &io;
 
   /**
    * @brief File descriptor of open port being used.
    */
-  int fd;
+  int fd = -1;
+
+  /**
+   * @brief Event descriptor signaled when the port settings change.
+   */
+  int reopenFd = -1;
+
+  /**
+   * @brief Serial port and baud rate, guarded by mutex.
+   */
+  std::string port;
+  int32_t baud = DEFAULT_BAUD;
+
+  /**
+   * @brief inotify descriptor watching the directory of the port.
+   */
+  int hotplugFd = -1;
+  int hotplugWatch = -1;
+  std::string portName; // File name of the port, reader thread only.
+
+  /**
+   * @brief Link statistics, guarded by mutex.
+   */
+  LinkStatus link{};
+  bool connected = false;      // Port is open.
+  bool wasConnected = false;   // Port was open before (reconnect count).
+  uint32_t windowFrames = 0;   // Weights in the current rate window.
+  std::chrono::steady_clock::time_point windowStart{};
+  std::chrono::steady_clock::time_point lastFrame{};   // Last weight.
+  std::chrono::steady_clock::time_point connectedAt{}; // Last open.
 
   /**
-   * @brief Threads running
+   * @brief Liveness of the reader for the watchdog, optional.
    */
-  std::vector<std::thread> workers;
+  Heartbeat *heartbeat = nullptr;
 
   /**
    * @brief Variable to store the incoming weight
+   *
+   * Fixed capacity, parsing a line never allocates.
    */
-  std::string incomingWeight{};
+  FixedText<MAX_LINE_LENGTH> incomingWeight{};
 
   /**
    * @brief Variable for thread safe assigning
@@ -132,24 +280,29 @@ private:
   std::mutex mutex{};
 
   /**
-   * @brief Variable for storing the converted weight.
+   * @brief Notches periodic disturbances before the pipeline.
    */
-  std::atomic<uint16_t> weight{};
+  VibrationFilter vibration;
 
   /**
-   * @brief State variable used for thread.
+   * @brief Zero tracking, tare, range and unit conversion.
    */
-  std::atomic<bool> state{};
+  WeightPipeline pipeline;
 
   /**
-   * @brief Thread safe variable for updating the timepoint variable.
-   *
-   * Will always be presented on the SDL Window.
+   * @brief Latest processed reading, guarded by mutex.
    */
-  std::string timepoint;
+  WeightReading reading{};
 
-  //! Design of the timepoint.
-  char timeString[std::size("dd/mm-yy hh:mm")]; // Store converted local time.
+  /**
+   * @brief Min/max history of net weights, guarded by mutex.
+   */
+  TrendBuffer<TREND_COLUMNS> trend{TREND_WINDOW};
+
+  /**
+   * @brief False once stop() was requested.
+   */
+  std::atomic<bool> state{};
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef FIXEDTEXT_HPP
+#define FIXEDTEXT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @class FixedText
+ *
+ * @brief Short text stored inline, never touches the heap.
+ *
+ * @details
+ * Replaces std::string for labels and line buffers on steady state paths.
+ * Text longer than Capacity is cut, assign() and push_back() report it.
+ * Always null terminated.
+ *
+ * @tparam Capacity characters kept, without the terminator.
+ */
+template <std::size_t Capacity> class FixedText {
+public:
+  FixedText() = default;
+
+  FixedText(std::string_view text) { assign(text); }
+
+  FixedText &operator=(std::string_view text) {
+    assign(text);
+    return *this;
+  }
+
+  /**
+   * @brief Replace the text.
+   *
+   * @return false if the text was cut to Capacity.
+   */
+  bool assign(std::string_view text) {
+    length = std::min(text.size(), Capacity);
+    std::copy_n(text.data(), length, storage);
+    storage[length] = '\0';
+    return length == text.size();
+  }
+
+  /**
+   * @brief Append a character.
+   *
+   * @return false if full, the text is left unchanged.
+   */
+  bool push_back(char c) {
+    if (length == Capacity)
+      return false;
+    storage[length++] = c;
+    storage[length] = '\0';
+    return true;
+  }
+
+  void clear() {
+    length = 0;
+    storage[0] = '\0';
+  }
+
+  bool empty() const { return length == 0; }
+  std::size_t size() const { return length; }
+  static constexpr std::size_t capacity() { return Capacity; }
+  const char *data() const { return storage; }
+  const char *c_str() const { return storage; }
+
+  operator std::string_view() const { return {storage, length}; }
+
+  bool operator==(std::string_view text) const {
+    return std::string_view(*this) == text;
+  }
+
+private:
+  char storage[Capacity + 1] = {};
+  std::size_t length = 0;
+};
+
+#endif
@@ -0,0 +1,206 @@
+#ifndef FRAMEMIRROR_HPP
+#define FRAMEMIRROR_HPP
+
+// Shared memory
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// C++ Standard
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Shared memory object of the mirror, /dev/shm/ppw-frames
+constexpr const char *MIRROR_NAME = "/ppw-frames";
+
+// "PPWF", changes with the layout together with MIRROR_VERSION
+constexpr uint32_t MIRROR_MAGIC = 0x46575050;
+constexpr uint32_t MIRROR_VERSION = 1;
+
+// Frames kept, a reader has MIRROR_SLOTS - 1 frame periods to read one
+constexpr uint32_t MIRROR_SLOTS = 3;
+
+// Bytes before the pixels of a slot
+constexpr std::size_t MIRROR_SLOT_HEADER = 64;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "the mirror needs lock-free 64-bit atomics in shared memory");
+
+/**
+ * @brief Part of a frame in pixels.
+ */
+struct MirrorRect {
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t w = 0;
+  int32_t h = 0;
+};
+
+/**
+ * @brief Start of the shared memory, followed by MIRROR_SLOTS slots.
+ */
+struct MirrorHeader {
+  uint32_t magic;
+  uint32_t version;
+  int32_t width;
+  int32_t height;
+  int32_t pitch;       // Bytes per row, pixels are ARGB8888.
+  uint32_t slots;      // Amount of slots.
+  uint64_t slotOffset; // Offset of slot 0 from the header.
+  uint64_t slotStride; // Bytes from one slot to the next.
+  std::atomic<uint64_t> latest; // Newest complete frame, 0 before the first.
+};
+
+/**
+ * @brief One frame, its pixels follow at MIRROR_SLOT_HEADER.
+ *
+ * Frame n lives in slot n % slots. sequence is odd while the slot is
+ * written and 0 if it never held a frame.
+ */
+struct MirrorSlot {
+  std::atomic<uint64_t> sequence;
+  uint64_t frame;       // Frame number, from 1.
+  int64_t timestampNs;  // CLOCK_MONOTONIC when it was read back.
+  MirrorRect dirty;     // Changed since frame - 1, all of it if unknown.
+};
+
+static_assert(sizeof(MirrorSlot) <= MIRROR_SLOT_HEADER);
+
+/**
+ * @class FrameMirror
+ *
+ * @brief Publishes rendered frames into a shared-memory ring.
+ *
+ * @details
+ * Writer side, one per process. Frames go into the slots round robin under
+ * a sequence lock: readers never block the writer, they check the sequence
+ * around their read and retry on a change. See FrameMirrorReader.
+ */
+class FrameMirror {
+public:
+  FrameMirror() = default;
+  FrameMirror(const FrameMirror &) = delete;
+  FrameMirror &operator=(const FrameMirror &) = delete;
+
+  /**
+   * @brief Unmap and remove the shared memory.
+   */
+  ~FrameMirror();
+
+  /**
+   * @brief Create the shared memory for frames of this size.
+   *
+   * @return false if it could not be created or mapped.
+   */
+  bool open(int width, int height, const char *name = MIRROR_NAME);
+
+  /**
+   * @brief Unmap and remove the shared memory.
+   */
+  void close();
+
+  bool isOpen() const;
+
+  /**
+   * @brief Pixels of the next slot, marked as being written.
+   *
+   * Fill all height rows, then commit() or cancel().
+   */
+  void *begin();
+
+  /**
+   * @brief Publish the slot filled since begin().
+   *
+   * @param dirty part that changed since the previous frame.
+   */
+  void commit(const MirrorRect &dirty);
+
+  /**
+   * @brief Give the slot filled since begin() up, readers skip it.
+   */
+  void cancel();
+
+  int getPitch() const;
+
+private:
+  MirrorSlot *slotOf(uint64_t frame) const;
+
+  std::string name;
+  void *mapping = nullptr;
+  std::size_t size = 0;
+  MirrorHeader *header = nullptr;
+  uint64_t frame = 0; // Frame being written or last published.
+};
+
+/**
+ * @brief Metadata of a frame read from the mirror.
+ */
+struct MirrorFrame {
+  uint64_t frame = 0;
+  int64_t timestampNs = 0;
+  MirrorRect dirty{};
+};
+
+/**
+ * @class FrameMirrorReader
+ *
+ * @brief Reader side of a FrameMirror, for viewers and sidecars.
+ *
+ * @details
+ * Maps the shared memory read-only. copyLatest() copies a consistent
+ * frame. A zero-copy consumer (an encoder) reads the pixels of latest()
+ * in place and keeps its result only if valid() still holds afterwards.
+ */
+class FrameMirrorReader {
+public:
+  FrameMirrorReader() = default;
+  FrameMirrorReader(const FrameMirrorReader &) = delete;
+  FrameMirrorReader &operator=(const FrameMirrorReader &) = delete;
+  ~FrameMirrorReader();
+
+  /**
+   * @brief Map the mirror of a running application.
+   *
+   * @return false if there is none or its layout is unknown.
+   */
+  bool open(const char *name = MIRROR_NAME);
+
+  const MirrorHeader *getHeader() const;
+
+  /**
+   * @brief Newest complete frame, read in place.
+   *
+   * @param sequence out, pass to valid() after reading.
+   *
+   * @return the slot, its pixels at MIRROR_SLOT_HEADER, nullptr if none.
+   */
+  const MirrorSlot *latest(uint64_t &sequence) const;
+
+  /**
+   * @brief True if the slot was not rewritten since latest().
+   */
+  bool valid(const MirrorSlot *slot, uint64_t sequence) const;
+
+  /**
+   * @brief Copy the newest complete frame.
+   *
+   * @param pixels height * pitch bytes.
+   * @param info metadata of the frame.
+   *
+   * @return false if no frame could be read consistently.
+   */
+  bool copyLatest(void *pixels, MirrorFrame &info) const;
+
+private:
+  const void *mapping = nullptr;
+  std::size_t size = 0;
+  const MirrorHeader *header = nullptr;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef GLYPHATLAS_HPP
+#define GLYPHATLAS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "GraphicSdlDefines.hpp"
+
+// Characters the weight can consist of (see formatWeight())
+constexpr std::string_view WEIGHT_CHARSET = "0123456789.-OLU";
+
+// Printable ASCII for labels such as the clock
+constexpr std::string_view LABEL_CHARSET =
+    " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`"
+    "abcdefghijklmnopqrstuvwxyz{|}~";
+
+/**
+ * @class GlyphAtlas
+ *
+ * @brief Pre-rendered glyphs of one font, size and color.
+ *
+ * @details
+ * Every glyph of the charset is rendered once into an ARGB8888 surface at
+ * startup. Text is then composed by copying glyph rows into a caller owned
+ * surface, which never touches the heap or the font rasterizer.
+ */
+class GlyphAtlas {
+public:
+  /**
+   * @brief Render every glyph of the charset.
+   *
+   * @param font opened font to rasterize with.
+   * @param charset characters to keep, anything else is skipped on compose.
+   * @param color color of the glyphs.
+   */
+  GlyphAtlas(TTF_Font *font, std::string_view charset, SDL_Color color);
+
+  /**
+   * @brief Width in pixels of text composed with this atlas.
+   */
+  int measure(std::string_view text) const;
+
+  /**
+   * @brief Widest glyph of the charset.
+   */
+  int getMaxAdvance() const;
+
+  /**
+   * @brief Height of every glyph.
+   */
+  int getHeight() const;
+
+  /**
+   * @brief Compose text at the top left of an ARGB8888 surface.
+   *
+   * Glyphs are copied side by side. Text that does not fit is cut.
+   *
+   * @param text characters to compose.
+   * @param target surface of at least getHeight() rows.
+   *
+   * @return width in pixels that was written.
+   */
+  int compose(std::string_view text, SDL_Surface *target) const;
+
+  /**
+   * @brief Compose the coverage (alpha) of text into an 8-bit mask.
+   *
+   * Used by the software compositor, see blendMask().
+   *
+   * @param text characters to compose.
+   * @param target first byte of the mask.
+   * @param pitch bytes between two rows of the mask.
+   * @param width usable bytes per row.
+   * @param rows rows of the mask.
+   *
+   * @return width in pixels that was written.
+   */
+  int composeMask(std::string_view text, Uint8 *target, int pitch, int width,
+                  int rows) const;
+
+private:
+  std::array<sdl_unique<SDL_Surface>, 128> glyphs; // Indexed by ASCII code.
+  std::array<std::vector<Uint8>, 128> masks;       // Coverage of each glyph.
+  int maxAdvance = 0;
+  int height = 0;
+};
+
+#endif
@@ -2,11 +2,15 @@
 #ifndef GPIO_HPP
 #define GPIO_HPP
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <optional>
 
 #include <gpiod.hpp>
 
+#include "IoLoop.hpp"
 #include "PinState.hpp"
 
 /**
@@ -22,36 +26,49 @@
  * The class handles edge event cases on certain defined Pins.
  * Sets a current state and forwards it to a PinState that is shared with the
  * SDLManager. The pins determine what can/will be shown and shutdown request.
- * Possibility to add more logic.
+ * Possibility to add more logic. Edges are read by a coroutine on the IoLoop
+ * as soon as the request fd turns readable, the render loop only reads the
+ * latest state.
  */
 class GpioPi {
 public:
   /**
    * @brief Constructor for the Gpio chip
    *
-   * On Raspberry Pi 5 the path is "/dev/gpiochip4/"
+   * On Raspberry Pi 5 the path is "/dev/gpiochip4/". Spawns the edge
+   * watcher on the loop, call before IoLoop::start().
    */
-  GpioPi(const std::string &path);
-  ~GpioPi();
+  GpioPi(IoLoop &io, const std::string &path);
 
   /**
-   * @brief Poll for edge events
-   *
-   * Requests are added into a edge event buffer and are read at entry
+   * @brief Destructor that shuts the loop down and releases the lines.
    */
-  void poll();
+  ~GpioPi();
 
   /**
    * @brief Getter for states shared between Graphics and UI.
    */
   const PinState getState() const;
 
+  /**
+   * @brief Take a pending tare request.
+   *
+   * @return true once per rising edge on the tare pin.
+   */
+  bool consumeTare();
+
 private:
   /**
    * @brief Configures the settings and builds the line offset.
    */
   void setup(gpiod::request_builder &builder);
 
+  /**
+   * @brief Coroutine that reads edge events whenever the request fd is
+   * readable.
+   */
+  Task watchEdges();
+
   /**
    * @brief Handler for the shutdown button event.
    */
@@ -62,10 +79,22 @@ private:
    */
   void handleKey(const gpiod::edge_event &event);
 
+  /**
+   * @brief Handler for the tare button event.
+   */
+  void handleTare(const gpiod::edge_event &event);
+
+  IoLoop &io;                    // Loop running watchEdges().
   gpiod::line_settings settings; // Configurations of lines.
   std::optional<gpiod::line_request>
-      request;    // Handle information about requests.
-  PinState state; // State variable of pins (HIGH / LOW).
+      request;                     // Handle information about requests.
+  gpiod::edge_event_buffer buffer; // Reused for every read.
+
+  // Written on the loop thread, read by the render loop
+  std::atomic<bool> shutdownRequested{false};
+  std::atomic<int64_t> shutdownAt{0}; // Rising edge, monotonic nanoseconds.
+  std::atomic<bool> keyEnabled{false};
+  std::atomic<bool> tarePending{false}; // Set on tare press.
 };
 
 /**
@@ -75,6 +104,7 @@ private:
  */
 enum class LogicalPin : unsigned int {
   KEY = 17,
+  TARE = 22,
   SHUTDOWN = 27,
 };
 #endif
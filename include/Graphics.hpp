@@ -2,37 +2,51 @@
 #define GRAPHICS_HPP
 
 /// C++ Standard Library
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
 #include <ctime>
 #include <iostream>
 #include <memory>
-#include <queue>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 #ifdef RPI
 #include "PinState.hpp"
 #endif
 
 // File to keep this file
+#include "AllocationCounter.hpp"
+#include "Assets.hpp"
+#include "ClockService.hpp"
+#include "Compositor.hpp"
+#include "Config.hpp"
+#include "FixedText.hpp"
+#include "FrameMirror.hpp"
+#include "GlyphAtlas.hpp"
 #include "GraphicSdlDefines.hpp"
-
-// Image paths ()
-#ifdef RPI
-constexpr const char *LOGO = "assets/img/pandema.png";
-constexpr const char *IMAGE = "assets/img/qr.png";
-constexpr const char *FONT = "assets/fonts/Lato-Light.ttf";
-#else
-
-constexpr const char *ASSET_DIR_STR = ASSET_DIR;
-
-inline std::string assetPath(const std::string &relative) {
-  return std::string(ASSET_DIR_STR) + "/" + relative;
-}
-
-// Paths
-const std::string LOGO = assetPath("img/pandema.png");
-const std::string IMAGE = assetPath("img/qr.png");
-const std::string FONT = assetPath("fonts/Lato-Light.ttf");
-#endif
+#include "Input.hpp"
+#include "LabelCache.hpp"
+#include "OperatorDisplay.hpp"
+#include "PanelPower.hpp"
+#include "Playlist.hpp"
+#include "Prerenderer.hpp"
+#include "TexturePool.hpp"
+#include "ThermalMonitor.hpp"
+#include "TrendBuffer.hpp"
+#include "TrendPlot.hpp"
+#include "WeightPipeline.hpp"
+
+// Longest label (clock, price) kept in the texture pool
+constexpr int MAX_LABEL_LENGTH = 32;
+// Frames after which every frame should be allocation free
+constexpr uint64_t STEADY_STATE_FRAMES = 120;
+// Frames between two memory reports, about a minute at 60 Hz
+constexpr uint64_t MEMORY_REPORT_FRAMES = 3600;
+// Upload the next clock label even in busy frames this close to the minute
+constexpr std::chrono::seconds PRERENDER_UPLOAD_LEAD{1};
 
 // Surface sizes and limits
 constexpr Uint16 WEIGHT_CHAR_SIZE = 250;
@@ -43,11 +57,15 @@ constexpr Uint16 LOGO_WIDTH = 242;
 constexpr Uint16 LOGO_HEIGHT = 48;
 constexpr Uint16 TIME_WIDTH = 300;
 constexpr Uint16 TIME_HEIGHT = 48;
+constexpr Uint16 TREND_WIDTH = TREND_COLUMNS;
+constexpr Uint16 TREND_HEIGHT = 120;
+// Frames between two rebuilds of the trend at full, reduced, minimal quality
+constexpr uint64_t TREND_REBUILD_FRAMES[] = {1, 6, 60};
+// Shortest time a playlist frame is shown at reduced quality
+constexpr std::chrono::milliseconds PLAYLIST_REDUCED_FRAME{100};
 /// Windows specs for Raspberry Pi Monitor
 constexpr Uint16 WINDOW_WIDTH = 1920;
 constexpr Uint16 WINDOW_HEIGHT = 1080;
-// Max allowed weight
-constexpr int MAX_WEIGHT = 15001;
 
 // Weight position (centered)
 constexpr Uint16 WEIGHT_Y =
@@ -66,6 +84,40 @@ constexpr Uint16 LOGO_Y = WINDOW_HEIGHT - LOGO_HEIGHT - 50;
 constexpr Uint16 TIME_X = 50;
 constexpr Uint16 TIME_Y = WINDOW_HEIGHT - TIME_HEIGHT - 50;
 
+// Price position (below the weight, centered at runtime)
+constexpr Uint16 PRICE_Y = WEIGHT_Y + WEIGHT_HEIGHT + 10;
+
+// Status banner position (top left) with spacing
+constexpr Uint16 STATUS_X = 50;
+constexpr Uint16 STATUS_Y = 50;
+
+// x of a label centered in the window, see renderLabel()
+constexpr int LABEL_CENTERED = -1;
+
+// Opacity of the black layer over a dimmed frame
+constexpr Uint8 DIM_ALPHA = 176;
+
+// Longest time from a reading on a blanked display to its first frame
+constexpr std::chrono::milliseconds WAKE_BUDGET{100};
+
+/**
+ * @brief Power state of the display, see SDLManager::render().
+ */
+enum class DisplayState {
+  ACTIVE,  // Frames are drawn and presented.
+  DIMMED,  // One darkened frame is kept, nothing is presented.
+  BLANKED, // Backlight off (or a black frame), nothing is presented.
+};
+
+/**
+ * @brief Name of a display state for logs and watchdog records.
+ */
+const char *displayStateName(DisplayState state);
+
+// Trend position (top right) with spacing
+constexpr Uint16 TREND_X = WINDOW_WIDTH - TREND_WIDTH - 50;
+constexpr Uint16 TREND_Y = 50;
+
 /**
  *
  * @class SDLManager
@@ -88,11 +140,16 @@ public:
    * Initializes memory needed and creates standardized window and renderer.
    *
    * @param windowTitle Name of the SDL Window
+   * @param config asset paths to load.
    */
-  SDLManager(const std::string &windowTitle);
+  SDLManager(const std::string &windowTitle,
+             const AppConfig &config = AppConfig{});
 
   /**
-   * @brief Destructor for freeing memory and exiting the application
+   * @brief Destructor that frees SDL resources and quits the libraries.
+   *
+   * Textures, glyphs, renderer and window are released before TTF/IMG/SDL are
+   * shut down. Returning from main() ends the application.
    */
   ~SDLManager();
 
@@ -106,28 +163,164 @@ public:
   void poll(const PinState &state);
 #endif
 
+  /**
+   * @brief Idle time before dimming and blanking.
+   *
+   * The display is idle while the scale shows zero and no key, button, tap
+   * or click arrives.
+   *
+   * @param dimAfter idle time before dimming, zero never dims.
+   * @param blankAfter idle time before blanking, zero never blanks.
+   */
+  void setIdleTimeouts(std::chrono::milliseconds dimAfter,
+                       std::chrono::milliseconds blankAfter);
+
+  /**
+   * @brief Counts as activity, wakes a dimmed or blanked display.
+   */
+  void notifyActivity();
+
+  /**
+   * @brief Current power state of the display, any thread.
+   */
+  DisplayState getDisplayState() const;
+
+  /**
+   * @brief Publish frames to the shared-memory mirror.
+   *
+   * Frames with changes go to MIRROR_NAME, at most fps per second, for a
+   * viewer or compression sidecar. Consumers never slow the render loop.
+   *
+   * @param fps frames per second, 0 removes the mirror.
+   */
+  void setMirrorRate(int32_t fps);
+
+  /**
+   * @brief Images and animations shown while the scale is idle.
+   *
+   * After playlist_after seconds of an empty scale without input the weight
+   * view shows the playlist instead, clock and logo stay. A reading or an
+   * input cuts back to the weight in the same frame.
+   *
+   * @param config playlist settings, an empty playlist turns it off.
+   */
+  void setPlaylist(const AppConfig &config);
+
+  /**
+   * @brief Step non-essential work down while hot, throttled or slow.
+   *
+   * Temperature and CPU frequency are sampled below sysfs_root, the render
+   * work of every frame is measured. See QualityController.
+   *
+   * @param config adaptive_quality and sysfs_root.
+   */
+  void setAdaptiveQuality(const AppConfig &config);
+
+  /**
+   * @brief Diagnostics and a large trend on a second monitor.
+   *
+   * Opens, moves or closes the operator window, see OperatorDisplay. It is
+   * drawn after the customer frame at its own rate and only with changes.
+   * Closed by hand it stays closed until operator_display changes.
+   *
+   * @param config operator_display and operator_fps.
+   */
+  void setOperatorDisplay(const AppConfig &config);
+
+  /**
+   * @brief Rebuild the renderer and every texture.
+   *
+   * Asked for by the watchdog after a stalled frame. Weight, clock and
+   * price state is kept. Textures are created again from the images and
+   * glyphs decoded before, so no file is read and no font opened here.
+   */
+  void restart();
+
   /**
    * @brief Sets up the surface and window specifications
+   *
+   * @param config asset paths to load.
    */
-  void setup();
+  void setup(const AppConfig &config);
+
+  /**
+   * @brief Create the renderer, software if acceleration fails.
+   *
+   * Also decides if text goes through the built-in compositor.
+   */
+  void createRenderer();
+
+  /**
+   * @brief Swap in decoded assets at a frame boundary.
+   *
+   * Called from the render thread between frames. Textures are created from
+   * the decoded surfaces and the text textures are redrawn with new glyphs;
+   * the weight, clock and price state is kept. A texture that fails to
+   * create keeps the current one. Surfaces and glyphs are kept for
+   * restart().
+   *
+   * @param assets decoded assets, consumed.
+   */
+  void applyAssets(AssetSet &assets);
 
   /**
    * @brief Rendering function.
    *
    * Called at the end of main to present the result of values genereted.
+   * While dimmed or blanked nothing is drawn; every texture stays resident,
+   * so the first reading that is not zero is drawn in the next frame.
    *
-   * @param weight actual weight that gets presented on application.
+   * @param reading actual weight that gets presented on application.
    * @param clock actual date and time presented by device
+   * @param price formatted price of the reading, empty hides it.
+   * @param trend decimated weight history drawn as a sparkline.
    */
-  void render(int weight, std::string_view clock);
+  void render(const WeightReading &reading, std::string_view clock,
+              std::string_view price, const TrendSeries &trend);
 
   /**
-   * @brief Event poller for desktop application.
+   * @brief Read back part of the last presented frame.
+   *
+   * Used by the latency benchmark. Only the software renderer keeps the
+   * frame after SDL_RenderPresent, other renderers return undefined pixels.
    *
-   * Polls event queue used for testing certain functionalities.
+   * @param area part of the window to read.
+   * @param pixels output, ARGB8888.
+   * @param pitch bytes per row of pixels.
+   *
+   * @return false if the renderer cannot read back.
+   */
+  bool readPixels(const SDL_Rect &area, void *pixels, int pitch);
+
+  /**
+   * @brief Hit and miss counters of the label cache.
+   */
+  LabelCacheStats getLabelStats() const;
+
+  /**
+   * @brief Takes the queued keys, clicks and taps.
+   *
+   * Drained in batches by the InputManager. A tap or click on the weight or
+   * QR code switches between them, keys act as the keymap says. While the
+   * display is dimmed or blanked an input only wakes it.
    */
   void pollEvents();
 
+  /**
+   * @brief Replace the key bindings, see InputManager::setKeymap().
+   */
+  void setKeymap(std::string_view keymap);
+
+  /**
+   * @brief Tare asked for by a key since the last call.
+   */
+  bool consumeTare();
+
+  /**
+   * @brief Event counters and input-to-frame latency.
+   */
+  InputStats getInputStats() const;
+
   /**
    * @brief Checks the status of member variable status.
    *
@@ -135,6 +328,16 @@ public:
    */
   bool getStatus();
 
+  /**
+   * @brief When the shutdown request was first seen.
+   *
+   * The GPIO edge for the shutdown pin, the drain that found the quit
+   * otherwise. Measures the teardown against SHUTDOWN_BUDGET.
+   *
+   * @return the request time, default constructed while running.
+   */
+  std::chrono::steady_clock::time_point getShutdownRequestedAt() const;
+
 private:
   /**
    * @brief Helper function for SDL errors.
@@ -144,46 +347,173 @@ private:
   void printErrMsg(const char *errMsg);
 
   /**
-   * @brief Creates the texture from the provided surfaces.
+   * @brief Decodes the configured assets and creates their textures.
+   *
+   * @param config asset paths to load.
+   */
+  void createTextures(const AppConfig &config);
+
+  /**
+   * @brief Create a texture of a decoded surface.
+   *
+   * @param surface decoded image.
+   * @param texture replaced on success, kept on failure.
    */
-  void createTextures();
+  void uploadTexture(SDL_Surface *surface, sdl_unique<SDL_Texture> &texture);
 
   /**
-   * @brief Loads the specified IMG (.png) used for rendereing.
+   * @brief Reserve the text textures again and redraw weight and clock.
    */
-  void loadSurfaceOfIMG(const char *filepath);
+  void rebuildTextTextures();
 
   /**
-   * @brief Loads the specified TTF (.ttf) used for rendering.
+   * @brief Reserves the streaming textures for weight and time.
    *
-   * Sets the pixel depth to 400 and creates the surface needer for weight
-   * texture.
-   *
-   * @param filepath file path to the font (.ttf).
-   * @param startWeight weight to start with set to 0.
+   * Sized for the longest text so updates never reallocate.
    */
-  void loadFontSurface(const char *filepath);
+  void reserveTextTextures();
 
   /**
    * @brief Updates weight texture if new weight has occured.
    *
-   * Creates a new texture and sets the expected width and position of the new
-   * weight.
+   * Composes the new weight into the pooled weight texture and sets the
+   * expected width and position of the new weight.
    *
-   * @param newWeight the new weight to present.
+   * @param reading the new weight to present.
    */
-  void updateWeightTexture(int newWeight);
+  void updateWeightTexture(const WeightReading &reading);
 
   /**
    * @brief Updates time texture if new time has occured.
    *
-   * Creates a new time texture of the updated time.
+   * Composes the updated time into the pooled time texture.
    * Position will always stay the same.
    *
    * @param timepoint measured by device.
    */
   void updateTimeTexture(std::string_view timepoint);
 
+  /**
+   * @brief Prepares the clock label of the coming minute.
+   *
+   * Hands the label to the background prerenderer, then uploads it in the
+   * first idle frame after it is composed (or any frame shortly before the
+   * minute).
+   *
+   * @param idle nothing else was updated this frame.
+   */
+  void prepareNextTime(bool idle);
+
+  /**
+   * @brief Shows the prepared clock label if it is the one due.
+   *
+   * @param timepoint incoming time generated by system.
+   *
+   * @return false if the label was not prepared, update synchronously.
+   */
+  bool flipTime(std::string_view timepoint);
+
+  /**
+   * @brief Moves between active, dimmed and blanked.
+   *
+   * @param reading weight of this frame, not zero counts as activity.
+   *
+   * @return true if the frame is drawn.
+   */
+  bool updateDisplayState(const WeightReading &reading);
+
+  /**
+   * @brief Decides if the playlist is shown in this frame.
+   *
+   * Uploads the next decoded frame once the shown one is due, paced by the
+   * frame durations rather than the render loop. Never allocates.
+   *
+   * @return true if the playlist texture replaces the weight view.
+   */
+  bool updatePlaylist();
+
+  /**
+   * @brief Creates the streaming texture of the playlist once needed.
+   */
+  void createPlaylistTexture();
+
+  /**
+   * @brief Darkens everything drawn so far.
+   */
+  void dimFrame();
+
+  /**
+   * @brief Adds a changed area to the next mirrored frame.
+   */
+  void markDirty(const SDL_Rect &area);
+
+  /**
+   * @brief Marks the whole frame as changed for the mirror.
+   */
+  void markAllDirty();
+
+  /**
+   * @brief Reads the finished frame into the mirror, before the present.
+   *
+   * Skipped if the mirror is off, nothing changed or the last frame was
+   * published less than a mirror period ago; changes carry over.
+   */
+  void publishFrame();
+
+  /**
+   * @brief Draws a label unscaled from the label cache.
+   *
+   * A label shown before is only copied, a new one is composed first.
+   *
+   * @param text label, empty draws nothing.
+   * @param x left edge, or LABEL_CENTERED.
+   * @param y top edge.
+   */
+  void renderLabel(std::string_view text, int x, int y);
+
+  /**
+   * @brief Blends the weight mask straight into the window surface.
+   *
+   * Used with the software renderer instead of copying the scaled weight
+   * texture, see blendMask(). Falls back to the texture if the window
+   * surface is not 32-bit.
+   */
+  void compositeWeight();
+
+  /**
+   * @brief Draws the trend sparkline.
+   *
+   * Rebuilds the envelope every TREND_REBUILD_FRAMES of the current quality
+   * and draws it with a single SDL_RenderDrawLines call.
+   *
+   * @param trend decimated weight history, oldest column first.
+   */
+  void renderTrend(const TrendSeries &trend);
+
+  /**
+   * @brief Switch to another quality, see QualityController.
+   *
+   * The trend is rebuilt and the weight composed again for its text mode.
+   */
+  void applyQuality(Quality next);
+
+  /**
+   * @brief Hands this frame to the operator screen, if there is one.
+   *
+   * @param reading weight of this frame.
+   * @param price formatted price, empty if none.
+   * @param trend decimated weight history.
+   * @param now time of this frame.
+   */
+  void renderOperator(const WeightReading &reading, std::string_view price,
+                      const TrendSeries &trend,
+                      std::chrono::steady_clock::time_point now);
+
+  /**
+   * @brief Open the operator window on operatorIndex, or none if off.
+   */
+  void openOperator();
+
   /**
    * @brief update the timeString to present a new time
    */
@@ -192,15 +522,16 @@ private:
   /**
    * @brief Function for determining if a weight update is needed.
    *
-   * Saves the previous weight for comparing the incoming weight.
+   * Saves the previous reading for comparing the incoming reading. Range
+   * checks are done by the WeightPipeline.
    *
-   * @param weight incoming weight to compare.
+   * @param reading incoming reading to compare.
    *
    * @returns
-   * true - if incoming weight is not the same.
-   * false - if weight is higher than MAX_WEIGHT.
+   * true - if incoming value or range state is not the same.
+   * false - if no update is needed.
    */
-  bool checkWeight(int weight);
+  bool checkWeight(const WeightReading &reading);
 
   /**
    * @brief Function for determining if a time update is needed
@@ -215,20 +546,6 @@ private:
    */
   bool checkTime(std::string_view currentTimepoint);
 
-  /**
-   * @brief State function to for handling evnet loop.
-   *
-   * @return True if event is found.
-   */
-  bool hasEvent() const;
-
-  /**
-   * @brief Pops previous and event a pushes next event forward.
-   *
-   * @return Next available event, or .empty().
-   */
-  SDL_Event getNext();
-
   /**
    * @brief Determine the background color of window.
    *
@@ -263,11 +580,11 @@ private:
    * Checks the length and returns the right amount for setting a new font
    * width.
    *
-   * @param weight incoming weight.
+   * @param text formatted weight.
    *
-   * @return the width of new weight.
+   * @return the amount of characters of the new weight.
    */
-  int checkLengthOfWeight(int weight);
+  int checkLengthOfWeight(std::string_view text);
 
   /**
    * @brief Sets the wanted width of weight texture.
@@ -275,21 +592,29 @@ private:
    * Sets a new width relative to the weight.
    * Called whenever current weight gets updated.
    *
-   * @param weight
-   * Depending of the size of the weight.
+   * @param length
+   * Amount of characters in the formatted weight.
    */
-  void setWeightWidth(int weight);
+  void setWeightWidth(int length);
+
+  /**
+   * @brief Reports heap allocations made during a steady-state frame.
+   *
+   * Logs the resident set size once the steady state is reached and every
+   * MEMORY_REPORT_FRAMES after.
+   *
+   * @param allocationsBefore allocation count at the start of the frame.
+   */
+  void checkFrameAllocations(uint64_t allocationsBefore);
 
   // Raw pointers to SDL instances.
 
   SDL_Window *getRawWindow() const;
   SDL_Renderer *getRawRenderer() const;
-  SDL_Surface *getRawSurface() const;
   SDL_Texture *getRawLogo() const;
   SDL_Texture *getRawTime() const;
   SDL_Texture *getRawImage() const;
   SDL_Texture *getRawWeight() const;
-  TTF_Font *getRawFont() const;
 
   // MEMBER VARIABLES
 
@@ -300,6 +625,7 @@ private:
    * and is set false when shutdown is requested.
    */
   bool status = true;
+  std::chrono::steady_clock::time_point shutdownRequestedAt{}; // Set once.
 
   /**
    * @brief State of what image to show.
@@ -309,31 +635,104 @@ private:
    */
   bool showImage = true;
 
-  /**
-   * @brief Event handler for dekstop application.
-   *
-   * Queue for handling events made on the SDL Application Window.
-   * Only used on x86 build.
-   */
-  std::queue<SDL_Event> events;
-  SDL_Event event; // Single event happening.
+  std::optional<InputManager> input; // Created once SDL is initialized.
+  bool tareRequested = false;         // Tare key since consumeTare().
+#ifdef RPI
+  bool keyEnabled = true; // Key switch position last applied by poll().
+#endif
+
+  WeightReading previousReading{}; // Last reading presented.
 
   int weightWidth = 0; // Width of font (dynamic during runtime).
   int weightX = 0;     // X cursor of font (dynamic during runtime).
 
-  std::string timepoint; // Store the incoming timepoint
+  FixedText<MAX_LABEL_LENGTH> timepoint; // Clock label currently drawn.
+  FixedText<MAX_LABEL_LENGTH> priceText; // Price drawn, empty if none.
 
   SDLSpec logoSpec;   // Specs for the logo presented (bottom right).
   SDLSpec timeSpec;   // Specs for the time presented (bottom left).
   SDLSpec qrSpec;     // Specs for the qr images presented (centered).
   SDLSpec weightSpec; // Specs for the weight presented (centered).
+  SDLSpec trendSpec;  // Specs for the trend presented (top right).
+
+  // Envelope points of the trend, reused every frame.
+  std::array<SDL_Point, TREND_POINTS> trendPoints{};
+  int trendPointCount = 0;  // Points of the last build.
+  uint64_t trendBuiltAt = 0; // frameCount of the last build.
+  bool trendStale = true;    // Rebuild in the next frame.
+
+  uint64_t frameCount = 0; // Frames rendered so far.
+
+  /**
+   * @brief Text is blended by the built-in compositor.
+   *
+   * Set when built with PPW_SIMD_COMPOSITOR and SDL fell back to the
+   * software renderer.
+   */
+  bool useCompositor = false;
+
+  std::vector<Uint8> weightMask; // Coverage of the weight (compositor only).
+  int weightMaskPitch = 0;       // Bytes per row of weightMask.
+  int weightMaskWidth = 0;       // Pixels used by the current weight.
+
+  std::optional<GlyphAtlas> weightGlyphs; // Glyphs of the weight font.
+  std::optional<GlyphAtlas> labelGlyphs;  // Glyphs of the label font.
+
+  TexturePool textures; // Streaming text textures.
+  std::size_t weightSlot = TEXTURE_POOL_CAPACITY; // Pool slot for weight.
+  std::size_t timeSlot = TEXTURE_POOL_CAPACITY;   // Pool slot for timestamp.
+
+  LabelCache labels; // Prices and status banners.
+
+  // Idle handling, see updateDisplayState()
+  PanelPower panel;
+  std::atomic<DisplayState> displayState{DisplayState::ACTIVE};
+  std::chrono::milliseconds dimAfter{};
+  std::chrono::milliseconds blankAfter{};
+  std::chrono::steady_clock::time_point lastActivity =
+      std::chrono::steady_clock::now();
+  bool inputActivity = false; // Key, button or event since the last frame.
+
+  // Shared-memory mirror for remote support, see publishFrame()
+  FrameMirror mirror;
+  int32_t mirrorFps = 0;
+  std::chrono::steady_clock::time_point nextMirrorAt{};
+  SDL_Rect mirrorDirty{};          // Changed since the last mirrored frame.
+  bool mirroredImage = true;       // showImage of the previous frame.
+  std::string_view mirroredStatus; // Status banner of the previous frame.
+
+  // Adaptive quality, see applyQuality()
+  ThermalMonitor thermal;
+  QualityController quality;
+  Quality renderQuality = Quality::FULL;           // Applied to this frame.
+  std::chrono::steady_clock::duration frameWork{}; // Of the last frame.
+
+  // Second monitor, see setOperatorDisplay()
+  std::optional<OperatorDisplay> operatorScreen; // Uses labelGlyphs.
+  int32_t operatorIndex = OPERATOR_OFF;          // Display asked for.
+  int32_t operatorFps = DEFAULT_OPERATOR_FPS;    // Rate asked for.
+
+  // Idle-screen playlist, see updatePlaylist()
+  std::optional<Playlist> playlist;        // Stopped before SDL_image quits.
+  sdl_unique<SDL_Texture> playlistTexture; // Reused for every frame.
+  std::chrono::seconds playlistAfter{};
+  std::chrono::steady_clock::time_point nextPlaylistAt{};
+  bool playlistUploaded = false; // playlistTexture holds a frame.
+  bool playlistShown = false;    // Shown in the last frame.
+
+  // Next clock label, prepared off the render thread in a spare slot
+  Prerenderer prerender;
+  std::size_t nextTimeSlot = TEXTURE_POOL_CAPACITY; // Pool slot for it.
+  char nextTime[TIME_LABEL_LENGTH] = ""; // Label in nextTimeSlot, or empty.
+  std::chrono::system_clock::time_point nextTimeAt{}; // When it is due.
+  bool nextTimeUploaded = false; // nextTimeSlot is ready to be drawn.
+
+  // Decoded images, kept so restart() needs no decoding
+  sdl_unique<SDL_Surface> logoSurface;
+  sdl_unique<SDL_Surface> imageSurface;
 
   sdl_unique<SDL_Texture> logo;      // Texture for logo (always visible).
-  sdl_unique<SDL_Texture> time;      // Texture for timestamp (always visible)
   sdl_unique<SDL_Texture> image;     // Texture for QR code.
-  sdl_unique<SDL_Texture> weight;    // Texture for weight.
-  sdl_unique<SDL_Surface> surface;   // Surface.
-  sdl_unique<TTF_Font> font;         // Font.
   sdl_unique<SDL_Renderer> renderer; // Renderer.
   sdl_unique<SDL_Window> window;     // Window.
 };
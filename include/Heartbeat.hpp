@@ -0,0 +1,35 @@
+#ifndef HEARTBEAT_HPP
+#define HEARTBEAT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Liveness signal of one thread, beaten by the watched thread.
+ *
+ * A beat is two relaxed atomic operations, cheap enough for every frame.
+ */
+class Heartbeat {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  void beat() {
+    last.store(Clock::now().time_since_epoch().count(),
+               std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Clock::time_point getLast() const {
+    return Clock::time_point(
+        Clock::duration(last.load(std::memory_order_relaxed)));
+  }
+
+  uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<Clock::rep> last{Clock::now().time_since_epoch().count()};
+  std::atomic<uint64_t> count{0};
+};
+
+#endif
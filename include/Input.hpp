@@ -0,0 +1,176 @@
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+// C++ Standard
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "Config.hpp"
+#include "GraphicSdlDefines.hpp"
+
+// Events taken from the SDL queue per SDL_PeepEvents() call
+constexpr int INPUT_BATCH = 32;
+
+// Key bindings and touch zones held
+constexpr std::size_t INPUT_KEYS = MAX_KEY_BINDINGS;
+constexpr std::size_t INPUT_ZONES = 4;
+
+/**
+ * @brief What a key, click or tap asks for.
+ */
+enum class InputAction : uint8_t {
+  NONE,        // Wakes the display, nothing else.
+  TOGGLE_VIEW, // Weight or QR code.
+  TARE,        // Tare on the next stable reading.
+  QUIT,        // End the application.
+};
+
+/**
+ * @brief Everything asked for by one drain().
+ */
+struct InputBatch {
+  bool quit = false;
+  bool tare = false;
+  bool activity = false;    // Any key, click or tap.
+  int toggles = 0;          // View toggles, an even count cancels out.
+  Uint32 closedWindow = 0;  // Another window than the customer's closed.
+  bool redraw = false;      // Window contents or render targets were lost.
+  bool renderReset = false; // The render device was lost with its textures.
+};
+
+/**
+ * @brief Counters of an InputManager.
+ */
+struct InputStats {
+  uint64_t events = 0;        // Events drained.
+  uint64_t filtered = 0;      // Events dropped by the event filter.
+  uint64_t measured = 0;      // Inputs with a frame presented after them.
+  uint32_t lastLatencyMs = 0; // Input to presented frame, last one.
+  uint32_t maxLatencyMs = 0;
+  uint64_t totalLatencyMs = 0;
+};
+
+/**
+ * @class InputManager
+ *
+ * @brief Keys, clicks and taps turned into actions.
+ *
+ * @details
+ * Installs an SDL event filter that drops every event type the application
+ * does not handle (motion, key up, focus and move events of windows) before
+ * it is queued, and the mouse events SDL synthesizes from touches. Closing,
+ * exposing and resizing a window and render resets pass. drain() takes the
+ * rest in
+ * batches with SDL_PeepEvents(). Keys go through a keymap, clicks and taps
+ * are hit-tested against zones of the layout. The time from an input to
+ * the next presented frame is measured from the SDL event timestamps.
+ *
+ * Construct after SDL_Init(), render thread only.
+ */
+class InputManager {
+public:
+  /**
+   * @brief Install the event filter.
+   */
+  InputManager();
+
+  /**
+   * @brief Remove the event filter.
+   */
+  ~InputManager();
+
+  InputManager(const InputManager &) = delete;
+  InputManager &operator=(const InputManager &) = delete;
+
+  /**
+   * @brief Replace the key bindings.
+   *
+   * @param keymap "key:action" entries separated by commas, keys as named
+   * by SDL_GetKeyName(), actions toggle, tare or quit (see readKeymap()).
+   *
+   * @return false if an entry was invalid, the current bindings are kept.
+   */
+  bool setKeymap(std::string_view keymap);
+
+  /**
+   * @brief Make a part of the window react to clicks and taps.
+   *
+   * Zones added first win where they overlap.
+   *
+   * @return false if INPUT_ZONES are in use.
+   */
+  bool addZone(InputAction action, const SDL_Rect &area);
+
+  /**
+   * @brief Remove every zone.
+   */
+  void clearZones();
+
+  /**
+   * @brief Window whose clicks and taps are hit-tested.
+   *
+   * Clicks and taps in other windows only count as activity.
+   *
+   * @param id SDL window id, 0 hit-tests every window.
+   */
+  void setWindow(Uint32 id);
+
+  /**
+   * @brief Take every queued event.
+   *
+   * @param width window width, touches are relative to it.
+   * @param height window height.
+   */
+  InputBatch drain(int width, int height);
+
+  /**
+   * @brief A frame was presented, ends the latency of a pending input.
+   */
+  void framePresented();
+
+  InputStats getStats() const;
+
+private:
+  /**
+   * @brief Event filter, keeps the events drain() handles.
+   */
+  static int keepEvent(void *userdata, SDL_Event *event);
+
+  /**
+   * @brief Add the action of one event to a batch.
+   */
+  void handle(const SDL_Event &event, int width, int height, InputBatch &out);
+
+  InputAction lookupKey(SDL_Keycode key) const;
+  InputAction hitTest(int x, int y) const;
+
+  struct KeyBinding {
+    SDL_Keycode key = SDLK_UNKNOWN;
+    InputAction action = InputAction::NONE;
+  };
+
+  struct Zone {
+    SDL_Rect area{};
+    InputAction action = InputAction::NONE;
+  };
+
+  std::array<SDL_Event, INPUT_BATCH> batch{};
+  std::array<KeyBinding, INPUT_KEYS> keys{};
+  std::size_t keyCount = 0;
+  std::array<Zone, INPUT_ZONES> zones{};
+  std::size_t zoneCount = 0;
+  Uint32 window = 0; // Window the zones belong to, 0 any.
+
+  bool pending = false; // An input waits for its frame.
+  Uint32 pendingAt = 0; // SDL timestamp of that input.
+  std::atomic<uint64_t> filtered{0}; // Counted in the pushing thread.
+  InputStats stats{};
+};
+
+#endif
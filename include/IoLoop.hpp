@@ -0,0 +1,213 @@
+#ifndef IOLOOP_HPP
+#define IOLOOP_HPP
+
+// Event loop
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// C++ Standard
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Most descriptors a single co_await can wait on
+constexpr std::size_t MAX_WAIT_FDS = 4;
+
+// Events taken from the kernel per epoll_wait
+constexpr int IO_EVENT_BATCH = 16;
+
+/**
+ * @brief Fire-and-forget coroutine.
+ *
+ * Starts running on the calling thread until its first co_await and frees
+ * itself when it returns. Coroutines still suspended when the IoLoop shuts
+ * down are destroyed by it.
+ */
+struct Task {
+  struct promise_type {
+    Task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+/**
+ * @brief A descriptor and the epoll events to wait for.
+ *
+ * Negative descriptors are skipped, like poll() does.
+ */
+struct IoWait {
+  int fd = -1;
+  uint32_t events = EPOLLIN;
+};
+
+/**
+ * @brief Result of a co_await on the IoLoop.
+ */
+struct IoEvent {
+  int index = -1;      // Position of the ready descriptor, -1 on timeout.
+  uint32_t events = 0; // epoll events of the ready descriptor.
+
+  bool timedOut() const { return index < 0; }
+};
+
+/**
+ * @class IoLoop
+ *
+ * @brief Single threaded epoll reactor for coroutines.
+ *
+ * @details
+ * Serial ports, gpiod request fds, timerfds, eventfds and sockets are made
+ * co_await-able with wait()/readable(), timeouts with sleepUntil(). All
+ * coroutines resume on the loop thread, one at a time, so their state
+ * needs no locking among themselves.
+ *
+ * Descriptors stay registered in epoll between two waits; one that fires
+ * while nobody waits on it is unregistered lazily. A coroutine waiting on the
+ * same descriptor in a loop therefore costs no epoll_ctl calls.
+ *
+ * Coroutines are spawned before start() (or from the loop thread). Call
+ * forget() before closing a descriptor that was waited on.
+ */
+class IoLoop {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // Deadline of a wait without timeout
+  static constexpr Clock::time_point NEVER = Clock::time_point::max();
+
+  /**
+   * @brief Awaitable returned by wait(), readable() and sleepUntil().
+   */
+  class Awaiter {
+  public:
+    Awaiter(IoLoop &loop, std::initializer_list<IoWait> waits,
+            Clock::time_point deadline);
+
+    bool await_ready() const noexcept;
+    void await_suspend(std::coroutine_handle<> coroutine);
+    IoEvent await_resume() const noexcept { return result; }
+
+  private:
+    friend class IoLoop;
+
+    IoLoop &loop;
+    std::array<IoWait, MAX_WAIT_FDS> waits{};
+    std::size_t count = 0;
+    Clock::time_point deadline;
+    std::coroutine_handle<> handle{};
+    IoEvent result{};
+  };
+
+  IoLoop();
+
+  /**
+   * @brief Shut down, see shutdown().
+   */
+  ~IoLoop();
+
+  /**
+   * @brief Run the loop on its own thread.
+   */
+  void start();
+
+  /**
+   * @brief Ask the loop thread to return, safe from any thread.
+   */
+  void stop();
+
+  /**
+   * @brief Stop, join the loop thread and destroy suspended coroutines.
+   *
+   * Safe to call more than once. Objects that coroutines refer to call this
+   * before they go away.
+   */
+  void shutdown();
+
+  /**
+   * @brief Wait until one descriptor is ready or the deadline passes.
+   *
+   * @param waits up to MAX_WAIT_FDS descriptors, negative ones are skipped.
+   * @param deadline when to give up, NEVER for no timeout.
+   */
+  Awaiter wait(std::initializer_list<IoWait> waits,
+               Clock::time_point deadline = NEVER);
+
+  /**
+   * @brief Wait until a descriptor is readable (or hung up).
+   */
+  Awaiter readable(int fd, Clock::time_point deadline = NEVER);
+
+  /**
+   * @brief Suspend until a point in time.
+   */
+  Awaiter sleepUntil(Clock::time_point deadline);
+
+  /**
+   * @brief Drop a descriptor from epoll before it is closed.
+   */
+  void forget(int fd);
+
+private:
+  /**
+   * @brief Registration of one descriptor.
+   */
+  struct Entry {
+    uint32_t registered = 0;     // Events registered in epoll, 0 if none.
+    Awaiter *waiter = nullptr;   // Coroutine waiting on it.
+  };
+
+  /**
+   * @brief Event loop, runs until stop().
+   */
+  void run();
+
+  /**
+   * @brief Register an awaiter on its descriptors and deadline.
+   */
+  void attach(Awaiter &awaiter);
+
+  /**
+   * @brief Remove an awaiter from its descriptors and deadline.
+   */
+  void detach(Awaiter &awaiter);
+
+  /**
+   * @brief Detach and resume a coroutine.
+   */
+  void resume(Awaiter &awaiter, IoEvent result);
+
+  /**
+   * @brief Resume every coroutine whose deadline passed.
+   */
+  void expireTimers();
+
+  /**
+   * @brief Milliseconds until the nearest deadline, -1 if none.
+   */
+  int nextTimeout() const;
+
+  int epollFd = -1;
+  int stopFd = -1;
+
+  std::unordered_map<int, Entry> entries;
+  std::vector<Awaiter *> timed; // Awaiters with a deadline.
+
+  std::atomic<bool> stopped{false};
+  std::thread worker;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef LABELCACHE_HPP
+#define LABELCACHE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "FixedText.hpp"
+#include "GlyphAtlas.hpp"
+#include "GraphicSdlDefines.hpp"
+
+// Longest text the cache holds, longer labels are not drawn
+constexpr std::size_t LABEL_CACHE_TEXT_LENGTH = 32;
+
+// Texture memory the cache may hold
+constexpr std::size_t LABEL_CACHE_BUDGET = 4 * 1024 * 1024;
+
+/**
+ * @brief A rendered label, owned by the cache.
+ */
+struct CachedLabel {
+  sdl_unique<SDL_Texture> texture; // Streaming texture, never recreated.
+  SDL_Rect used{};                 // Part holding the text.
+  const GlyphAtlas *atlas = nullptr;
+  FixedText<LABEL_CACHE_TEXT_LENGTH> text;
+  std::size_t hash = 0;  // Of atlas and text, compared before the text.
+  uint64_t lastUsed = 0; // Tick of the last lookup, 0 if empty.
+};
+
+/**
+ * @brief Counters of a LabelCache.
+ */
+struct LabelCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;  // Misses that replaced another label.
+  std::size_t entries = 0; // Labels held.
+  std::size_t bytes = 0;   // Texture memory of all entries.
+};
+
+/**
+ * @class LabelCache
+ *
+ * @brief Rendered text textures for labels that come and go.
+ *
+ * @details
+ * Keyed by atlas and text, the atlas stands for font, size and color. A
+ * repeated label costs a lookup and a blit; a new one is composed with the
+ * atlas and uploaded into the least recently used entry. Entries are
+ * streaming textures created once in reserve(), as many as fit the byte
+ * budget, so a miss allocates neither surfaces nor textures. Render thread
+ * only.
+ */
+class LabelCache {
+public:
+  /**
+   * @brief Create the entries, only called during setup.
+   *
+   * Drops every cached label.
+   *
+   * @param renderer renderer the textures belong to.
+   * @param width widest label in pixels.
+   * @param height label height in pixels.
+   * @param budget texture bytes, at least one entry is created.
+   *
+   * @return amount of entries, 0 if failed.
+   */
+  std::size_t reserve(SDL_Renderer *renderer, int width, int height,
+                      std::size_t budget = LABEL_CACHE_BUDGET);
+
+  /**
+   * @brief Look a label up, render it on a miss.
+   *
+   * @return the label, valid until the next get() or clear(), nullptr if
+   * the text is empty, too long or the upload failed.
+   */
+  const CachedLabel *get(const GlyphAtlas &atlas, std::string_view text);
+
+  LabelCacheStats getStats() const;
+
+  /**
+   * @brief Free every entry (before the renderer goes away).
+   */
+  void clear();
+
+private:
+  std::vector<CachedLabel> entries;
+  sdl_unique<SDL_Surface> staging; // Pixels composed on a miss.
+  std::size_t entryBytes = 0;
+  uint64_t tick = 0;
+  LabelCacheStats stats{};
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef OPERATORDISPLAY_HPP
+#define OPERATORDISPLAY_HPP
+
+// C++ Standard
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+#include "FixedText.hpp"
+#include "GlyphAtlas.hpp"
+#include "GraphicSdlDefines.hpp"
+#include "TexturePool.hpp"
+#include "ThermalMonitor.hpp"
+#include "TrendBuffer.hpp"
+#include "TrendPlot.hpp"
+#include "WeightPipeline.hpp"
+
+// Layout of the operator screen, scaled to whatever the monitor has
+constexpr int OPERATOR_WIDTH = 1280;
+constexpr int OPERATOR_HEIGHT = 720;
+constexpr int OPERATOR_MARGIN = 20;
+
+// Text lines above the trend, one pool slot each
+constexpr std::size_t OPERATOR_LINES = 6;
+constexpr std::size_t OPERATOR_LINE_LENGTH = 32;
+static_assert(OPERATOR_LINES <= TEXTURE_POOL_CAPACITY);
+
+// Trend below the lines, over the whole width
+constexpr int OPERATOR_TREND_HEIGHT = 300;
+constexpr SDL_Color OPERATOR_TREND_COLOR{0, 200, 255, 255};
+
+/**
+ * @brief State of the customer display shown to the operator.
+ */
+struct OperatorStatus {
+  const char *display = "active"; // See displayStateName().
+  Quality quality = Quality::FULL;
+  ThermalSample thermal{};
+  std::chrono::milliseconds frameWork{}; // Last customer frame, present out.
+  uint32_t inputLatencyMs = 0;           // Input to frame, last one.
+  std::string_view price;                // Empty if none.
+};
+
+/**
+ * @class OperatorDisplay
+ *
+ * @brief Diagnostics and a large trend on a second monitor.
+ *
+ * @details
+ * A window of its own on another SDL display, fed the same reading and
+ * trend as the customer window. Textures belong to one renderer, so the
+ * window has its own renderer and text slots; the glyphs are the label
+ * atlas of the customer window, decoded once.
+ *
+ * Drawn on the render thread after the customer frame is presented. The
+ * renderer does not wait for vsync and a frame is drawn at most once per
+ * period and only if a line or the trend changed, so the operator screen
+ * never holds up the customer display. Never allocates once created.
+ */
+class OperatorDisplay {
+public:
+  /**
+   * @brief Open the window, fullscreen on the Pi.
+   *
+   * Check valid() afterwards.
+   *
+   * @param display SDL display index.
+   * @param glyphs label glyphs, must outlive this or be replaced first.
+   */
+  OperatorDisplay(int32_t display, const GlyphAtlas &glyphs);
+
+  /**
+   * @brief Free the textures, then renderer and window.
+   */
+  ~OperatorDisplay();
+
+  OperatorDisplay(const OperatorDisplay &) = delete;
+  OperatorDisplay &operator=(const OperatorDisplay &) = delete;
+
+  /**
+   * @brief True if window and renderer were created.
+   */
+  bool valid() const;
+
+  /**
+   * @brief Frames per second at most.
+   */
+  void setRate(int32_t fps);
+
+  /**
+   * @brief Switch to other glyphs, every line is drawn again.
+   */
+  void setGlyphs(const GlyphAtlas &glyphs);
+
+  /**
+   * @brief SDL id of the window, see InputManager::setWindow().
+   */
+  Uint32 getWindowId() const;
+
+  /**
+   * @brief Draw and present a frame if one is due and anything changed.
+   *
+   * @param reading reading of the customer frame.
+   * @param trend decimated weight history.
+   * @param status state of the customer display.
+   * @param now time of the customer frame.
+   */
+  void render(const WeightReading &reading, const TrendSeries &trend,
+              const OperatorStatus &status,
+              std::chrono::steady_clock::time_point now);
+
+private:
+  /**
+   * @brief Reserve a slot per line, sized for the current glyphs.
+   */
+  void reserveLines();
+
+  /**
+   * @brief Compose a line if its text changed.
+   */
+  void updateLine(std::size_t line, const char *text);
+
+  /**
+   * @brief Rebuild the envelope, marks the frame dirty if it moved.
+   */
+  void updateTrend(const TrendSeries &trend);
+
+  const GlyphAtlas *glyphs;
+  int32_t display;
+
+  std::chrono::steady_clock::duration period{};
+  std::chrono::steady_clock::time_point nextAt{};
+  bool dirty = true; // Something changed since the last present.
+
+  std::array<FixedText<OPERATOR_LINE_LENGTH>, OPERATOR_LINES> shown{};
+  std::array<std::size_t, OPERATOR_LINES> slots{};
+
+  SDL_Rect trendRect{OPERATOR_MARGIN,
+                     OPERATOR_HEIGHT - OPERATOR_MARGIN - OPERATOR_TREND_HEIGHT,
+                     OPERATOR_WIDTH - 2 * OPERATOR_MARGIN,
+                     OPERATOR_TREND_HEIGHT};
+  std::array<SDL_Point, TREND_POINTS> trendPoints{}; // Drawn.
+  std::array<SDL_Point, TREND_POINTS> trendBuild{};  // Compared against it.
+  int trendPointCount = 0;
+
+  sdl_unique<SDL_Window> window;
+  sdl_unique<SDL_Renderer> renderer;
+  TexturePool textures; // Freed before the renderer.
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef PANELPOWER_HPP
+#define PANELPOWER_HPP
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+// Backlight devices of the kernel, bl_power switches the panel
+constexpr const char *BACKLIGHT_ROOT = "/sys/class/backlight";
+
+/**
+ * @class PanelPower
+ *
+ * @brief Switches the panel backlight on and off.
+ *
+ * @details
+ * Uses bl_power of the first backlight device (DSI panels, the official
+ * touch display). HDMI monitors have none; blanking then only shows a black
+ * frame and the monitor's own power saving takes over.
+ */
+class PanelPower {
+public:
+  /**
+   * @brief Find the backlight, nothing is switched yet.
+   *
+   * @param root directory holding the backlight devices.
+   */
+  explicit PanelPower(const std::string &root = BACKLIGHT_ROOT);
+
+  /**
+   * @brief True if a backlight was found.
+   */
+  bool available() const;
+
+  /**
+   * @brief Turn the backlight on or off.
+   *
+   * @return false if there is no backlight or it could not be written.
+   */
+  bool set(bool on);
+
+private:
+  std::string powerPath; // bl_power of the backlight, empty if none.
+};
+
+#endif
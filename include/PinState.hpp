@@ -2,6 +2,8 @@
 #ifndef PINSTATE_HPP
 #define PINSTATE_HPP
 
+#include <chrono>
+
 /**
  * @class PinState
  *
@@ -14,6 +16,7 @@
 struct PinState {
   bool shutdownRequested = false;
   bool keyEnabled = false;
+  std::chrono::steady_clock::time_point shutdownAt{}; // Edge of the request.
 };
 
 #endif
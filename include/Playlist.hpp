@@ -0,0 +1,152 @@
+#ifndef PLAYLIST_HPP
+#define PLAYLIST_HPP
+
+// C++ Standard
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "Config.hpp"
+#include "GraphicSdlDefines.hpp"
+
+// Size of a playlist frame, images are fitted into it and it fills the window
+constexpr int PLAYLIST_WIDTH = 1280;
+constexpr int PLAYLIST_HEIGHT = 720;
+
+// Frames decoded ahead, the whole memory of the playlist besides the image
+// being decoded
+constexpr std::size_t PLAYLIST_QUEUE = 3;
+
+/**
+ * @brief A decoded frame waiting to be shown.
+ */
+struct PlaylistFrame {
+  sdl_unique<SDL_Surface> pixels;       // PLAYLIST_WIDTH x PLAYLIST_HEIGHT.
+  std::chrono::milliseconds duration{}; // Time on screen.
+};
+
+/**
+ * @class Playlist
+ *
+ * @brief Decodes idle-screen images and animations ahead of time.
+ *
+ * @details
+ * Entries are images, shown for a while each, and directories, whose images
+ * are the frames of an animation in name order. A worker thread decodes the
+ * entries in a loop, one image at a time, and fits each into one of
+ * PLAYLIST_QUEUE preallocated frames. It waits while the queue is full, so
+ * memory stays the same whatever the length of the playlist and the worker
+ * idles while the playlist is not shown. Files are read again on every
+ * pass, edits show up in the next one.
+ *
+ * The render thread takes frames with front() and pop(), which never
+ * allocate or wait for a decode.
+ */
+class Playlist {
+public:
+  /**
+   * @brief Start the worker thread.
+   */
+  Playlist();
+
+  /**
+   * @brief Stop and join the worker.
+   */
+  ~Playlist();
+
+  Playlist(const Playlist &) = delete;
+  Playlist &operator=(const Playlist &) = delete;
+
+  /**
+   * @brief Replace the entries, the playlist starts over.
+   *
+   * Queued frames are dropped. Render thread only, not between front() and
+   * pop().
+   *
+   * @param entries paths separated by commas, relative to ASSET_ROOT.
+   * @param still time an image is shown.
+   * @param fps frames per second of animations.
+   *
+   * @return false if nothing changed, the playlist goes on.
+   */
+  bool setEntries(std::string_view entries, std::chrono::milliseconds still,
+                  int32_t fps);
+
+  /**
+   * @brief True if there is nothing to play.
+   */
+  bool empty() const;
+
+  /**
+   * @brief Next frame to show, nullptr while none is decoded.
+   *
+   * Render thread only, stays valid until pop().
+   */
+  const PlaylistFrame *front();
+
+  /**
+   * @brief Hand the front frame back to the worker.
+   */
+  void pop();
+
+private:
+  /**
+   * @brief Worker loop, runs until destruction.
+   */
+  void run();
+
+  /**
+   * @brief Start playing an entry, worker only.
+   *
+   * A directory lists its images into animation.
+   *
+   * @param current entry as configured.
+   * @param path receives the first image to decode.
+   *
+   * @return false if a directory has no images.
+   */
+  bool startEntry(const std::string &current, std::string &path);
+
+  /**
+   * @brief Decode an image and fit it, centered, into a frame.
+   */
+  static bool decodeInto(const std::string &path, SDL_Surface *frame);
+
+  mutable std::mutex mutex{};
+  std::condition_variable wake{};
+
+  // Guarded by mutex
+  std::vector<std::string> entries{};
+  std::chrono::milliseconds still{};
+  std::chrono::milliseconds frameTime{};
+  uint64_t generation = 0; // Bumped by setEntries(), drops stale decodes.
+  std::size_t head = 0;    // Front frame.
+  std::size_t count = 0;   // Decoded frames from head on.
+  std::size_t failed = 0;  // Images that failed in a row, all stops it.
+  bool stopping = false;
+
+  // From head on count frames are the render thread's, the next the worker's
+  std::array<PlaylistFrame, PLAYLIST_QUEUE> frames{};
+
+  // Worker thread
+  uint64_t workerGeneration = 0;
+  std::size_t entry = 0;                // Next entry to play.
+  std::vector<std::string> animation{}; // Frames of a directory entry.
+  std::size_t animationFrame = 0;       // Next of them.
+
+  std::thread worker;
+};
+
+#endif
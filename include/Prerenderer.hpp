@@ -0,0 +1,90 @@
+#ifndef PRERENDERER_HPP
+#define PRERENDERER_HPP
+
+// C++ Standard
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#include "GlyphAtlas.hpp"
+#include "TexturePool.hpp"
+
+// Longest text a single prerender job can hold
+constexpr std::size_t PRERENDER_TEXT_LENGTH = 64;
+
+/**
+ * @class Prerenderer
+ *
+ * @brief Composes text into a pool slot on a background thread.
+ *
+ * @details
+ * Labels known ahead of time (the next clock minute) are composed into the
+ * staging pixels of a spare TexturePool slot off the render thread. The
+ * render thread uploads the slot in an idle frame once ready() and flips to
+ * it when the text is due, so the frame at the boundary does no text work.
+ *
+ * One job runs at a time. The atlas and pool must stay untouched until the
+ * job is done, wait() before changing either.
+ */
+class Prerenderer {
+public:
+  /**
+   * @brief Start the worker thread.
+   */
+  Prerenderer();
+
+  /**
+   * @brief Finish the running job and join the worker.
+   */
+  ~Prerenderer();
+
+  /**
+   * @brief Queue a composition, render thread only.
+   *
+   * @param pool pool owning the slot.
+   * @param handle slot to compose into, not drawn until ready().
+   * @param atlas glyphs to compose with.
+   * @param text text to compose, copied.
+   *
+   * @return false if a job is still running or the text is too long.
+   */
+  bool request(TexturePool &pool, std::size_t handle, const GlyphAtlas &atlas,
+               std::string_view text);
+
+  /**
+   * @brief True once the last requested job has been composed.
+   */
+  bool ready() const;
+
+  /**
+   * @brief Block until no job is running.
+   */
+  void wait();
+
+private:
+  /**
+   * @brief Worker loop, runs until destruction.
+   */
+  void run();
+
+  std::mutex mutex{};
+  std::condition_variable wake{};
+
+  // Job, guarded by mutex while queued or running
+  TexturePool *pool = nullptr;
+  std::size_t handle = TEXTURE_POOL_CAPACITY;
+  const GlyphAtlas *atlas = nullptr;
+  char text[PRERENDER_TEXT_LENGTH] = "";
+  std::size_t length = 0;
+
+  bool queued = false;   // A job waits for or is taken by the worker.
+  bool stopping = false; // Destructor asked the worker to return.
+  std::atomic<bool> done{true}; // No job in flight, the slot is composed.
+
+  std::thread worker;
+};
+
+#endif
@@ -1,12 +1,83 @@
 #ifndef QRMANAGER_HPP
 #define QRMANAGER_HPP
 
+#include <cstdint>
 #include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
 #include <vector>
 
+// Longest accepted QR payload in bytes
+constexpr std::size_t MAX_QR_PAYLOAD = 1024;
+
+/**
+ * @class QRManager
+ *
+ * @brief Holds the QR payload of the current transaction.
+ *
+ * @details
+ * Two sides write it: the quote of the weight on the scale (setQuote, from
+ * the render loop) and the back office (setPayload, the set_qr command of
+ * TelemetryServer). A payload from the back office holds until it sets an
+ * empty one, quotes arriving meanwhile are kept and the latest is current
+ * again once it is cleared. The payload is exported through the API only,
+ * the screen shows the configured QR image. Thread safe.
+ */
 class QRManager {
-private:
 public:
+  /**
+   * @brief Reserves MAX_QR_PAYLOAD, replacing the payload never allocates.
+   */
+  QRManager();
+
+  /**
+   * @brief Hold a payload of the back office, or release it.
+   *
+   * @param newPayload content of the QR code, empty returns to the quotes.
+   *
+   * @return false if the payload is longer than MAX_QR_PAYLOAD.
+   */
+  bool setPayload(std::string_view newPayload);
+
+  /**
+   * @brief Payload of the current quote, empty without a price.
+   *
+   * Current unless the back office holds one. Never allocates.
+   *
+   * @return false if the payload is longer than MAX_QR_PAYLOAD.
+   */
+  bool setQuote(std::string_view newQuote);
+
+  /**
+   * @brief True while a payload of the back office holds.
+   */
+  bool isHeld() const;
+
+  /**
+   * @brief Copy the current payload into out.
+   *
+   * Reuses the capacity of out, so a caller keeping the string around
+   * stops allocating once it held the longest payload.
+   */
+  void copyPayload(std::string &out) const;
+
+  /**
+   * @brief Incremented on every change of the current payload.
+   */
+  uint64_t getVersion() const;
+
+private:
+  /**
+   * @brief Make text the current payload, locked by the caller.
+   */
+  void apply(std::string_view text);
+
+  mutable std::mutex mutex{};
+  std::string payload{}; // Current, what copyPayload() returns.
+  std::string quote{};   // Latest quote, also while one is held.
+  bool held = false;     // payload came from the back office.
+  uint64_t version = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
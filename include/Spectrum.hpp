@@ -0,0 +1,43 @@
+#ifndef SPECTRUM_HPP
+#define SPECTRUM_HPP
+
+#include <cstddef>
+
+/**
+ * @brief Goertzel coefficient of a frequency, 2 cos(2 pi frequency).
+ *
+ * @param frequency cycles per sample, 0 to 0.5.
+ */
+float goertzelCoefficient(double frequency);
+
+/**
+ * @brief Power of a block of samples at several frequencies.
+ *
+ * Runs one Goertzel filter per frequency over the block and writes
+ * s1^2 + s2^2 - c s1 s2, the squared magnitude of that DFT term.
+ *
+ * The kernel is chosen at build time: NEON on aarch64, SSE2 on x86 and a
+ * scalar loop everywhere else. Each vector lane runs one frequency.
+ *
+ * @param samples block to analyse, windowed by the caller.
+ * @param count samples in the block.
+ * @param coefficients goertzelCoefficient() of every frequency.
+ * @param bins amount of frequencies.
+ * @param power output, one value per frequency.
+ */
+void goertzelBank(const float *samples, std::size_t count,
+                  const float *coefficients, std::size_t bins, float *power);
+
+/**
+ * @brief Scalar reference of goertzelBank(), always available.
+ */
+void goertzelBankScalar(const float *samples, std::size_t count,
+                        const float *coefficients, std::size_t bins,
+                        float *power);
+
+/**
+ * @brief Name of the kernel goertzelBank() was built with.
+ */
+const char *getSpectrumName();
+
+#endif
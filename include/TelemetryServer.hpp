@@ -0,0 +1,238 @@
+#ifndef TELEMETRYSERVER_HPP
+#define TELEMETRYSERVER_HPP
+
+// Sockets and event loop
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// C++ Standard
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "AllocationCounter.hpp"
+#include "QRManager.hpp"
+#include "WeightPipeline.hpp"
+
+// Default socket of the local API
+constexpr const char *TELEMETRY_SOCKET = "/tmp/ppw.sock";
+
+// TCP port of the API, 0 keeps TCP off
+constexpr uint16_t TELEMETRY_TCP_PORT = 0;
+
+// Address the TCP port is bound to. The API has no authentication, set_qr
+// changes what customers pay to, so only this machine is served by default
+constexpr const char *TELEMETRY_TCP_ADDRESS = "127.0.0.1";
+
+// How often the weight source is checked for changes
+constexpr long TELEMETRY_POLL_NS = 10'000'000;
+
+// Longest request line accepted from a client
+constexpr std::size_t MAX_REQUEST_LENGTH = 4096;
+
+// Messages queued for a client before it counts as stuck and is dropped
+constexpr std::size_t MAX_PENDING_MESSAGES = 256;
+
+// Largest block kept in the pool, a request buffer fits
+constexpr std::size_t TELEMETRY_POOL_BLOCK = MAX_REQUEST_LENGTH + 1;
+
+/**
+ * @brief Where the server listens.
+ */
+struct TelemetryConfig {
+  std::string socketPath = TELEMETRY_SOCKET;
+  uint16_t tcpPort = TELEMETRY_TCP_PORT;
+  std::string tcpAddress = TELEMETRY_TCP_ADDRESS; // IPv4.
+};
+
+/**
+ * @class TelemetryServer
+ *
+ * @brief Local control and telemetry API.
+ *
+ * @details
+ * Runs an epoll event loop on its own thread. Clients connect over a Unix
+ * socket (TCP optional, loopback unless configured) and speak newline
+ * delimited JSON:
+ *
+ *   {"cmd":"get"}                  -> current state
+ *   {"cmd":"subscribe"}            -> state on every weight change
+ *   {"cmd":"unsubscribe"}
+ *   {"cmd":"set_qr","payload":"…"} -> holds a QR payload over the quotes,
+ *                                     "" hands it back to them
+ *
+ * Every weight change is serialized once and shared by all subscribers.
+ * Messages and client buffers live in a pool that only the loop thread
+ * touches. Freed blocks go back to the pool, so once it has grown to the
+ * peak number of clients steady traffic does not reach the heap. A request
+ * line never grows past MAX_REQUEST_LENGTH, longer ones drop the client.
+ * Sockets are non-blocking and a client that stops reading is dropped after
+ * MAX_PENDING_MESSAGES, so the serial and render threads never wait on it.
+ */
+class TelemetryServer {
+public:
+  using WeightSource = std::function<WeightReading()>;
+
+  /**
+   * @brief Open the sockets and start the event loop thread.
+   *
+   * @param source returns the latest reading, called from the loop thread.
+   * @param qr payload holder updated by set_qr.
+   * @param config socket path, TCP port and address.
+   */
+  TelemetryServer(WeightSource source, QRManager &qr,
+                  const TelemetryConfig &config = TelemetryConfig{});
+
+  /**
+   * @brief Stop the loop, close every client and remove the socket file.
+   */
+  ~TelemetryServer();
+
+private:
+  using Message = std::shared_ptr<const std::pmr::string>;
+
+  /**
+   * @brief State of one connected client.
+   */
+  struct Client {
+    Client(int fd, std::pmr::memory_resource *memory)
+        : fd(fd), input(memory), output(memory) {}
+
+    int fd = -1;
+    bool subscribed = false;
+    bool writing = false;            // EPOLLOUT is armed.
+    bool closed = false;             // Dropped, closed after the batch.
+    std::pmr::string input;          // Bytes of an unfinished request line.
+    std::pmr::deque<Message> output; // Messages waiting to be sent.
+    std::size_t offset = 0;          // Bytes of output.front() already sent.
+  };
+
+  /**
+   * @brief Event loop, runs until stop is signaled.
+   */
+  void run();
+
+  /**
+   * @brief Open the Unix socket (and TCP if configured).
+   */
+  bool openListeners();
+
+  /**
+   * @brief Accept every pending connection on a listener.
+   */
+  void acceptClients(int listener);
+
+  /**
+   * @brief Read and handle complete request lines.
+   */
+  void readClient(Client &client);
+
+  /**
+   * @brief Send queued messages until the socket would block.
+   */
+  void flushClient(Client &client);
+
+  /**
+   * @brief Handle one request line.
+   */
+  void handleRequest(Client &client, std::string_view line);
+
+  /**
+   * @brief Queue a message, drops the client if it stopped reading.
+   */
+  void queue(Client &client, const Message &message);
+
+  /**
+   * @brief Send the reading to subscribers if it changed.
+   */
+  void publishWeight();
+
+  /**
+   * @brief Serialize a reading as a JSON line.
+   */
+  Message serialize(const WeightReading &reading, std::string_view type);
+
+  /**
+   * @brief Copy text into a message allocated from the pool.
+   */
+  Message makeMessage(std::string_view text);
+
+  /**
+   * @brief Toggle EPOLLOUT for a client.
+   */
+  void watchWritable(Client &client, bool enable);
+
+  /**
+   * @brief Close a client at the end of the loop iteration.
+   */
+  void dropClient(int fd);
+
+  WeightSource source;
+  QRManager &qr;
+  TelemetryConfig config;
+
+  int epollFd = -1;
+  int wakeFd = -1;
+  int timerFd = -1;
+  int unixFd = -1;
+  int tcpFd = -1;
+
+  // Declared before everything allocated from it. Blocks larger than
+  // TELEMETRY_POOL_BLOCK pass to the heap and are freed there
+  std::pmr::unsynchronized_pool_resource pool{
+      std::pmr::pool_options{0, TELEMETRY_POOL_BLOCK},
+      std::pmr::new_delete_resource()};
+
+  std::string scratch; // Message being serialized, keeps its capacity.
+  std::string payload; // QR payload copied for serialize().
+
+  std::unordered_map<int, Client> clients;
+  std::vector<int> closing; // Clients dropped during this iteration.
+
+  WeightReading lastReading{};
+  bool published = false; // lastReading was sent at least once.
+
+  std::atomic<bool> state{false};
+  std::thread worker;
+};
+
+/**
+ * @brief Read a string member of a flat JSON object.
+ *
+ * Handles the common escapes, enough for the requests of this API.
+ *
+ * @param json request line.
+ * @param key member name without quotes.
+ * @param out unescaped value.
+ *
+ * @return false if the member is missing or not a string.
+ */
+bool findJsonString(std::string_view json, std::string_view key,
+                    std::string &out);
+
+/**
+ * @brief Append text as an escaped JSON string including quotes.
+ */
+void appendJsonString(std::string &out, std::string_view text);
+
+#endif
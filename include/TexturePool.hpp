@@ -0,0 +1,98 @@
+#ifndef TEXTUREPOOL_HPP
+#define TEXTUREPOOL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+
+#include "GlyphAtlas.hpp"
+#include "GraphicSdlDefines.hpp"
+
+// Amount of streaming textures the pool can hold
+constexpr std::size_t TEXTURE_POOL_CAPACITY = 6;
+
+/**
+ * @brief A fixed-size streaming texture and the pixels it is filled from.
+ */
+struct PooledTexture {
+  sdl_unique<SDL_Texture> texture; // Streaming texture, never recreated.
+  sdl_unique<SDL_Surface> staging; // CPU side pixels reused on every update.
+  SDL_Rect used{};                 // Part holding the current text.
+};
+
+/**
+ * @class TexturePool
+ *
+ * @brief Streaming text textures allocated once during setup.
+ *
+ * @details
+ * Each slot is sized for the longest text it will ever show. Updates compose
+ * the text into the slot's staging surface and upload only the used part with
+ * SDL_UpdateTexture, so changing text allocates neither surfaces nor
+ * textures.
+ */
+class TexturePool {
+public:
+  /**
+   * @brief Reserve a slot, only called during setup.
+   *
+   * @param renderer renderer the texture belongs to.
+   * @param width widest text in pixels.
+   * @param height text height in pixels.
+   *
+   * @return handle of the slot, or TEXTURE_POOL_CAPACITY if full or failed.
+   */
+  std::size_t reserve(SDL_Renderer *renderer, int width, int height);
+
+  /**
+   * @brief Compose text with an atlas and upload it.
+   *
+   * @return false if the slot is invalid or the upload failed.
+   */
+  bool update(std::size_t handle, const GlyphAtlas &atlas,
+              std::string_view text, bool solid = false);
+
+  /**
+   * @brief Compose text into the staging pixels of a slot, no upload.
+   *
+   * Touches no SDL renderer state, so another thread may compose a slot that
+   * the render thread neither draws nor uploads meanwhile.
+   *
+   * @param solid cut the coverage at half into opaque pixels, drawn without
+   * blending (set the texture blend mode to match).
+   *
+   * @return false if the slot is invalid.
+   */
+  bool compose(std::size_t handle, const GlyphAtlas &atlas,
+               std::string_view text, bool solid = false);
+
+  /**
+   * @brief Upload the composed part of a slot, render thread only.
+   *
+   * @return false if the slot is invalid or the upload failed.
+   */
+  bool upload(std::size_t handle);
+
+  /**
+   * @brief Texture of a slot, nullptr if invalid.
+   */
+  SDL_Texture *getTexture(std::size_t handle) const;
+
+  /**
+   * @brief Part of the texture holding the current text.
+   */
+  const SDL_Rect *getUsed(std::size_t handle) const;
+
+  /**
+   * @brief Free every slot (before the renderer goes away).
+   */
+  void clear();
+
+private:
+  std::array<PooledTexture, TEXTURE_POOL_CAPACITY> slots{};
+  std::size_t count = 0;
+};
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef THERMALMONITOR_HPP
+#define THERMALMONITOR_HPP
+
+#include <fcntl.h>
+#include <glob.h>
+#include <unistd.h>
+
+// C++ Standard
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Config.hpp"
+
+// Files below the root, temperature in millidegrees and frequencies in kHz
+constexpr const char *THERMAL_ZONE_TEMP = "class/thermal/thermal_zone0/temp";
+constexpr const char *CPU_CUR_FREQ =
+    "devices/system/cpu/cpu0/cpufreq/scaling_cur_freq";
+constexpr const char *CPU_MAX_FREQ =
+    "devices/system/cpu/cpu0/cpufreq/scaling_max_freq";
+constexpr const char *CPU_LIMIT_FREQ =
+    "devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq";
+
+// Throttling flags of the Pi firmware in hex, the bits of vcgencmd
+// get_throttled; missing on a PC. The device path differs between boards
+// (soc on a Pi 4, soc@107c000000 on a Pi 5), the first match is used
+constexpr const char *FIRMWARE_THROTTLED[] = {
+    "bus/platform/drivers/raspberrypi-firmware/*/get_throttled",
+    "devices/platform/soc*/soc*:firmware/get_throttled",
+};
+
+// Flags that hold now: frequency capped, throttled, soft temperature limit.
+// Bit 0 (under-voltage) throttles through bit 2, bits from 16 on are sticky
+// and tell what happened since boot
+constexpr uint32_t FIRMWARE_THROTTLED_NOW = 0xE;
+
+// Time between two samples and two quality decisions
+constexpr std::chrono::milliseconds THERMAL_PERIOD{1000};
+
+// Quality steps down from this temperature and may step up below the other,
+// millidegrees; the Pi 5 firmware throttles at 85 C
+constexpr int32_t THERMAL_HOT = 80000;
+constexpr int32_t THERMAL_COOL = 75000;
+
+// Render work of a frame (present excluded) above the budget is slow, a
+// period with more than a tenth of slow frames steps down
+constexpr std::chrono::microseconds QUALITY_FRAME_BUDGET{10000};
+constexpr uint32_t QUALITY_SLOW_DIVISOR = 10;
+
+// Calm periods in a row before quality steps up again
+constexpr int QUALITY_RECOVER = 10;
+
+/**
+ * @brief One reading of the thermal zone and the CPU frequencies.
+ *
+ * Zero where the file is missing (a PC without thermal zone).
+ */
+struct ThermalSample {
+  int32_t milliCelsius = 0;
+  int32_t curKHz = 0;         // Current CPU frequency.
+  int32_t maxKHz = 0;         // Highest allowed now, a cap lowers it.
+  int32_t limitKHz = 0;       // Highest of the CPU.
+  uint32_t firmwareFlags = 0; // Bits of FIRMWARE_THROTTLED.
+
+  /**
+   * @brief True while the firmware throttles the CPU.
+   *
+   * Taken from the firmware flags, not the frequencies: the Pi 5 firmware
+   * slows the clock without lowering scaling_max_freq, an administrator's
+   * cap lowers it for good, and the governor keeps the current frequency
+   * low whenever the CPU idles.
+   */
+  bool throttled() const {
+    return (firmwareFlags & FIRMWARE_THROTTLED_NOW) != 0;
+  }
+};
+
+/**
+ * @class ThermalMonitor
+ *
+ * @brief Samples temperature and CPU frequency from sysfs.
+ *
+ * @details
+ * A thread of its own reads the files every THERMAL_PERIOD, so a slow
+ * sensor never holds up a frame. The root is configurable: pointed at a
+ * directory with the same layout it replays whatever the files hold.
+ */
+class ThermalMonitor {
+public:
+  /**
+   * @brief Start sampling.
+   *
+   * @param root directory standing in for /sys.
+   */
+  explicit ThermalMonitor(const std::string &root = SYSFS_ROOT);
+
+  /**
+   * @brief Stop and join the sampler.
+   */
+  ~ThermalMonitor();
+
+  ThermalMonitor(const ThermalMonitor &) = delete;
+  ThermalMonitor &operator=(const ThermalMonitor &) = delete;
+
+  /**
+   * @brief Read from another root from the next sample on, any thread.
+   */
+  void setRoot(const std::string &root);
+
+  /**
+   * @brief Newest sample, any thread.
+   */
+  ThermalSample latest() const;
+
+private:
+  /**
+   * @brief Sample loop, runs until destruction.
+   */
+  void run();
+
+  /**
+   * @brief Read every file below a root.
+   *
+   * @param firmware flags file found by findFirmwareFlags(), may be empty.
+   */
+  static ThermalSample read(const std::string &root,
+                            const std::string &firmware);
+
+  /**
+   * @brief Path of the firmware throttling flags below a root.
+   *
+   * @return the first match of FIRMWARE_THROTTLED, empty if none.
+   */
+  static std::string findFirmwareFlags(const std::string &root);
+
+  mutable std::mutex mutex{};
+  std::condition_variable wake{};
+  std::string root;
+  ThermalSample sample{};
+  bool stopping = false;
+
+  std::thread worker;
+};
+
+/**
+ * @brief How much non-essential work the render loop does.
+ */
+enum class Quality : uint8_t {
+  FULL,    // Everything, every frame.
+  REDUCED, // Trend rebuilt less often, animations slowed down.
+  MINIMAL, // Trend about once a second, no playlist, solid weight text.
+};
+
+/**
+ * @brief Name of a quality level for logs.
+ */
+const char *qualityName(Quality quality);
+
+/**
+ * @class QualityController
+ *
+ * @brief Steps quality down under heat or load and back up once calm.
+ *
+ * @details
+ * Fed the render work of every frame and a thermal sample. Once per
+ * THERMAL_PERIOD it steps down one level if the CPU is hot or throttled or
+ * frames ran over QUALITY_FRAME_BUDGET, and up one level after
+ * QUALITY_RECOVER calm periods. Every transition is logged with its cause.
+ * Render thread only, never allocates.
+ */
+class QualityController {
+public:
+  /**
+   * @brief Adapt quality, or stay at FULL.
+   */
+  void setEnabled(bool enabled);
+
+  /**
+   * @brief Account the render work of one frame.
+   */
+  void record(std::chrono::steady_clock::duration work);
+
+  /**
+   * @brief Decide on the quality, once per THERMAL_PERIOD.
+   *
+   * @return the quality to render with.
+   */
+  Quality update(const ThermalSample &sample,
+                 std::chrono::steady_clock::time_point now);
+
+  Quality get() const;
+
+private:
+  bool enabled = true;
+  Quality level = Quality::FULL;
+  uint32_t frames = 0;     // Frames in this period.
+  uint32_t slowFrames = 0; // Of them over budget.
+  int calm = 0;            // Calm periods in a row.
+  std::chrono::steady_clock::time_point nextAt{};
+};
+
+#endif
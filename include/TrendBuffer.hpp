@@ -0,0 +1,99 @@
+#ifndef TRENDBUFFER_HPP
+#define TRENDBUFFER_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Columns kept by the trend, one per pixel of the trend widget
+constexpr std::size_t TREND_COLUMNS = 480;
+
+// Time span covered by the trend
+constexpr std::chrono::milliseconds TREND_WINDOW{30000};
+
+/**
+ * @brief Min/max envelope of all samples that fell into one column.
+ */
+struct TrendBucket {
+  int32_t min = 0;
+  int32_t max = 0;
+  bool filled = false; // False if no sample arrived during the column.
+};
+
+/**
+ * @brief Decimated trend, oldest column first.
+ */
+using TrendSeries = std::array<TrendBucket, TREND_COLUMNS>;
+
+/**
+ * @class TrendBuffer
+ *
+ * @brief Fixed-capacity ring of min/max buckets over a time window.
+ *
+ * @details
+ * Every column covers window / Columns of time. Samples are folded into the
+ * column of their timestamp on push, so reading the trend costs O(Columns)
+ * no matter how fast samples arrive. Not thread safe, the owner locks.
+ *
+ * @tparam Columns amount of buckets kept.
+ */
+template <std::size_t Columns> class TrendBuffer {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit TrendBuffer(std::chrono::milliseconds window)
+      : span(std::max<Clock::duration>(window / Columns, Clock::duration{1})) {}
+
+  /**
+   * @brief Fold a sample into the column of its timestamp.
+   */
+  void push(int32_t value, Clock::time_point now) {
+    int64_t id = columnOf(now);
+    Slot &slot = slots[static_cast<std::size_t>(id) % Columns];
+
+    // A slot still holding an older column starts over
+    if (slot.id != id) {
+      slot.id = id;
+      slot.bucket = TrendBucket{value, value, true};
+      return;
+    }
+
+    slot.bucket.min = std::min(slot.bucket.min, value);
+    slot.bucket.max = std::max(slot.bucket.max, value);
+  }
+
+  /**
+   * @brief Copy the columns of the window ending at now, oldest first.
+   *
+   * Columns without samples are copied as unfilled.
+   */
+  void copy(std::array<TrendBucket, Columns> &out,
+            Clock::time_point now) const {
+    int64_t newest = columnOf(now);
+    int64_t oldest = newest - static_cast<int64_t>(Columns) + 1;
+
+    for (std::size_t i = 0; i < Columns; ++i) {
+      int64_t id = oldest + static_cast<int64_t>(i);
+      const Slot &slot =
+          slots[static_cast<std::size_t>(id < 0 ? 0 : id) % Columns];
+      out[i] = slot.id == id ? slot.bucket : TrendBucket{};
+    }
+  }
+
+private:
+  struct Slot {
+    int64_t id = -1; // Absolute column number held by the slot.
+    TrendBucket bucket;
+  };
+
+  int64_t columnOf(Clock::time_point now) const {
+    return static_cast<int64_t>(now.time_since_epoch() / span);
+  }
+
+  Clock::duration span; // Time covered by one column.
+  std::array<Slot, Columns> slots{};
+};
+
+#endif
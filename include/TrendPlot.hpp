@@ -0,0 +1,34 @@
+#ifndef TRENDPLOT_HPP
+#define TRENDPLOT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "GraphicSdlDefines.hpp"
+#include "TrendBuffer.hpp"
+
+// Smallest span of the trend y-axis in grams (keeps noise flat)
+constexpr int32_t TREND_MIN_SPAN = 10;
+
+// Points of a trend envelope, two per column
+constexpr std::size_t TREND_POINTS = 2 * TREND_COLUMNS;
+
+/**
+ * @brief Build the min/max envelope of a trend inside a rect.
+ *
+ * Two points per filled column, min then max, for a single
+ * SDL_RenderDrawLines call. The y-axis spans what is visible, at least
+ * TREND_MIN_SPAN; columns are spread over the width of the rect. Cost is
+ * O(TREND_COLUMNS).
+ *
+ * @param trend decimated weight history, oldest column first.
+ * @param rect area to plot into.
+ * @param points output, TREND_POINTS long.
+ *
+ * @return points written.
+ */
+int buildTrendEnvelope(const TrendSeries &trend, const SDL_Rect &rect,
+                       SDL_Point *points);
+
+#endif
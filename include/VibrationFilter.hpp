@@ -0,0 +1,250 @@
+#ifndef VIBRATIONFILTER_HPP
+#define VIBRATIONFILTER_HPP
+
+// C++ Standard
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "Spectrum.hpp"
+
+// Samples per analysis and samples between two analyses
+constexpr std::size_t VIBRATION_WINDOW = 256;
+constexpr std::size_t VIBRATION_HOP = 64;
+
+// Frequencies analysed, one per DFT bin below half the sample rate
+constexpr std::size_t VIBRATION_BINS = VIBRATION_WINDOW / 2;
+
+// Lowest bin taken for a disturbance, lower ones hold load changes
+constexpr std::size_t VIBRATION_MIN_BIN = 3;
+
+// Disturbances filtered at once
+constexpr std::size_t VIBRATION_NOTCHES = 2;
+
+// A disturbance stands out of the median bin power by this factor and is at
+// least this many grams in amplitude
+constexpr float VIBRATION_PEAK_RATIO = 20.0f;
+constexpr float VIBRATION_MIN_AMPLITUDE = 1.0f;
+
+// Analyses a peak is seen in before it is filtered, and missed in before
+// its filter is released
+constexpr int VIBRATION_CONFIRM = 2;
+constexpr int VIBRATION_RELEASE = 8;
+
+// Quality of the notches, higher is narrower
+constexpr double VIBRATION_NOTCH_Q = 3.0;
+
+/**
+ * @brief A periodic disturbance found in a block of samples.
+ */
+struct VibrationPeak {
+  double frequency = 0.0; // Cycles per sample, 0 to 0.5.
+  float amplitude = 0.0f; // Grams.
+};
+
+/**
+ * @brief Biquad notch, unity gain away from its frequency.
+ *
+ * Normalized by a0; b2 equals b0 and b1 equals a1, so DC passes unchanged.
+ */
+struct NotchCoefficients {
+  double b0 = 1.0;
+  double b1 = 0.0;
+  double a2 = 0.0;
+
+  /**
+   * @brief Notch at a frequency in cycles per sample.
+   */
+  static NotchCoefficients at(double frequency,
+                              double q = VIBRATION_NOTCH_Q);
+};
+
+/**
+ * @brief The notches to apply, handed from the analysis to the reader.
+ */
+struct NotchSet {
+  std::size_t count = 0;
+  std::array<NotchCoefficients, VIBRATION_NOTCHES> notches{};
+  std::array<uint32_t, VIBRATION_NOTCHES> ids{}; // Same id keeps its state.
+};
+
+/**
+ * @class NotchCascade
+ *
+ * @brief Runs the notches of a NotchSet over samples.
+ *
+ * @details
+ * Direct form II transposed in double. A notch keeps its state while its id
+ * stays in the set, a new one starts settled at the last input so nothing
+ * rings when it is switched in.
+ */
+class NotchCascade {
+public:
+  /**
+   * @brief Switch to another set of notches.
+   */
+  void set(const NotchSet &next);
+
+  /**
+   * @brief Filter one sample.
+   */
+  double process(double x);
+
+  std::size_t size() const;
+
+private:
+  struct Stage {
+    NotchCoefficients coefficients{};
+    uint32_t id = 0;
+    double z1 = 0.0;
+    double z2 = 0.0;
+  };
+
+  std::array<Stage, VIBRATION_NOTCHES> stages{};
+  std::size_t count = 0;
+  double last = 0.0; // Last input, a new stage settles on it.
+};
+
+/**
+ * @class VibrationAnalyzer
+ *
+ * @brief Finds periodic disturbances in a block of samples.
+ *
+ * @details
+ * Removes the mean, applies a Hann window and runs a Goertzel bank over
+ * every bin (see goertzelBank()). Local maxima that stand out of the median
+ * power are disturbances; their frequency is refined between bins. Never
+ * allocates.
+ */
+class VibrationAnalyzer {
+public:
+  VibrationAnalyzer();
+
+  /**
+   * @brief Analyse VIBRATION_WINDOW samples.
+   *
+   * @param samples oldest first, grams.
+   * @param peaks output, strongest first.
+   *
+   * @return amount of peaks found.
+   */
+  std::size_t analyze(const float *samples,
+                      std::array<VibrationPeak, VIBRATION_NOTCHES> &peaks);
+
+private:
+  std::array<float, VIBRATION_WINDOW> window{}; // Hann.
+  std::array<float, VIBRATION_WINDOW> block{};  // Windowed samples.
+  std::array<float, VIBRATION_BINS> coefficients{};
+  std::array<float, VIBRATION_BINS> power{};
+  std::array<float, VIBRATION_BINS> sorted{}; // For the median.
+  float windowSum = 0.0f;
+};
+
+/**
+ * @class VibrationFilter
+ *
+ * @brief Removes periodic platform vibration from the sample stream.
+ *
+ * @details
+ * The serial reader passes every raw sample through filter(), which applies
+ * the current notches and every VIBRATION_HOP samples hands the last
+ * VIBRATION_WINDOW to a worker thread. The worker analyses them, tracks the
+ * disturbances over time and publishes new notches. Without a disturbance
+ * samples pass unchanged. The reader never waits for the worker: a window
+ * the worker is not ready for is skipped.
+ */
+class VibrationFilter {
+public:
+  /**
+   * @brief Start the worker thread.
+   */
+  VibrationFilter();
+
+  /**
+   * @brief Stop and join the worker.
+   */
+  ~VibrationFilter();
+
+  /**
+   * @brief Turn filtering on or off, any thread.
+   */
+  void setEnabled(bool enabled);
+
+  /**
+   * @brief Filter one raw sample, reader thread only.
+   *
+   * Never allocates or blocks.
+   *
+   * @param raw grams as sent by the indicator.
+   * @param now arrival of the sample, gives the sample rate.
+   *
+   * @return the sample without the disturbances, grams.
+   */
+  int32_t filter(int32_t raw, std::chrono::steady_clock::time_point now);
+
+private:
+  /**
+   * @brief Worker loop, runs until destruction.
+   */
+  void run();
+
+  /**
+   * @brief Match the peaks of an analysis to the tracked disturbances.
+   *
+   * @return true if the notches to apply changed.
+   */
+  bool track(const std::array<VibrationPeak, VIBRATION_NOTCHES> &peaks,
+             std::size_t found, double rate);
+
+  /**
+   * @brief Hand the last window to the worker if it is idle.
+   */
+  void submit();
+
+  std::atomic<bool> enabled{true};
+
+  // Reader thread
+  NotchCascade cascade;
+  std::array<float, VIBRATION_WINDOW> history{}; // Ring of raw samples.
+  std::array<std::chrono::steady_clock::time_point, VIBRATION_WINDOW>
+      times{};              // Arrival of each sample in history.
+  std::size_t samples = 0;  // Samples seen since enabled.
+  std::size_t sinceHop = 0; // Samples since the last handed window.
+  uint64_t appliedVersion = 0;
+
+  // Shared, guarded by mutex
+  std::mutex mutex{};
+  std::condition_variable wake{};
+  std::array<float, VIBRATION_WINDOW> pending{}; // Oldest sample first.
+  double pendingRate = 0.0;                      // Samples per second.
+  bool queued = false;
+  bool stopping = false;
+  NotchSet published{};
+  std::atomic<uint64_t> version{0}; // Bumped with every new published set.
+
+  // Worker thread
+  struct Tracked {
+    double frequency = 0.0;
+    float amplitude = 0.0f;
+    int hits = 0;   // Analyses seen in a row.
+    int misses = 0; // Analyses missed in a row.
+    uint32_t id = 0;
+    bool active = false; // Notch applied.
+  };
+  VibrationAnalyzer analyzer;
+  std::array<float, VIBRATION_WINDOW> work{};
+  std::array<Tracked, VIBRATION_NOTCHES> tracked{};
+  uint32_t nextId = 1;
+
+  std::thread worker;
+};
+
+#endif
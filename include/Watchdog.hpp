@@ -0,0 +1,182 @@
+#ifndef WATCHDOG_HPP
+#define WATCHDOG_HPP
+
+// Threads, signals and the ring file
+#include <execinfo.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// C++ Standard
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "AllocationCounter.hpp"
+#include "Config.hpp"
+#include "Heartbeat.hpp"
+
+// Incident records kept, the oldest is overwritten
+constexpr const char *WATCHDOG_RING = "/var/tmp/ppw-watchdog.ring";
+constexpr std::size_t WATCHDOG_SLOTS = 8;
+constexpr std::size_t WATCHDOG_SLOT_SIZE = 32 * 1024;
+
+// How often heartbeats are checked and metrics sampled
+constexpr std::chrono::milliseconds WATCHDOG_TICK{100};
+
+// Metrics samples written with an incident, the last 5 s
+constexpr std::size_t WATCHDOG_SAMPLES = 50;
+
+// Threads and frames per thread captured with an incident
+constexpr std::size_t WATCHDOG_MAX_THREADS = 32;
+constexpr int WATCHDOG_TRACE_DEPTH = 32;
+
+// Time threads get to answer the capture signal; the signal interrupts
+// epoll, poll and read, only a thread in uninterruptible sleep (D state, a
+// GPU ioctl) or with the signal masked cannot answer and is recorded as such
+constexpr std::chrono::milliseconds WATCHDOG_TRACE_WAIT{100};
+
+// With restart on, a render thread stalled this many deadlines ends the
+// process so the service manager starts it again
+constexpr int WATCHDOG_EXIT_AFTER = 5;
+
+/**
+ * @brief Metrics taken every WATCHDOG_TICK.
+ */
+struct WatchdogSample {
+  std::chrono::steady_clock::time_point at{};
+  int64_t frameAgeMs = 0;  // Since the last frame.
+  int64_t serialAgeMs = 0; // Since the serial reader last ran.
+  uint64_t frames = 0;     // Frames during the tick.
+  uint64_t rssKiB = 0;
+  const char *display = ""; // Display state.
+};
+
+/**
+ * @class Watchdog
+ *
+ * @brief Detects stalled render and serial threads and records evidence.
+ *
+ * @details
+ * A thread of its own checks the frame and serial heartbeats against their
+ * deadlines. On a miss it writes an incident into a ring file: backtraces
+ * of every thread (captured by a signal handler in each thread), the last
+ * WATCHDOG_SAMPLES metrics samples and the display state. Each incident
+ * fills one fixed slot and is synced, so a crash or power cut afterwards
+ * keeps it and the older ones.
+ *
+ * With restart enabled a frame miss asks the render thread to rebuild its
+ * renderer (consumeRestart()), and a render thread that never comes back
+ * ends the process.
+ */
+class Watchdog {
+public:
+  using StateSource = std::function<const char *()>;
+
+  /**
+   * @brief Open the ring file and start checking.
+   *
+   * @param config deadlines and restart setting.
+   * @param display returns the display state, called from the watchdog.
+   * @param ringPath incident file, created if missing.
+   */
+  Watchdog(const AppConfig &config, StateSource display,
+           const std::string &ringPath = WATCHDOG_RING);
+
+  /**
+   * @brief Stop checking and close the ring file.
+   */
+  ~Watchdog();
+
+  /**
+   * @brief Beaten once per frame by the render thread.
+   */
+  Heartbeat &frame();
+
+  /**
+   * @brief Beaten by the serial reader on every wakeup.
+   */
+  Heartbeat &serial();
+
+  /**
+   * @brief True once after a frame miss with restart enabled.
+   *
+   * Render thread only, rebuild the renderer when true.
+   */
+  bool consumeRestart();
+
+private:
+  /**
+   * @brief Check loop, runs until destruction.
+   */
+  void run();
+
+  /**
+   * @brief Take a metrics sample into the ring of samples.
+   */
+  void sample(std::chrono::steady_clock::time_point now);
+
+  /**
+   * @brief Compare a heartbeat against its deadline.
+   *
+   * @return true on the first check of a miss, false while it lasts.
+   */
+  bool missed(const Heartbeat &heartbeat, std::chrono::milliseconds deadline,
+              std::chrono::steady_clock::time_point now, bool &stalled);
+
+  /**
+   * @brief Write an incident into the next ring slot.
+   */
+  void record(const char *reason);
+
+  /**
+   * @brief Append the backtraces of every other thread.
+   */
+  void captureThreads(std::string &out);
+
+  /**
+   * @brief Find the slot after the newest incident in the ring file.
+   */
+  void findNextSlot();
+
+  Heartbeat frameBeat;
+  Heartbeat serialBeat;
+
+  std::chrono::milliseconds frameDeadline;
+  std::chrono::milliseconds serialDeadline;
+  bool restart;
+  StateSource display;
+
+  int ringFd = -1;
+  uint64_t incident = 0; // Number of the next incident.
+
+  std::array<WatchdogSample, WATCHDOG_SAMPLES> samples{};
+  std::size_t sampleCount = 0; // Samples taken, newest at count - 1.
+  uint64_t framesBefore = 0;   // Frame count at the previous sample.
+
+  bool frameStalled = false;  // Frame miss recorded, not yet recovered.
+  bool serialStalled = false; // Serial miss recorded, not yet recovered.
+  std::atomic<bool> restartPending{false};
+
+  std::mutex mutex{};
+  std::condition_variable wake{};
+  bool stopping = false;
+
+  std::thread worker;
+};
+
+#endif
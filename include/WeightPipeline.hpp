@@ -0,0 +1,175 @@
+#ifndef WEIGHTPIPELINE_HPP
+#define WEIGHTPIPELINE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// Max allowed gross weight in grams, above it the reading is an overload
+constexpr int32_t MAX_WEIGHT = 15001;
+
+// Lowest gross weight in grams before the reading is an underload
+constexpr int32_t MIN_WEIGHT = -200;
+
+// Internal fixed-point format, grams with 8 fractional bits
+constexpr int WEIGHT_FRACTION_BITS = 8;
+constexpr int32_t WEIGHT_ONE = 1 << WEIGHT_FRACTION_BITS;
+
+// Milli-pounds per gram in Q16 (2.20462262 * 65536)
+constexpr int64_t MILLI_LB_PER_GRAM_Q16 = 144482;
+
+// Number of samples inspected by the motion detector
+constexpr std::size_t MOTION_WINDOW = 8;
+
+// Longest text produced by formatWeight() including the terminator
+constexpr std::size_t WEIGHT_TEXT_LENGTH = 12;
+
+/**
+ * @brief Unit presented to the customer.
+ */
+enum class WeightUnit : uint8_t {
+  GRAM,
+  KILOGRAM,
+  POUND,
+};
+
+/**
+ * @brief How a value is brought onto the display division.
+ */
+enum class WeightRounding : uint8_t {
+  NEAREST, // Half away from zero.
+  DOWN,    // Towards zero.
+};
+
+/**
+ * @brief Tunables of the weight pipeline.
+ *
+ * Weights are in grams, division is counted in the smallest displayed digit
+ * of the chosen unit (1 g, 0.001 kg, 0.001 lb).
+ */
+struct WeightConfig {
+  WeightUnit unit = WeightUnit::GRAM;
+  WeightRounding rounding = WeightRounding::NEAREST;
+  int32_t division = 1;         // Display step in displayed digits.
+  int32_t motionBand = 2;       // Max spread over MOTION_WINDOW to be stable.
+  int32_t zeroTrackBand = 2;    // Drift around zero that gets tracked away.
+  int32_t zeroTrackLimit = 300; // Max total correction by zero tracking.
+  int32_t zeroTrackRate = 4;    // Correction per sample as 1 / 2^rate.
+};
+
+/**
+ * @brief A processed weight sample, ready for presentation.
+ */
+struct WeightReading {
+  int32_t gross = 0;    // Gross weight in grams (zero corrected).
+  int32_t tare = 0;     // Tare in grams.
+  int32_t net = 0;      // Net weight in grams.
+  int32_t value = 0;    // Net in display unit, scaled by 10^decimals.
+  uint8_t decimals = 0; // Decimals of value.
+  WeightUnit unit = WeightUnit::GRAM;
+  bool stable = false;    // No motion over the last samples.
+  bool overload = false;  // Gross above MAX_WEIGHT.
+  bool underload = false; // Gross below MIN_WEIGHT.
+  bool stale = false;     // No recent sample from the indicator.
+
+  /**
+   * @brief True if the reading can be shown and billed.
+   */
+  bool valid() const { return !overload && !underload && !stale; }
+};
+
+/**
+ * @class WeightPipeline
+ *
+ * @brief Turns raw indicator samples into net weights.
+ *
+ * @details
+ * Runs zero tracking, motion detection, tare, range checks and unit
+ * conversion on every sample. All arithmetic is fixed-point integer math so
+ * repeated conversions never drift.
+ */
+class WeightPipeline {
+public:
+  explicit WeightPipeline(const WeightConfig &config = WeightConfig{});
+
+  /**
+   * @brief Process a raw sample.
+   *
+   * @param raw weight in grams as sent by the indicator.
+   *
+   * @return the processed reading.
+   */
+  WeightReading process(int32_t raw);
+
+  /**
+   * @brief Request a tare on the next stable sample.
+   *
+   * Thread safe, typically called from the GPIO handler.
+   */
+  void requestTare();
+
+  /**
+   * @brief Swap the configuration, tare and zero are kept.
+   */
+  void configure(const WeightConfig &newConfig);
+
+  /**
+   * @brief Current configuration.
+   */
+  const WeightConfig &getConfig() const;
+
+private:
+  /**
+   * @brief Nudge the zero offset towards small stable readings.
+   */
+  void trackZero(int32_t grossQ);
+
+  /**
+   * @brief True if the last samples are within the motion band.
+   */
+  bool checkStable(int32_t raw);
+
+  /**
+   * @brief Convert net grams (fixed-point) into the display unit.
+   */
+  int32_t toDisplay(int32_t netQ) const;
+
+  /**
+   * @brief Apply the division and rounding mode.
+   */
+  int32_t applyDivision(int32_t value) const;
+
+  WeightConfig config;
+
+  int32_t zeroOffsetQ = 0; // Zero correction in fixed-point grams.
+  int32_t tareQ = 0;       // Tare in fixed-point grams.
+
+  std::array<int32_t, MOTION_WINDOW> history{}; // Last raw samples.
+  std::size_t historyIndex = 0;
+  std::size_t historyCount = 0;
+
+  std::atomic<bool> tareRequested{false};
+};
+
+/**
+ * @brief Format a reading as displayed text.
+ *
+ * Writes the net value with its decimals, "OL"/"UL" when out of range or
+ * "---" when the reading is stale.
+ * Never allocates.
+ *
+ * @param reading reading to format.
+ * @param buffer output, at least WEIGHT_TEXT_LENGTH bytes.
+ * @param length size of buffer.
+ *
+ * @return the amount of characters written (without terminator).
+ */
+std::size_t formatWeight(const WeightReading &reading, char *buffer,
+                         std::size_t length);
+
+#endif
@@ -1,34 +1,181 @@
+#include "AssetWatcher.hpp"
+#include "Billing.hpp"
+#include "ClockService.hpp"
+#include "Config.hpp"
 #include "Device.hpp"
 #include "Gpio.hpp"
 #include "Graphics.hpp"
+#include "QRManager.hpp"
+#include "TelemetryServer.hpp"
+#include "Watchdog.hpp"
 
 int main() {
-  SDLManager sdl("pay-per-weigh");
+  std::chrono::steady_clock::time_point shutdownEdge;
+
+  {
+    // Defaults are used if the file is missing
+    AppConfig config;
+    loadConfig(assetPath(CONFIG_FILE).c_str(), config);
+
+    SDLManager sdl("pay-per-weigh", config);
+
+    // Evidence when frames or the serial reader stall
+    Watchdog watchdog(
+        config, [&sdl] { return displayStateName(sdl.getDisplayState()); });
+
+    QRManager qr;
+
+    // TCP stays off unless configured, and on loopback unless opened up
+    TelemetryConfig apiConfig;
+    apiConfig.tcpPort = static_cast<uint16_t>(config.apiPort);
+    apiConfig.tcpAddress = config.apiAddress;
+
+    Billing billing;
+    if (!billing.load(assetPath(config.tariff).c_str()))
+      std::cerr << "[Main] No tariff, prices are not shown\n";
 
 #ifdef RPI
-  Device pi;
-  GpioPi gpio("/dev/gpiochip4");
+    // Serial reader, clock and GPIO edges share one loop thread
+    IoLoop io;
+    Device pi(io, config);
+    pi.setHeartbeat(&watchdog.serial());
+    GpioPi gpio(io, "/dev/gpiochip4");
+    ClockService clock(io);
+    io.start();
+    TelemetryServer api([&pi] { return pi.getReading(); }, qr, apiConfig);
+#else
+    // Desktop serves a fixed reading to the API
+    TelemetryServer api(
+        [reading = WeightPipeline{toWeightConfig(config)}.process(1337)] {
+          return reading;
+        },
+        qr, apiConfig);
 #endif
 
-  std::string timePoint{};
-  int currentWeight{0};
+    std::string_view timePoint{};
+    WeightReading currentWeight{};
+    TrendSeries trend{};
+
+    int32_t amount = NO_PRICE;
+    int32_t payloadNet = 0; // Net weight in the current payload.
+    char priceText[PRICE_TEXT_LENGTH] = "";
+    char payload[PAYLOAD_TEXT_LENGTH] = "";
+
+    // Decodes changed files off-thread, applied between two frames
+    AssetWatcher watcher(config);
+    AssetUpdate update;
+
+#ifndef RPI
+    // Desktop has no indicator, feed a fixed sample through the pipeline
+    WeightPipeline pipeline{toWeightConfig(config)};
+    TrendBuffer<TREND_COLUMNS> desktopTrend{TREND_WINDOW};
+#endif
+
+    while (sdl.getStatus()) {
+
+#ifdef RPI
+      currentWeight = pi.getReading();
+      pi.copyTrend(trend);
+      timePoint = clock.label();
+      if (gpio.consumeTare()) {
+        pi.tare();
+        sdl.notifyActivity();
+      }
+      sdl.poll(gpio.getState());
+      // Touchscreen and keyboard, when attached
+      sdl.pollEvents();
+      if (sdl.consumeTare())
+        pi.tare();
+#else
+      // For testing on desktop
+      timePoint = "[TEST] 940601 - 13:37";
+      sdl.pollEvents();
+      if (sdl.consumeTare())
+        pipeline.requestTare();
+      currentWeight = pipeline.process(1337);
+      watchdog.serial().beat();
+      desktopTrend.push(currentWeight.net, std::chrono::steady_clock::now());
+      desktopTrend.copy(trend, std::chrono::steady_clock::now());
+#endif
 
-  while (sdl.getStatus()) {
+      if (!sdl.getStatus())
+        break;
 
+      if (watcher.take(update)) {
+        sdl.applyAssets(update.assets);
+        if (update.tariff && billing.setTariff(*update.tariff)) {
+          // Quote again with the new prices, no code for the old ones
+          amount = NO_PRICE;
+          priceText[0] = '\0';
+          qr.setQuote("");
+        }
+        if (update.config) {
+          config = *update.config;
 #ifdef RPI
-    currentWeight = pi.getWeight();
-    timePoint = pi.getTimepoint();
-    gpio.poll();
-    sdl.poll(gpio.getState());
+          pi.setPort(update.config->port, update.config->baud);
+          pi.setVibrationFilter(update.config->vibrationFilter);
+          pi.setWeightConfig(toWeightConfig(*update.config));
 #else
-    // For testing on desktop
-    timePoint = "[TEST] 940601 - 13:37";
-    sdl.pollEvents();
-    currentWeight = 1337;
+          pipeline.configure(toWeightConfig(*update.config));
 #endif
+          sdl.setIdleTimeouts(std::chrono::minutes(update.config->dimAfter),
+                              std::chrono::minutes(update.config->blankAfter));
+          sdl.setMirrorRate(update.config->mirrorFps);
+          sdl.setKeymap(update.config->keymap);
+          sdl.setPlaylist(*update.config);
+          sdl.setAdaptiveQuality(*update.config);
+          sdl.setOperatorDisplay(*update.config);
+        }
+        update = AssetUpdate{};
+      }
+
+      // Table lookup, only a new price formats text
+      int32_t quoted = billing.quote(currentWeight);
+      bool repriced = quoted != amount;
+      const std::string &currency = billing.getTariff().currency;
+      if (repriced) {
+        amount = quoted;
+        formatPrice(amount, currency, priceText, sizeof(priceText));
+      }
+
+      // The payload also carries the net weight, which can change under a
+      // rounded or fixed price. Empty without a price, a code for an earlier
+      // weight must not stay
+      if (repriced || (amount != NO_PRICE && currentWeight.net != payloadNet)) {
+        payloadNet = currentWeight.net;
+        formatPayload(amount, currency, payloadNet, payload, sizeof(payload));
+        qr.setQuote(payload);
+      }
+
+      sdl.render(currentWeight, timePoint, priceText, trend);
+      watchdog.frame().beat();
+
+      if (watchdog.consumeRestart())
+        sdl.restart();
+    }
+
+    // Timed from the GPIO edge or the close event, not the loop exit
+    shutdownEdge = sdl.getShutdownRequestedAt();
+    if (shutdownEdge == std::chrono::steady_clock::time_point{})
+      shutdownEdge = std::chrono::steady_clock::now();
+
+#ifdef RPI
+    // Stop the loop thread while GPIO and SDL tear down
+    pi.stop();
+#endif
+    // Members go out of scope in reverse order: watcher, API, clock, GPIO,
+    // Device, loop, watchdog, SDL
+  }
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - shutdownEdge);
 
-    sdl.render(currentWeight, timePoint);
+  std::cout << "[Main] Shutdown took " << elapsed.count() << " ms\n";
+  if (elapsed > SHUTDOWN_BUDGET) {
+    std::cout << "[Main] Shutdown exceeded " << SHUTDOWN_BUDGET.count()
+              << " ms budget\n";
   }
+  std::cout << std::flush;
 
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,78 @@
+#!/bin/sh
+# Builds the x86 profiles (Debug, Release + LTO, Release + LTO + PGO), trains
+# PGO on the benchmarks and reports binary size and benchmark deltas.
+#
+# Needs Google Benchmark. For the Pi, copy the .gcda files of a GENERATE
+# build run on the device into PPW_PGO_DIR of the cross build.
+
+BUILD_DIR=build-profile
+BIN_DIR=bin/x86
+RESULTS="$BUILD_DIR/results"
+
+ROOT_DIR=$(pwd)
+mkdir -p "$RESULTS"
+
+# configure <build type> <pgo mode>
+configure() {
+  cmake -S . -B "$BUILD_DIR" \
+        -DCMAKE_TOOLCHAIN_FILE=toolchain-x86.cmake \
+        -DCMAKE_BUILD_TYPE="$1" \
+        -DPPW_PGO="$2" \
+        -DPPW_BUILD_BENCH=ON > /dev/null || exit 1
+}
+
+# measure <name>: size and benchmarks of the current build
+measure() {
+  cmake --build "$BUILD_DIR" -j"$(nproc)" || exit 1
+  size "$BIN_DIR/pay-per-weigh" | tail -n 1 > "$RESULTS/$1.size"
+  SDL_VIDEODRIVER=offscreen SDL_RENDER_DRIVER=software \
+    "$BIN_DIR/micro-bench" --benchmark_out="$RESULTS/$1.json" \
+                           --benchmark_out_format=json > /dev/null || exit 1
+}
+
+echo "Debug..."
+configure Debug OFF
+measure debug
+
+echo "Release + LTO..."
+configure Release OFF
+measure release
+
+echo "Training PGO..."
+rm -rf "$BUILD_DIR/pgo"
+configure Release GENERATE
+cmake --build "$BUILD_DIR" -j"$(nproc)" || exit 1
+"$BIN_DIR/latency-bench" > /dev/null
+SDL_VIDEODRIVER=offscreen SDL_RENDER_DRIVER=software \
+  "$BIN_DIR/micro-bench" > /dev/null
+
+echo "Release + LTO + PGO..."
+configure Release USE
+measure pgo
+
+cd "$ROOT_DIR" || exit 1
+
+echo
+echo "Binary size (text data bss dec):"
+for profile in debug release pgo; do
+  printf "  %-8s %s\n" "$profile" "$(cut -f 1-4 "$RESULTS/$profile.size")"
+done
+
+echo
+echo "Benchmark real time against Release:"
+python3 - "$RESULTS/release.json" "$RESULTS/debug.json" "$RESULTS/pgo.json" <<'EOF'
+import json, sys
+
+def load(path):
+    with open(path) as f:
+        return {b["name"]: b["real_time"] for b in json.load(f)["benchmarks"]}
+
+base = load(sys.argv[1])
+debug = load(sys.argv[2])
+pgo = load(sys.argv[3])
+
+print(f"  {'benchmark':<36}{'release':>12}{'debug':>10}{'pgo':>10}")
+for name, time in base.items():
+    ratio = lambda other: f"{other[name] / time:9.2f}x" if name in other else ""
+    print(f"  {name:<36}{time:12.1f}{ratio(debug):>10}{ratio(pgo):>10}")
+EOF
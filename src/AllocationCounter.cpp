@@ -0,0 +1,139 @@
+#include "AllocationCounter.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <charconv>
+
+uint64_t getResidentBytes() {
+  int fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return 0;
+
+  char text[128];
+  ssize_t bytes = read(fd, text, sizeof(text) - 1);
+  close(fd);
+  if (bytes <= 0)
+    return 0;
+
+  // "size resident shared ..." in pages
+  const char *begin = text;
+  const char *end = text + bytes;
+  while (begin != end && *begin != ' ')
+    ++begin;
+
+  uint64_t pages = 0;
+  if (begin == end || std::from_chars(begin + 1, end, pages).ec != std::errc{})
+    return 0;
+
+  return pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+#ifdef PPW_COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <SDL2/SDL.h>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+// Set while an enabled AllocationGuard is alive on the thread
+thread_local bool guarded = false;
+
+SDL_malloc_func sdlMalloc = nullptr;
+SDL_calloc_func sdlCalloc = nullptr;
+SDL_realloc_func sdlRealloc = nullptr;
+SDL_free_func sdlFree = nullptr;
+
+void countAllocation() {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+
+#ifdef PPW_ALLOCATION_GUARD
+  if (guarded) {
+    // Unguard first, reporting must not trip the guard again
+    guarded = false;
+    std::fputs("[Memory] Heap allocation in a steady state section\n", stderr);
+    std::abort();
+  }
+#endif
+}
+
+void *countingMalloc(size_t size) {
+  countAllocation();
+  return sdlMalloc(size);
+}
+
+void *countingCalloc(size_t count, size_t size) {
+  countAllocation();
+  return sdlCalloc(count, size);
+}
+
+void *countingRealloc(void *memory, size_t size) {
+  countAllocation();
+  return sdlRealloc(memory, size);
+}
+
+void *allocate(std::size_t size) {
+  countAllocation();
+  if (void *memory = std::malloc(size ? size : 1))
+    return memory;
+  throw std::bad_alloc();
+}
+
+} // namespace
+
+void installAllocationHooks() {
+  if (sdlMalloc)
+    return;
+
+  SDL_GetMemoryFunctions(&sdlMalloc, &sdlCalloc, &sdlRealloc, &sdlFree);
+  SDL_SetMemoryFunctions(countingMalloc, countingCalloc, countingRealloc,
+                         sdlFree);
+}
+
+uint64_t getAllocationCount() {
+  return allocations.load(std::memory_order_relaxed);
+}
+
+AllocationGuard::AllocationGuard(bool enabled) : previous(guarded) {
+  guarded = guarded || enabled;
+}
+
+AllocationGuard::~AllocationGuard() { guarded = previous; }
+
+AllocationExemption::AllocationExemption() : previous(guarded) {
+  guarded = false;
+}
+
+AllocationExemption::~AllocationExemption() { guarded = previous; }
+
+// Global replacements, pulled in through installAllocationHooks()
+void *operator new(std::size_t size) { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+#else
+
+void installAllocationHooks() {}
+
+uint64_t getAllocationCount() { return 0; }
+
+AllocationGuard::AllocationGuard(bool) {}
+
+AllocationGuard::~AllocationGuard() {}
+
+AllocationExemption::AllocationExemption() {}
+
+AllocationExemption::~AllocationExemption() {}
+
+#endif
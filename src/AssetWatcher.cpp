@@ -0,0 +1,195 @@
+#include "AssetWatcher.hpp"
+
+void AssetUpdate::merge(AssetUpdate &&newer) {
+  if (newer.config)
+    config = std::move(newer.config);
+  if (newer.tariff)
+    tariff = std::move(newer.tariff);
+  assets.merge(std::move(newer.assets));
+}
+
+AssetWatcher::AssetWatcher(const AppConfig &config) : config{config} {
+  inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotifyFd < 0) {
+    std::cout << "[Assets] inotify failed, reloading is off\n";
+    return;
+  }
+
+  // Wakes the thread on shutdown
+  wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wakeFd < 0) {
+    std::cout << "[Assets] Wake descriptor failed, reloading is off\n";
+    return;
+  }
+
+  watchDirectories();
+
+  worker = std::thread(&AssetWatcher::run, this);
+}
+
+AssetWatcher::~AssetWatcher() {
+  uint64_t one = 1;
+  if (wakeFd >= 0 && write(wakeFd, &one, sizeof(one)) < 0) {
+    std::cout << "[Assets] Wake signal failed\n";
+  }
+
+  if (worker.joinable())
+    worker.join();
+
+  if (inotifyFd >= 0)
+    close(inotifyFd);
+  if (wakeFd >= 0)
+    close(wakeFd);
+}
+
+bool AssetWatcher::take(AssetUpdate &out) {
+  if (!ready.load(std::memory_order_acquire))
+    return false;
+
+  // The watcher only holds the lock to merge, try again next frame
+  std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+  if (!lock.owns_lock())
+    return false;
+
+  out = std::move(pending);
+  pending = AssetUpdate{};
+  ready.store(false, std::memory_order_release);
+  return true;
+}
+
+void AssetWatcher::run() {
+  std::vector<std::string> changed;
+  pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+
+  while (true) {
+    // Block until the first change, then until the writes settle
+    int timeout = changed.empty() ? -1 : RELOAD_SETTLE_MS;
+
+    int count = poll(fds, std::size(fds), timeout);
+    if (count < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    if (fds[1].revents & POLLIN)
+      break;
+
+    if (count == 0) {
+      reload(changed);
+      changed.clear();
+      continue;
+    }
+
+    if (fds[0].revents & POLLIN)
+      readEvents(changed);
+  }
+}
+
+void AssetWatcher::watchDirectories() {
+  const std::string files[] = {
+      assetPath(CONFIG_FILE), assetPath(config.logo), assetPath(config.image),
+      assetPath(config.font), assetPath(config.tariff)};
+
+  for (const std::string &file : files) {
+    std::string directory = file.substr(0, file.rfind('/'));
+
+    bool watched = std::any_of(
+        directories.begin(), directories.end(),
+        [&directory](const auto &entry) { return entry.second == directory; });
+    if (watched)
+      continue;
+
+    // Writes in place and editor renames both end a change
+    int watch = inotify_add_watch(inotifyFd, directory.c_str(),
+                                  IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch < 0) {
+      std::cout << "[Assets] Could not watch " << directory << "\n";
+      continue;
+    }
+
+    directories[watch] = directory;
+  }
+}
+
+void AssetWatcher::readEvents(std::vector<std::string> &changed) {
+  alignas(inotify_event) char buffer[INOTIFY_BUFFER_LENGTH];
+
+  while (true) {
+    ssize_t bytes = read(inotifyFd, buffer, sizeof(buffer));
+    if (bytes <= 0)
+      return;
+
+    for (char *cursor = buffer; cursor < buffer + bytes;) {
+      const auto *event = reinterpret_cast<const inotify_event *>(cursor);
+      cursor += sizeof(inotify_event) + event->len;
+
+      auto directory = directories.find(event->wd);
+      if (event->len == 0 || directory == directories.end())
+        continue;
+
+      std::string path = directory->second + "/" + event->name;
+      if (std::find(changed.begin(), changed.end(), path) == changed.end())
+        changed.push_back(std::move(path));
+    }
+  }
+}
+
+void AssetWatcher::reload(const std::vector<std::string> &changed) {
+  auto wasChanged = [&changed](const std::string &relative) {
+    return std::find(changed.begin(), changed.end(), assetPath(relative)) !=
+           changed.end();
+  };
+
+  // A broken file keeps the current configuration
+  AppConfig next = config;
+  if (wasChanged(CONFIG_FILE) &&
+      !loadConfig(assetPath(CONFIG_FILE).c_str(), next)) {
+    std::cout << "[Assets] Keeping the current configuration\n";
+  }
+
+  AssetUpdate update;
+
+  if (next.logo != config.logo || wasChanged(next.logo))
+    update.assets.logo = decodeImage(assetPath(next.logo));
+
+  if (next.image != config.image || wasChanged(next.image))
+    update.assets.image = decodeImage(assetPath(next.image));
+
+  if (next.font != config.font || wasChanged(next.font))
+    decodeGlyphs(assetPath(next.font), update.assets);
+
+  if (next.tariff != config.tariff || wasChanged(next.tariff)) {
+    Tariff tariff;
+    if (loadTariff(assetPath(next.tariff).c_str(), tariff) &&
+        validTariff(tariff))
+      update.tariff = std::move(tariff);
+    else
+      std::cout << "[Assets] Keeping the current tariff\n";
+  }
+
+  if (next != config) {
+    config = next;
+    update.config = next;
+    watchDirectories();
+  }
+
+  if (update.empty())
+    return;
+
+  std::cout << "[Assets] Reloaded" << (update.config ? " config" : "")
+            << (update.tariff ? " tariff" : "")
+            << (update.assets.logo ? " logo" : "")
+            << (update.assets.image ? " image" : "")
+            << (update.assets.weightGlyphs ? " font" : "") << "\n";
+
+  publish(std::move(update));
+}
+
+void AssetWatcher::publish(AssetUpdate &&update) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // Not taken yet, newer changes win
+  pending.merge(std::move(update));
+  ready.store(true, std::memory_order_release);
+}
@@ -0,0 +1,45 @@
+#include "Assets.hpp"
+
+namespace {
+
+// SDL_ttf and FreeType are not thread safe, the render thread and the asset
+// watcher open and rasterize one font at a time
+std::mutex fontMutex;
+
+} // namespace
+
+void AssetSet::merge(AssetSet &&newer) {
+  if (newer.logo)
+    logo = std::move(newer.logo);
+  if (newer.image)
+    image = std::move(newer.image);
+  if (newer.weightGlyphs && newer.labelGlyphs) {
+    weightGlyphs = std::move(newer.weightGlyphs);
+    labelGlyphs = std::move(newer.labelGlyphs);
+  }
+}
+
+sdl_unique<SDL_Surface> decodeImage(const std::string &filepath) {
+  sdl_unique<SDL_Surface> surface(IMG_Load(filepath.c_str()));
+  if (!surface)
+    std::cerr << "SDL_Error occured: " << SDL_GetError() << "\n";
+  return surface;
+}
+
+bool decodeGlyphs(const std::string &filepath, AssetSet &out) {
+  // Held until both fonts are closed again
+  std::lock_guard<std::mutex> lock(fontMutex);
+  sdl_unique<TTF_Font> font(TTF_OpenFont(filepath.c_str(), WEIGHT_FONT_SIZE));
+  sdl_unique<TTF_Font> labelFont(
+      TTF_OpenFont(filepath.c_str(), LABEL_FONT_SIZE));
+
+  if (!font || !labelFont) {
+    std::cerr << "SDL_Error occured: " << SDL_GetError() << "\n";
+    return false;
+  }
+
+  // Rasterize every glyph once, updates only copy pixels
+  out.weightGlyphs.emplace(font.get(), WEIGHT_CHARSET, TEXT_COLOR);
+  out.labelGlyphs.emplace(labelFont.get(), LABEL_CHARSET, TEXT_COLOR);
+  return true;
+}
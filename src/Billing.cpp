@@ -0,0 +1,210 @@
+#include "Billing.hpp"
+
+namespace {
+
+// Append an amount in minor units as "units.minor"
+char *appendAmount(char *cursor, char *end, int32_t amount) {
+  constexpr int32_t scale = 100; // 10^PRICE_DECIMALS
+
+  cursor = std::to_chars(cursor, end, amount / scale).ptr;
+  if (end - cursor < PRICE_DECIMALS + 1)
+    return cursor;
+
+  *cursor++ = '.';
+  *cursor++ = static_cast<char>('0' + (amount % scale) / 10);
+  *cursor++ = static_cast<char>('0' + amount % 10);
+  return cursor;
+}
+
+// Append text, truncated to what fits before end
+char *appendText(char *cursor, char *end, std::string_view text) {
+  std::size_t count =
+      std::min(text.size(), static_cast<std::size_t>(end - cursor));
+  std::memcpy(cursor, text.data(), count);
+  return cursor + count;
+}
+
+} // namespace
+
+Billing::Billing(const Tariff &tariff) { setTariff(tariff); }
+
+bool Billing::load(const char *filepath) {
+  Tariff loaded;
+  if (!loadTariff(filepath, loaded))
+    return false;
+
+  if (!setTariff(loaded))
+    return false;
+
+  std::cout << "[Billing] Tariff loaded, " << table.size() << " prices\n";
+  return true;
+}
+
+bool Billing::setTariff(const Tariff &newTariff) {
+  if (!validTariff(newTariff)) {
+    std::cerr << "[Billing] Invalid tariff, keeping the current one\n";
+    return false;
+  }
+
+  tariff = newTariff;
+  buildTable();
+  return true;
+}
+
+int32_t Billing::quote(const WeightReading &reading) const {
+  // Only a settled weight of at least one division is sold
+  if (!reading.valid() || !reading.stable || reading.net < tariff.division)
+    return NO_PRICE;
+
+  return priceOf(reading.net);
+}
+
+int32_t Billing::priceOf(int32_t grams) const {
+  if (grams < 0 || grams > MAX_WEIGHT || table.empty())
+    return NO_PRICE;
+
+  auto index = static_cast<std::size_t>(grams / tariff.division);
+  return index < table.size() ? table[index] : NO_PRICE;
+}
+
+const Tariff &Billing::getTariff() const { return tariff; }
+
+void Billing::buildTable() {
+  std::size_t size = static_cast<std::size_t>(MAX_WEIGHT / tariff.division) + 1;
+
+  table.resize(size);
+  for (std::size_t index = 0; index < size; ++index) {
+    table[index] = evaluate(static_cast<int32_t>(index) * tariff.division);
+  }
+}
+
+int32_t Billing::evaluate(int32_t grams) const {
+  if (grams <= 0)
+    return 0;
+
+  // Sum of grams times minor units per kilogram
+  int64_t total = 0;
+  int32_t lower = 0;
+
+  for (const TariffBracket &bracket : tariff.brackets) {
+    if (grams <= lower)
+      break;
+    int32_t upper = std::min(grams, bracket.upTo);
+    total += int64_t{upper - lower} * bracket.pricePerKg;
+    lower = bracket.upTo;
+  }
+  if (grams > lower)
+    total += int64_t{grams - lower} * tariff.pricePerKg;
+
+  // Grams to kilograms, half up
+  int64_t amount = (total + 500) / 1000;
+
+  // Nearest rounding step, half up
+  int64_t step = tariff.rounding;
+  amount = (amount + step / 2) / step * step;
+
+  amount = std::max<int64_t>(amount, tariff.minimumCharge);
+  return static_cast<int32_t>(std::min<int64_t>(amount, INT32_MAX));
+}
+
+bool loadTariff(const char *filepath, Tariff &out) {
+  Tariff tariff;
+
+  bool loaded = readSettings(
+      filepath, [&tariff](std::string_view key, std::string_view value) {
+        bool parsed = false;
+
+        if (key == "currency") {
+          tariff.currency = value;
+          return !value.empty();
+        } else if (key == "per_kg") {
+          parsed = parseSetting(value, tariff.pricePerKg);
+        } else if (key == "minimum") {
+          parsed = parseSetting(value, tariff.minimumCharge);
+        } else if (key == "rounding") {
+          parsed = parseSetting(value, tariff.rounding);
+        } else if (key == "division") {
+          parsed = parseSetting(value, tariff.division);
+        } else if (key == "bracket") {
+          TariffBracket bracket;
+          parsed = parseSetting(value, bracket.upTo) &&
+                   parseSetting(value, bracket.pricePerKg);
+          if (parsed)
+            tariff.brackets.push_back(bracket);
+        }
+
+        // Anything left over is a typo
+        return parsed && value.empty();
+      });
+
+  if (!loaded)
+    return false;
+
+  out = std::move(tariff);
+  return true;
+}
+
+bool validTariff(const Tariff &tariff) {
+  if (tariff.currency.empty() || tariff.pricePerKg < 0 ||
+      tariff.minimumCharge < 0 || tariff.rounding < 1 ||
+      tariff.division < 1 || tariff.division > MAX_WEIGHT ||
+      tariff.brackets.size() > MAX_TARIFF_BRACKETS)
+    return false;
+
+  int32_t previous = 0;
+  for (const TariffBracket &bracket : tariff.brackets) {
+    if (bracket.upTo <= previous || bracket.pricePerKg < 0)
+      return false;
+    previous = bracket.upTo;
+  }
+  return true;
+}
+
+std::size_t formatPrice(int32_t amount, std::string_view currency,
+                        char *buffer, std::size_t length) {
+  if (length == 0)
+    return 0;
+
+  if (amount < 0) {
+    buffer[0] = '\0';
+    return 0;
+  }
+
+  char *end = buffer + length - 1;
+  char *cursor = appendAmount(buffer, end, amount);
+  if (cursor < end)
+    *cursor++ = ' ';
+  cursor = appendText(cursor, end, currency);
+
+  *cursor = '\0';
+  return static_cast<std::size_t>(cursor - buffer);
+}
+
+std::size_t formatPayload(int32_t amount, std::string_view currency,
+                          int32_t net, char *buffer, std::size_t length) {
+  if (length == 0)
+    return 0;
+
+  if (amount < 0) {
+    buffer[0] = '\0';
+    return 0;
+  }
+
+  // A payload that reaches end left no room for the terminator, it was cut
+  char *end = buffer + length;
+  char *cursor = appendText(buffer, end, "PPW;amount=");
+  cursor = appendAmount(cursor, end, amount);
+  cursor = appendText(cursor, end, ";currency=");
+  cursor = appendText(cursor, end, currency);
+  cursor = appendText(cursor, end, ";net=");
+  cursor = std::to_chars(cursor, end, net).ptr;
+
+  // A cut payload could bill another amount, none is safer
+  if (cursor == end) {
+    buffer[0] = '\0';
+    return 0;
+  }
+
+  *cursor = '\0';
+  return static_cast<std::size_t>(cursor - buffer);
+}
@@ -0,0 +1,101 @@
+#include "ClockService.hpp"
+
+ClockService::ClockService(IoLoop &io) : io{io} {
+  timerFd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (timerFd < 0)
+    std::cout << "[Clock] timerfd failed, sleeping on the loop instead\n";
+
+  // Shown from the first frame, before the loop runs
+  format(0, std::chrono::system_clock::now());
+  publish(0);
+
+  run();
+}
+
+ClockService::~ClockService() {
+  // The coroutine reads the timer, end it first
+  io.shutdown();
+
+  if (timerFd >= 0)
+    close(timerFd);
+}
+
+std::string_view ClockService::label() const {
+  return labels[current.load(std::memory_order_acquire)].data();
+}
+
+Task ClockService::run() {
+  while (true) {
+    auto now = std::chrono::system_clock::now();
+    auto boundary = nextMinute(now);
+
+    // Ready before the boundary, publishing is one store
+    std::size_t next = (current.load(std::memory_order_relaxed) + 1) %
+                       TIME_LABEL_SLOTS;
+    format(next, boundary);
+
+    if (timerFd < 0 || !arm(boundary)) {
+      co_await io.sleepUntil(
+          std::chrono::steady_clock::now() +
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              boundary - now));
+      publish(next);
+      continue;
+    }
+
+    co_await io.readable(timerFd);
+
+    uint64_t expirations = 0;
+    if (read(timerFd, &expirations, sizeof(expirations)) < 0) {
+      // The wall clock was set, start over from the new time
+      if (errno == ECANCELED) {
+        std::cout << "[Clock] Wall clock changed\n";
+        format(next, std::chrono::system_clock::now());
+        publish(next);
+      }
+      continue;
+    }
+
+    publish(next);
+  }
+}
+
+bool ClockService::arm(std::chrono::system_clock::time_point at) {
+  auto seconds = std::chrono::floor<std::chrono::seconds>(at);
+
+  itimerspec spec{};
+  spec.it_value.tv_sec = static_cast<time_t>(seconds.time_since_epoch().count());
+  spec.it_value.tv_nsec = static_cast<long>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(at - seconds)
+          .count());
+
+  if (timerfd_settime(timerFd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET,
+                      &spec, nullptr) < 0) {
+    std::cout << "[Clock] Timer not armed\n";
+    return false;
+  }
+  return true;
+}
+
+void ClockService::format(std::size_t slot,
+                          std::chrono::system_clock::time_point at) {
+  formatClock(at, labels[slot].data(), labels[slot].size());
+}
+
+void ClockService::publish(std::size_t slot) {
+  current.store(slot, std::memory_order_release);
+}
+
+std::chrono::system_clock::time_point
+nextMinute(std::chrono::system_clock::time_point at) {
+  return std::chrono::floor<std::chrono::minutes>(at) + std::chrono::minutes(1);
+}
+
+std::size_t formatClock(std::chrono::system_clock::time_point at,
+                        char *buffer, std::size_t length) {
+  std::time_t t = std::chrono::system_clock::to_time_t(at);
+  std::tm tm{};
+  localtime_r(&t, &tm);
+
+  return std::strftime(buffer, length, TIME_FORMAT, &tm);
+}
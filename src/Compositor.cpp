@@ -0,0 +1,208 @@
+#include "Compositor.hpp"
+
+#include <cstring>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Rounded (c * a + d * (255 - a)) / 255 of one channel.
+ */
+inline uint32_t blendChannel(uint32_t c, uint32_t d, uint32_t a) {
+  uint32_t t = c * a + d * (255 - a) + 128;
+  return (t + (t >> 8)) >> 8;
+}
+
+inline uint32_t blendPixel(uint32_t color, uint32_t pixel, uint32_t a) {
+  if (a == 0)
+    return pixel;
+  if (a == 255)
+    return color;
+
+  uint32_t out = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    uint32_t c = (color >> shift) & 0xFF;
+    uint32_t d = (pixel >> shift) & 0xFF;
+    out |= blendChannel(c, d, a) << shift;
+  }
+  return out;
+}
+
+inline void blendRowScalar(uint32_t *dst, const uint8_t *mask, int width,
+                           uint32_t color) {
+  for (int x = 0; x < width; ++x) {
+    dst[x] = blendPixel(color, dst[x], mask[x]);
+  }
+}
+
+#if defined(__ARM_NEON)
+
+void blendRow(uint32_t *dst, const uint8_t *mask, int width, uint32_t color) {
+  const uint8x8_t c0 = vdup_n_u8(color & 0xFF);
+  const uint8x8_t c1 = vdup_n_u8((color >> 8) & 0xFF);
+  const uint8x8_t c2 = vdup_n_u8((color >> 16) & 0xFF);
+  const uint8x8_t c3 = vdup_n_u8(color >> 24);
+
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    uint8x8_t a = vld1_u8(mask + x);
+    if (vget_lane_u64(vreinterpret_u64_u8(a), 0) == 0)
+      continue;
+
+    uint8x8_t inv = vmvn_u8(a);
+    uint8x8x4_t px = vld4_u8(reinterpret_cast<uint8_t *>(dst + x));
+
+    // (t + ((t + 128) >> 8) + 128) >> 8 is the rounded t / 255
+    uint16x8_t t0 = vmlal_u8(vmull_u8(c0, a), px.val[0], inv);
+    uint16x8_t t1 = vmlal_u8(vmull_u8(c1, a), px.val[1], inv);
+    uint16x8_t t2 = vmlal_u8(vmull_u8(c2, a), px.val[2], inv);
+    uint16x8_t t3 = vmlal_u8(vmull_u8(c3, a), px.val[3], inv);
+    px.val[0] = vraddhn_u16(t0, vrshrq_n_u16(t0, 8));
+    px.val[1] = vraddhn_u16(t1, vrshrq_n_u16(t1, 8));
+    px.val[2] = vraddhn_u16(t2, vrshrq_n_u16(t2, 8));
+    px.val[3] = vraddhn_u16(t3, vrshrq_n_u16(t3, 8));
+
+    vst4_u8(reinterpret_cast<uint8_t *>(dst + x), px);
+  }
+
+  blendRowScalar(dst + x, mask + x, width - x, color);
+}
+
+constexpr const char *KERNEL_NAME = "NEON";
+
+#elif defined(__AVX2__)
+
+void blendRow(uint32_t *dst, const uint8_t *mask, int width, uint32_t color) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i full = _mm256_set1_epi16(255);
+  const __m256i round = _mm256_set1_epi16(128);
+  const __m256i replicate = _mm256_set1_epi32(0x01010101);
+  const __m256i c16 =
+      _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(color)), zero);
+
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    uint64_t bits;
+    std::memcpy(&bits, mask + x, sizeof(bits));
+    if (bits == 0)
+      continue;
+
+    // Coverage of each pixel copied into all four of its bytes
+    __m128i packed = _mm_cvtsi64_si128(static_cast<long long>(bits));
+    __m256i a = _mm256_mullo_epi32(_mm256_cvtepu8_epi32(packed), replicate);
+
+    __m256i *p = reinterpret_cast<__m256i *>(dst + x);
+    __m256i d = _mm256_loadu_si256(p);
+
+    __m256i aLo = _mm256_unpacklo_epi8(a, zero);
+    __m256i aHi = _mm256_unpackhi_epi8(a, zero);
+    __m256i dLo = _mm256_unpacklo_epi8(d, zero);
+    __m256i dHi = _mm256_unpackhi_epi8(d, zero);
+
+    __m256i tLo = _mm256_add_epi16(
+        _mm256_add_epi16(_mm256_mullo_epi16(c16, aLo),
+                         _mm256_mullo_epi16(dLo, _mm256_sub_epi16(full, aLo))),
+        round);
+    __m256i tHi = _mm256_add_epi16(
+        _mm256_add_epi16(_mm256_mullo_epi16(c16, aHi),
+                         _mm256_mullo_epi16(dHi, _mm256_sub_epi16(full, aHi))),
+        round);
+    tLo = _mm256_add_epi16(tLo, _mm256_srli_epi16(tLo, 8));
+    tHi = _mm256_add_epi16(tHi, _mm256_srli_epi16(tHi, 8));
+    tLo = _mm256_srli_epi16(tLo, 8);
+    tHi = _mm256_srli_epi16(tHi, 8);
+
+    _mm256_storeu_si256(p, _mm256_packus_epi16(tLo, tHi));
+  }
+
+  blendRowScalar(dst + x, mask + x, width - x, color);
+}
+
+constexpr const char *KERNEL_NAME = "AVX2";
+
+#elif defined(__SSE2__)
+
+void blendRow(uint32_t *dst, const uint8_t *mask, int width, uint32_t color) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i full = _mm_set1_epi16(255);
+  const __m128i round = _mm_set1_epi16(128);
+  const __m128i c16 =
+      _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero);
+
+  int x = 0;
+  for (; x + 4 <= width; x += 4) {
+    uint32_t bits;
+    std::memcpy(&bits, mask + x, sizeof(bits));
+    if (bits == 0)
+      continue;
+
+    // Coverage of each pixel copied into all four of its bytes
+    __m128i a = _mm_cvtsi32_si128(static_cast<int>(bits));
+    a = _mm_unpacklo_epi8(a, a);
+    a = _mm_unpacklo_epi16(a, a);
+
+    __m128i *p = reinterpret_cast<__m128i *>(dst + x);
+    __m128i d = _mm_loadu_si128(p);
+
+    __m128i aLo = _mm_unpacklo_epi8(a, zero);
+    __m128i aHi = _mm_unpackhi_epi8(a, zero);
+    __m128i dLo = _mm_unpacklo_epi8(d, zero);
+    __m128i dHi = _mm_unpackhi_epi8(d, zero);
+
+    __m128i tLo = _mm_add_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(c16, aLo),
+                      _mm_mullo_epi16(dLo, _mm_sub_epi16(full, aLo))),
+        round);
+    __m128i tHi = _mm_add_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(c16, aHi),
+                      _mm_mullo_epi16(dHi, _mm_sub_epi16(full, aHi))),
+        round);
+    tLo = _mm_srli_epi16(_mm_add_epi16(tLo, _mm_srli_epi16(tLo, 8)), 8);
+    tHi = _mm_srli_epi16(_mm_add_epi16(tHi, _mm_srli_epi16(tHi, 8)), 8);
+
+    _mm_storeu_si128(p, _mm_packus_epi16(tLo, tHi));
+  }
+
+  blendRowScalar(dst + x, mask + x, width - x, color);
+}
+
+constexpr const char *KERNEL_NAME = "SSE2";
+
+#else
+
+void blendRow(uint32_t *dst, const uint8_t *mask, int width, uint32_t color) {
+  blendRowScalar(dst, mask, width, color);
+}
+
+constexpr const char *KERNEL_NAME = "scalar";
+
+#endif
+
+} // namespace
+
+void blendMask(uint32_t *dst, int dstPitch, const uint8_t *mask,
+               int maskPitch, int width, int height, uint32_t color) {
+  color |= OPAQUE;
+  auto *row = reinterpret_cast<uint8_t *>(dst);
+  for (int y = 0; y < height; ++y) {
+    blendRow(reinterpret_cast<uint32_t *>(row + y * dstPitch),
+             mask + y * maskPitch, width, color);
+  }
+}
+
+void blendMaskScalar(uint32_t *dst, int dstPitch, const uint8_t *mask,
+                     int maskPitch, int width, int height, uint32_t color) {
+  color |= OPAQUE;
+  auto *row = reinterpret_cast<uint8_t *>(dst);
+  for (int y = 0; y < height; ++y) {
+    blendRowScalar(reinterpret_cast<uint32_t *>(row + y * dstPitch),
+                   mask + y * maskPitch, width, color);
+  }
+}
+
+const char *getCompositorName() { return KERNEL_NAME; }
@@ -0,0 +1,245 @@
+#include "Config.hpp"
+
+namespace {
+
+bool parseMilliseconds(std::string_view value, std::chrono::milliseconds &out) {
+  int32_t ms = 0;
+  if (!parseSetting(value, ms) || !value.empty() || ms < 0)
+    return false;
+  out = std::chrono::milliseconds(ms);
+  return true;
+}
+
+bool parseFlag(std::string_view value, bool &out) {
+  int32_t flag = 0;
+  if (!parseSetting(value, flag) || !value.empty() || (flag != 0 && flag != 1))
+    return false;
+  out = flag == 1;
+  return true;
+}
+
+bool parseUnit(std::string_view value, WeightUnit &out) {
+  if (value == "g")
+    out = WeightUnit::GRAM;
+  else if (value == "kg")
+    out = WeightUnit::KILOGRAM;
+  else if (value == "lb")
+    out = WeightUnit::POUND;
+  else
+    return false;
+  return true;
+}
+
+bool parseRounding(std::string_view value, WeightRounding &out) {
+  if (value == "nearest")
+    out = WeightRounding::NEAREST;
+  else if (value == "down")
+    out = WeightRounding::DOWN;
+  else
+    return false;
+  return true;
+}
+
+} // namespace
+
+bool readSettings(const char *filepath, const SettingHandler &handler) {
+  std::ifstream file(filepath);
+  if (!file) {
+    std::cerr << "[Config] Could not open " << filepath << "\n";
+    return false;
+  }
+
+  std::string line;
+  int lineNumber = 0;
+
+  while (std::getline(file, line)) {
+    ++lineNumber;
+
+    std::string_view text(line);
+    text = trimSetting(text.substr(0, text.find('#')));
+    if (text.empty())
+      continue;
+
+    std::size_t equals = text.find('=');
+    if (equals == std::string_view::npos) {
+      std::cerr << "[Config] " << filepath << ":" << lineNumber
+                << " expected key = value\n";
+      return false;
+    }
+
+    std::string_view key = trimSetting(text.substr(0, equals));
+    std::string_view value = trimSetting(text.substr(equals + 1));
+
+    if (!handler(key, value)) {
+      std::cerr << "[Config] " << filepath << ":" << lineNumber
+                << " invalid setting " << key << "\n";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool loadConfig(const char *filepath, AppConfig &out) {
+  AppConfig config;
+
+  bool loaded = readSettings(
+      filepath, [&config](std::string_view key, std::string_view value) {
+        if (value.empty())
+          return false;
+
+        if (key == "port") {
+          config.port = value;
+        } else if (key == "baud") {
+          return parseSetting(value, config.baud) && value.empty() &&
+                 config.baud > 0;
+        } else if (key == "logo") {
+          config.logo = value;
+        } else if (key == "image") {
+          config.image = value;
+        } else if (key == "font") {
+          config.font = value;
+        } else if (key == "tariff") {
+          config.tariff = value;
+        } else if (key == "dim_after") {
+          return parseSetting(value, config.dimAfter) && value.empty() &&
+                 config.dimAfter >= 0;
+        } else if (key == "blank_after") {
+          return parseSetting(value, config.blankAfter) && value.empty() &&
+                 config.blankAfter >= 0;
+        } else if (key == "frame_deadline") {
+          return parseMilliseconds(value, config.frameDeadline);
+        } else if (key == "serial_deadline") {
+          return parseMilliseconds(value, config.serialDeadline);
+        } else if (key == "watchdog_restart") {
+          return parseFlag(value, config.watchdogRestart);
+        } else if (key == "mirror_fps") {
+          return parseSetting(value, config.mirrorFps) && value.empty() &&
+                 config.mirrorFps >= 0 && config.mirrorFps <= MAX_MIRROR_FPS;
+        } else if (key == "vibration_filter") {
+          return parseFlag(value, config.vibrationFilter);
+        } else if (key == "unit") {
+          return parseUnit(value, config.unit);
+        } else if (key == "division") {
+          return parseSetting(value, config.division) && value.empty() &&
+                 config.division > 0 && config.division <= MAX_WEIGHT;
+        } else if (key == "rounding") {
+          return parseRounding(value, config.rounding);
+        } else if (key == "keymap") {
+          config.keymap = value;
+          return validKeymap(value);
+        } else if (key == "playlist") {
+          config.playlist = value;
+        } else if (key == "playlist_after") {
+          return parseSetting(value, config.playlistAfter) && value.empty() &&
+                 config.playlistAfter >= 0;
+        } else if (key == "playlist_seconds") {
+          return parseSetting(value, config.playlistSeconds) &&
+                 value.empty() && config.playlistSeconds > 0;
+        } else if (key == "playlist_fps") {
+          return parseSetting(value, config.playlistFps) && value.empty() &&
+                 config.playlistFps > 0 &&
+                 config.playlistFps <= MAX_PLAYLIST_FPS;
+        } else if (key == "adaptive_quality") {
+          return parseFlag(value, config.adaptiveQuality);
+        } else if (key == "sysfs_root") {
+          config.sysfsRoot = value;
+        } else if (key == "operator_display") {
+          return parseSetting(value, config.operatorDisplay) &&
+                 value.empty() && config.operatorDisplay >= OPERATOR_OFF;
+        } else if (key == "operator_fps") {
+          return parseSetting(value, config.operatorFps) && value.empty() &&
+                 config.operatorFps > 0 &&
+                 config.operatorFps <= MAX_OPERATOR_FPS;
+        } else if (key == "api_port") {
+          return parseSetting(value, config.apiPort) && value.empty() &&
+                 config.apiPort >= 0 && config.apiPort <= 65535;
+        } else if (key == "api_address") {
+          in_addr address{};
+          config.apiAddress = value;
+          return inet_pton(AF_INET, config.apiAddress.c_str(), &address) == 1;
+        } else {
+          return false;
+        }
+        return true;
+      });
+
+  if (!loaded)
+    return false;
+
+  out = std::move(config);
+  return true;
+}
+
+bool readKeymap(std::string_view keymap, const KeyBindingHandler &handler) {
+  while (!keymap.empty()) {
+    std::size_t comma = keymap.find(',');
+    std::string_view entry = trimSetting(keymap.substr(0, comma));
+    keymap = comma == std::string_view::npos ? std::string_view{}
+                                             : keymap.substr(comma + 1);
+    if (entry.empty())
+      continue;
+
+    std::size_t colon = entry.rfind(':');
+    if (colon == std::string_view::npos || colon == 0 ||
+        !handler(trimSetting(entry.substr(0, colon)),
+                 trimSetting(entry.substr(colon + 1)))) {
+      std::cerr << "[Config] Invalid key binding " << entry << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool validKeymap(std::string_view keymap) {
+  std::size_t count = 0;
+  return readKeymap(keymap, [&count](std::string_view key,
+                                     std::string_view action) {
+    if (++count > MAX_KEY_BINDINGS)
+      return false;
+    if (action != "toggle" && action != "tare" && action != "quit")
+      return false;
+
+    // One character is its own key, longer names are SDL scancode names
+    std::string name(key);
+    return name.size() == 1 ||
+           SDL_GetScancodeFromName(name.c_str()) != SDL_SCANCODE_UNKNOWN;
+  });
+}
+
+WeightConfig toWeightConfig(const AppConfig &config) {
+  WeightConfig weight;
+  weight.unit = config.unit;
+  weight.division = config.division;
+  weight.rounding = config.rounding;
+  return weight;
+}
+
+std::string assetPath(std::string_view relative) {
+  if (!relative.empty() && relative.front() == '/')
+    return std::string(relative);
+
+  std::string path(ASSET_ROOT);
+  path += '/';
+  path += relative;
+  return path;
+}
+
+std::string_view trimSetting(std::string_view text) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+    text.remove_prefix(1);
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t' ||
+                           text.back() == '\r'))
+    text.remove_suffix(1);
+  return text;
+}
+
+bool parseSetting(std::string_view &text, int32_t &out) {
+  text = trimSetting(text);
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+  if (ec != std::errc{})
+    return false;
+  text.remove_prefix(static_cast<std::size_t>(ptr - text.data()));
+  text = trimSetting(text);
+  return true;
+}
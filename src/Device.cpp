@@ -1,99 +1,355 @@
 #include "Device.hpp"
 
-Device::Device() : state{true} {
-  if (!connectToPort()) {
-    std::cout << "[Device] Port connection failed\n";
+namespace {
+
+// termios speed of a baud rate, 9600 if unsupported
+speed_t toSpeed(int32_t baud) {
+  switch (baud) {
+  case 1200:
+    return B1200;
+  case 2400:
+    return B2400;
+  case 4800:
+    return B4800;
+  case 19200:
+    return B19200;
+  case 38400:
+    return B38400;
+  case 57600:
+    return B57600;
+  case 115200:
+    return B115200;
+  default:
+    return B9600;
   }
+}
+
+} // namespace
+
+Device::Device(IoLoop &io, const AppConfig &config)
+    : io{io}, port{config.port}, baud{config.baud}, state{true} {
+  // Wakes the reader when the port settings change
+  reopenFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (reopenFd < 0) {
+    std::cout << "[Device] Reopen descriptor failed\n";
+  }
+
+  // Wakes the reader when the port reappears, backoff still works without
+  hotplugFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (hotplugFd < 0) {
+    std::cout << "[Device] Hotplug descriptor failed\n";
+  }
+
+  vibration.setEnabled(config.vibrationFilter);
+  pipeline.configure(toWeightConfig(config));
 
-  // Start working threads
-  workers.emplace_back(&Device::pollWeight, this);
-  workers.emplace_back(&Device::pollTime, this);
+  // Runs until its first wait, then continues on the loop thread
+  readFromSerial();
 }
 Device::~Device() {
 
-  // End sessions
-  state = false;
+  // End sessions, the reader is destroyed before its descriptors
+  stop();
+  io.shutdown();
 
-  close(fd);
+  if (fd >= 0)
+    close(fd);
+  if (reopenFd >= 0)
+    close(reopenFd);
+  if (hotplugFd >= 0)
+    close(hotplugFd);
 
-  // Join all threads
-  for (auto &thread : workers) {
-    if (thread.joinable()) {
-      thread.join();
-    }
+  std::cout << "[Device] Stopped" << std::endl;
+}
+
+void Device::stop() {
+  if (!state.exchange(false))
+    return;
+
+  io.stop();
+}
+
+void Device::setPort(const std::string &newPort, int32_t newBaud) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (newPort == port && newBaud == baud)
+      return;
+    port = newPort;
+    baud = newBaud;
+  }
+
+  uint64_t one = 1;
+  if (reopenFd >= 0 && write(reopenFd, &one, sizeof(one)) < 0) {
+    std::cout << "[Device] Reopen signal failed\n";
   }
 }
 
-void Device::pollWeight() { readFromSerial(); }
-void Device::pollTime() { setTime(); }
+WeightReading Device::getReading() {
+  auto now = std::chrono::steady_clock::now();
 
-uint16_t Device::getWeight() { return weight; }
-std::string_view Device::getTimepoint() const { return timepoint; }
+  std::lock_guard<std::mutex> lock(mutex);
+  WeightReading current = reading;
+  current.stale = linkState(now) != LinkState::ONLINE;
+  return current;
+}
 
-uint16_t Device::convertWeight() {
-  weight = std::stoi(incomingWeight);
-  return weight;
+LinkStatus Device::getLinkStatus() {
+  auto now = std::chrono::steady_clock::now();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  LinkStatus status = link;
+  status.state = linkState(now);
+  if (status.state != LinkState::ONLINE)
+    status.frameRate = 0;
+  return status;
 }
 
-void Device::readFromSerial() {
+void Device::tare() { pipeline.requestTare(); }
 
-  char c;
-  while (state.load()) {
-    int bytes = read(fd, &c, 1);
+void Device::setVibrationFilter(bool enabled) {
+  vibration.setEnabled(enabled);
+}
 
-    if (bytes <= 0)
-      break;
+void Device::setWeightConfig(const WeightConfig &config) {
+  // Samples are processed under the mutex, never half configured
+  std::lock_guard<std::mutex> lock(mutex);
+  pipeline.configure(config);
+}
 
-    std::lock_guard<std::mutex> lock(mutex);
+void Device::setHeartbeat(Heartbeat *beat) { heartbeat = beat; }
+
+void Device::copyTrend(TrendSeries &out) {
+  std::lock_guard<std::mutex> lock(mutex);
+  trend.copy(out, std::chrono::steady_clock::now());
+}
+
+bool Device::convertWeight() {
+  int32_t raw = 0;
+  const char *begin = incomingWeight.data();
+  const char *end = begin + incomingWeight.size();
+
+  // Indicators may pad or sign the value
+  while (begin != end && (*begin == ' ' || *begin == '+'))
+    ++begin;
+
+  auto [ptr, ec] = std::from_chars(begin, end, raw);
+  if (ec != std::errc{} || ptr != end)
+    return false;
+
+  auto now = std::chrono::steady_clock::now();
+
+  // Vibration is gone before motion detection looks at the sample
+  reading = pipeline.process(vibration.filter(raw, now));
+  trend.push(reading.net, now);
+  countFrame(now);
+  return true;
+}
+
+void Device::countFrame(std::chrono::steady_clock::time_point now) {
+  ++link.frames;
+  ++windowFrames;
+  lastFrame = now;
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      now - windowStart);
+  if (elapsed >= std::chrono::seconds(1)) {
+    link.frameRate = static_cast<uint32_t>(windowFrames * 1000 /
+                                           elapsed.count());
+    windowFrames = 0;
+    windowStart = now;
+  }
+}
+
+LinkState Device::linkState(std::chrono::steady_clock::time_point now) const {
+  if (!connected)
+    return LinkState::DISCONNECTED;
+  if (now - lastFrame > LINK_STALE_AFTER)
+    return LinkState::SILENT;
+  return LinkState::ONLINE;
+}
+
+Task Device::readFromSerial() {
 
-    // Clear on end of line
-    if (c == '\n' || c == '\r') {
-      // Convert to int
-      if (!incomingWeight.empty()) {
-        convertWeight();
+  char buffer[BUFFER_LENGTH];
+  auto retryDelay = RECONNECT_MIN_DELAY;
+  auto retryAt = std::chrono::steady_clock::now();
+
+  watchPortDirectory();
+
+  // Runs until the loop shuts down and destroys the frame
+  while (true) {
+    auto now = std::chrono::steady_clock::now();
+
+    if (fd < 0 && now >= retryAt) {
+      if (connectToPort()) {
+        retryDelay = RECONNECT_MIN_DELAY;
+      } else {
+        retryAt = now + retryDelay;
+        retryDelay = std::min(retryDelay * 2, RECONNECT_MAX_DELAY);
+      }
+    }
+
+    // Sleep until the next attempt, or until the link has been silent long
+    // enough to reopen it
+    auto deadline = fd < 0 ? retryAt
+                           : std::max(lastFrame, connectedAt) +
+                                 LINK_REOPEN_AFTER;
+
+    // A closed port (fd < 0) is skipped by the loop. The awaiter is built
+    // outside co_await, GCC 12 cannot keep a braced list across a suspension
+    auto ready = io.wait(
+        {{fd, EPOLLIN}, {reopenFd, EPOLLIN}, {hotplugFd, EPOLLIN}}, deadline);
+    IoEvent event = co_await ready;
+    now = std::chrono::steady_clock::now();
+    if (heartbeat)
+      heartbeat->beat();
+
+    if (event.index == 1) {
+      uint64_t signals = 0;
+      if (read(reopenFd, &signals, sizeof(signals)) < 0 && errno != EAGAIN)
+        std::cout << "[Device] Reopen signal lost\n";
+
+      closePort("Port settings changed");
+      watchPortDirectory();
+      retryAt = now;
+      retryDelay = RECONNECT_MIN_DELAY;
+      continue;
+    }
+
+    if (event.index == 2) {
+      // udev creates the node, then sets its permissions, retry on both
+      if (portAppeared() && fd < 0) {
+        std::cout << "[Device] Port appeared\n";
+        retryAt = now;
+        retryDelay = RECONNECT_MIN_DELAY;
+      }
+      continue;
+    }
+
+    if (event.timedOut()) {
+      if (fd >= 0) {
+        closePort("Port silent, reopening");
+        retryAt = now;
+      }
+      continue;
+    }
+
+    if (event.events & (EPOLLERR | EPOLLHUP)) {
+      closePort("Port lost");
+      retryAt = now + retryDelay;
+      continue;
+    }
+
+    ssize_t bytes = read(fd, buffer, sizeof(buffer));
+
+    if (bytes < 0 && (errno == EINTR || errno == EAGAIN))
+      continue;
+
+    // Readable but empty means the adapter went away
+    if (bytes <= 0) {
+      closePort("Port lost");
+      retryAt = now + retryDelay;
+      continue;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    AllocationGuard parsing; // Steady state, parsing must not allocate
+
+    for (ssize_t i = 0; i < bytes; ++i) {
+      char c = buffer[i];
+
+      // Clear on end of line
+      if (c == '\n' || c == '\r') {
+        // Convert to int
+        if (!incomingWeight.empty()) {
+          if (!convertWeight())
+            ++link.errors;
+          incomingWeight.clear();
+        }
+      } else if (!incomingWeight.push_back(c)) {
+        // Noise without line ends, start over
+        ++link.errors;
         incomingWeight.clear();
       }
-    } else {
-      incomingWeight += c;
     }
   }
 }
 
-void Device::setTime() {
-  while (state.load()) {
+void Device::closePort(const char *reason) {
+  if (fd < 0)
+    return;
 
-    // Used for measuring clock updates
-    auto now = std::chrono::system_clock::now();
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
+  io.forget(fd);
+  close(fd);
+  fd = -1;
 
-    {
-      // Aquire lock for updates.
-      std::tm tm{};
-      localtime_r(&t, &tm);
-      std::lock_guard<std::mutex> lock(mutex);
-      std::strftime(std::data(timeString), std::size(timeString),
-                    "%d/%m-%y %H:%M", &tm);
+  std::lock_guard<std::mutex> lock(mutex);
+  connected = false;
+  // A line cut by the close is not a weight
+  incomingWeight.clear();
 
-      timepoint = timeString;
-    }
+  std::cout << "[Device] " << reason << "\n";
+}
 
-    // Align to next real-world minute
-    auto nextMinute = std::chrono::time_point_cast<std::chrono::minutes>(now) +
-                      std::chrono::minutes(1);
+void Device::watchPortDirectory() {
+  if (hotplugFd < 0)
+    return;
 
-    std::cout << "[Device] " << timeString << "\n";
+  if (hotplugWatch >= 0) {
+    inotify_rm_watch(hotplugFd, hotplugWatch);
+    hotplugWatch = -1;
+  }
 
-    // Shorten the sleep if needed. (shutdown)
-    while (state.load() && std::chrono::system_clock::now() < nextMinute) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    path = port;
+  }
+
+  std::size_t slash = path.rfind('/');
+  std::string directory = slash == std::string::npos || slash == 0
+                              ? std::string(slash == 0 ? "/" : ".")
+                              : path.substr(0, slash);
+  portName = path.substr(slash == std::string::npos ? 0 : slash + 1);
+
+  hotplugWatch = inotify_add_watch(hotplugFd, directory.c_str(),
+                                   IN_CREATE | IN_ATTRIB | IN_MOVED_TO);
+  if (hotplugWatch < 0) {
+    std::cout << "[Device] Could not watch " << directory
+              << ", reconnecting by backoff only\n";
+  }
+}
+
+bool Device::portAppeared() {
+  alignas(inotify_event) char events[1024];
+  bool appeared = false;
+
+  while (true) {
+    ssize_t bytes = read(hotplugFd, events, sizeof(events));
+    if (bytes <= 0)
+      return appeared;
+
+    for (char *cursor = events; cursor < events + bytes;) {
+      const auto *event = reinterpret_cast<const inotify_event *>(cursor);
+      cursor += sizeof(inotify_event) + event->len;
+
+      if (event->len > 0 && portName == event->name)
+        appeared = true;
     }
   }
 }
 
 bool Device::connectToPort() {
+  std::string path;
+  int32_t rate = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    path = port;
+    rate = baud;
+  }
 
   // Open port before configuration
-  fd = open(PORT_A, O_RDWR | O_NOCTTY);
+  fd = open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
   if (fd < 0) {
     std::cout << "[Device] Port opening failed\n";
     return false;
@@ -102,22 +358,36 @@ bool Device::connectToPort() {
 
   if (tcgetattr(fd, &pts) != 0) {
     std::cout << "[Device] Existing settings not read\n";
+    close(fd);
+    fd = -1;
     return false;
   }
   // Terminal confiuration instance
-  configureSerial(pts, 9600);
+  configureSerial(pts, rate);
 
   if (tcsetattr(fd, TCSANOW, &pts) != 0) {
-    std::cout << "[Device] Saving new setting not successful";
+    std::cout << "[Device] Saving new setting not successful\n";
+    close(fd);
+    fd = -1;
     return false;
   }
 
-  std::cout << "[Device] " << PORT_A << " is open." << "\n";
+  std::cout << "[Device] " << path << " is open." << "\n";
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto now = std::chrono::steady_clock::now();
+  if (wasConnected)
+    ++link.reconnects;
+  wasConnected = true;
+  connected = true;
+  connectedAt = now;
+  windowStart = now;
+  windowFrames = 0;
 
   return true;
 }
 
-void Device::configureSerial(termios &settings, int baud) {
+void Device::configureSerial(termios &settings, int32_t rate) {
   // Control modes (how the data is packed)
   // Bit clearing (off)
   settings.c_cflag &= ~(PARENB | CSIZE | CRTSCTS);
@@ -142,6 +412,6 @@ void Device::configureSerial(termios &settings, int baud) {
   settings.c_cc[VTIME] = 10;
   settings.c_cc[VMIN] = 0;
 
-  cfsetispeed(&settings, baud);
-  cfsetospeed(&settings, baud);
+  cfsetispeed(&settings, toSpeed(rate));
+  cfsetospeed(&settings, toSpeed(rate));
 }
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "FrameMirror.hpp"
+
+namespace {
+
+int64_t monotonicNs() {
+  timespec now{};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// Slots start on a cache line, pixels directly after the slot header
+std::size_t slotStride(int pitch, int height) {
+  std::size_t bytes = MIRROR_SLOT_HEADER + static_cast<std::size_t>(pitch) *
+                                               static_cast<std::size_t>(height);
+  return (bytes + 63) & ~static_cast<std::size_t>(63);
+}
+
+constexpr std::size_t HEADER_SIZE =
+    (sizeof(MirrorHeader) + 63) & ~static_cast<std::size_t>(63);
+
+} // namespace
+
+FrameMirror::~FrameMirror() { close(); }
+
+bool FrameMirror::open(int width, int height, const char *name) {
+  close();
+  if (width <= 0 || height <= 0)
+    return false;
+
+  int pitch = width * 4;
+  std::size_t stride = slotStride(pitch, height);
+  std::size_t bytes = HEADER_SIZE + stride * MIRROR_SLOTS;
+
+  // A new object each run, readers of the old one keep their mapping
+  shm_unlink(name);
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (fd < 0 || ftruncate(fd, static_cast<off_t>(bytes)) < 0) {
+    std::cout << "[Mirror] " << name
+              << " could not be created: " << std::strerror(errno) << "\n";
+    if (fd >= 0) {
+      ::close(fd);
+      shm_unlink(name);
+    }
+    return false;
+  }
+
+  void *memory =
+      mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED) {
+    std::cout << "[Mirror] " << name
+              << " could not be mapped: " << std::strerror(errno) << "\n";
+    shm_unlink(name);
+    return false;
+  }
+
+  this->name = name;
+  mapping = memory;
+  size = bytes;
+  frame = 0;
+
+  // ftruncate zeroed it, every slot sequence is 0
+  header = new (mapping) MirrorHeader{};
+  header->version = MIRROR_VERSION;
+  header->width = width;
+  header->height = height;
+  header->pitch = pitch;
+  header->slots = MIRROR_SLOTS;
+  header->slotOffset = HEADER_SIZE;
+  header->slotStride = stride;
+  header->latest.store(0, std::memory_order_relaxed);
+  for (uint64_t slot = 0; slot < MIRROR_SLOTS; ++slot)
+    new (slotOf(slot)) MirrorSlot{};
+
+  // Readers check the magic last
+  std::atomic_thread_fence(std::memory_order_release);
+  header->magic = MIRROR_MAGIC;
+
+  std::cout << "[Mirror] Publishing " << width << "x" << height
+            << " frames at /dev/shm" << name << "\n";
+  return true;
+}
+
+void FrameMirror::close() {
+  if (!mapping)
+    return;
+
+  munmap(mapping, size);
+  shm_unlink(name.c_str());
+  mapping = nullptr;
+  header = nullptr;
+  size = 0;
+}
+
+bool FrameMirror::isOpen() const { return mapping != nullptr; }
+
+void *FrameMirror::begin() {
+  if (!header)
+    return nullptr;
+
+  MirrorSlot *slot = slotOf(++frame);
+
+  // Odd while written, a reader in the middle of it retries
+  uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+  slot->sequence.store(sequence | 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  return reinterpret_cast<std::byte *>(slot) + MIRROR_SLOT_HEADER;
+}
+
+void FrameMirror::commit(const MirrorRect &dirty) {
+  if (!header)
+    return;
+
+  MirrorSlot *slot = slotOf(frame);
+  slot->frame = frame;
+  slot->timestampNs = monotonicNs();
+  slot->dirty = dirty;
+
+  uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+  slot->sequence.store(sequence + 1, std::memory_order_release);
+  header->latest.store(frame, std::memory_order_release);
+}
+
+void FrameMirror::cancel() {
+  if (!header)
+    return;
+
+  // Back to never written, the frame number is skipped
+  slotOf(frame)->sequence.store(0, std::memory_order_release);
+}
+
+int FrameMirror::getPitch() const { return header ? header->pitch : 0; }
+
+MirrorSlot *FrameMirror::slotOf(uint64_t frame) const {
+  return reinterpret_cast<MirrorSlot *>(
+      reinterpret_cast<std::byte *>(mapping) + header->slotOffset +
+      (frame % header->slots) * header->slotStride);
+}
+
+FrameMirrorReader::~FrameMirrorReader() {
+  if (mapping)
+    munmap(const_cast<void *>(mapping), size);
+}
+
+bool FrameMirrorReader::open(const char *name) {
+  int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+  if (fd < 0)
+    return false;
+
+  struct stat info {};
+  if (fstat(fd, &info) < 0 ||
+      static_cast<std::size_t>(info.st_size) < HEADER_SIZE) {
+    ::close(fd);
+    return false;
+  }
+
+  void *memory = mmap(nullptr, static_cast<std::size_t>(info.st_size),
+                      PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED)
+    return false;
+
+  const auto *candidate = static_cast<const MirrorHeader *>(memory);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  std::size_t needed = candidate->slotOffset +
+                       candidate->slotStride * candidate->slots;
+  if (candidate->magic != MIRROR_MAGIC ||
+      candidate->version != MIRROR_VERSION || candidate->slots == 0 ||
+      needed > static_cast<std::size_t>(info.st_size)) {
+    munmap(memory, static_cast<std::size_t>(info.st_size));
+    return false;
+  }
+
+  mapping = memory;
+  size = static_cast<std::size_t>(info.st_size);
+  header = candidate;
+  return true;
+}
+
+const MirrorHeader *FrameMirrorReader::getHeader() const { return header; }
+
+const MirrorSlot *FrameMirrorReader::latest(uint64_t &sequence) const {
+  if (!header)
+    return nullptr;
+
+  uint64_t frame = header->latest.load(std::memory_order_acquire);
+  if (frame == 0)
+    return nullptr;
+
+  const auto *slot = reinterpret_cast<const MirrorSlot *>(
+      static_cast<const std::byte *>(mapping) + header->slotOffset +
+      (frame % header->slots) * header->slotStride);
+
+  sequence = slot->sequence.load(std::memory_order_acquire);
+  if (sequence == 0 || (sequence & 1) != 0)
+    return nullptr;
+  return slot;
+}
+
+bool FrameMirrorReader::valid(const MirrorSlot *slot,
+                              uint64_t sequence) const {
+  // Orders the reads of the frame before the second sequence load
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot->sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+bool FrameMirrorReader::copyLatest(void *pixels, MirrorFrame &info) const {
+  if (!header)
+    return false;
+
+  // Only a writer lapping the reader fails twice
+  for (int attempt = 0; attempt < 4; ++attempt) {
+    uint64_t sequence = 0;
+    const MirrorSlot *slot = latest(sequence);
+    if (!slot)
+      return false;
+
+    info.frame = slot->frame;
+    info.timestampNs = slot->timestampNs;
+    info.dirty = slot->dirty;
+    std::memcpy(pixels,
+                reinterpret_cast<const std::byte *>(slot) + MIRROR_SLOT_HEADER,
+                static_cast<std::size_t>(header->pitch) *
+                    static_cast<std::size_t>(header->height));
+
+    if (valid(slot, sequence))
+      return true;
+  }
+  return false;
+}
@@ -0,0 +1,121 @@
+#include "GlyphAtlas.hpp"
+
+GlyphAtlas::GlyphAtlas(TTF_Font *font, std::string_view charset,
+                       SDL_Color color) {
+  if (!font)
+    return;
+
+  height = TTF_FontHeight(font);
+
+  for (char c : charset) {
+    auto index = static_cast<unsigned char>(c);
+    if (index >= glyphs.size())
+      continue;
+
+    sdl_unique<SDL_Surface> rendered(TTF_RenderGlyph_Blended(font, c, color));
+    if (!rendered)
+      continue;
+
+    // One pixel format for all glyphs so compose is a plain row copy
+    glyphs[index].reset(
+        SDL_ConvertSurfaceFormat(rendered.get(), SDL_PIXELFORMAT_ARGB8888, 0));
+    if (!glyphs[index])
+      continue;
+
+    const SDL_Surface *glyph = glyphs[index].get();
+    maxAdvance = std::max(maxAdvance, glyph->w);
+    height = std::max(height, glyph->h);
+
+    // Keep the alpha channel as a tightly packed coverage mask
+    std::vector<Uint8> &mask = masks[index];
+    mask.resize(static_cast<std::size_t>(glyph->w) * glyph->h);
+    for (int y = 0; y < glyph->h; ++y) {
+      const auto *row = reinterpret_cast<const Uint32 *>(
+          static_cast<const Uint8 *>(glyph->pixels) + y * glyph->pitch);
+      for (int x = 0; x < glyph->w; ++x) {
+        mask[y * glyph->w + x] = static_cast<Uint8>(row[x] >> 24);
+      }
+    }
+  }
+}
+
+int GlyphAtlas::measure(std::string_view text) const {
+  int width = 0;
+  for (char c : text) {
+    auto index = static_cast<unsigned char>(c);
+    if (index < glyphs.size() && glyphs[index])
+      width += glyphs[index]->w;
+  }
+  return width;
+}
+
+int GlyphAtlas::getMaxAdvance() const { return maxAdvance; }
+int GlyphAtlas::getHeight() const { return height; }
+
+int GlyphAtlas::compose(std::string_view text, SDL_Surface *target) const {
+  if (!target)
+    return 0;
+
+  auto *dst = static_cast<Uint8 *>(target->pixels);
+  int rows = std::min(height, target->h);
+  int x = 0;
+
+  for (char c : text) {
+    auto index = static_cast<unsigned char>(c);
+    if (index >= glyphs.size() || !glyphs[index])
+      continue;
+
+    const SDL_Surface *glyph = glyphs[index].get();
+    if (x + glyph->w > target->w)
+      break;
+
+    const auto *src = static_cast<const Uint8 *>(glyph->pixels);
+    int glyphRows = std::min(rows, glyph->h);
+    std::size_t bytes = static_cast<std::size_t>(glyph->w) * 4;
+
+    for (int y = 0; y < glyphRows; ++y) {
+      std::memcpy(dst + y * target->pitch + x * 4, src + y * glyph->pitch,
+                  bytes);
+    }
+    // Glyphs shorter than the line leave transparent rows below
+    for (int y = glyphRows; y < rows; ++y) {
+      std::memset(dst + y * target->pitch + x * 4, 0, bytes);
+    }
+
+    x += glyph->w;
+  }
+
+  return x;
+}
+
+int GlyphAtlas::composeMask(std::string_view text, Uint8 *target, int pitch,
+                            int width, int rows) const {
+  if (!target)
+    return 0;
+
+  rows = std::min(rows, height);
+  int x = 0;
+
+  for (char c : text) {
+    auto index = static_cast<unsigned char>(c);
+    if (index >= glyphs.size() || !glyphs[index])
+      continue;
+
+    int glyphWidth = glyphs[index]->w;
+    int glyphRows = std::min(rows, glyphs[index]->h);
+    if (x + glyphWidth > width)
+      break;
+
+    const Uint8 *src = masks[index].data();
+    for (int y = 0; y < glyphRows; ++y) {
+      std::memcpy(target + y * pitch + x, src + y * glyphWidth, glyphWidth);
+    }
+    for (int y = glyphRows; y < rows; ++y) {
+      std::memset(target + y * pitch + x, 0, glyphWidth);
+    }
+
+    x += glyphWidth;
+  }
+
+  return x;
+}
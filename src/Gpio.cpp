@@ -2,7 +2,7 @@
 
 #ifdef RPI
 
-GpioPi::GpioPi(const std::string &path) {
+GpioPi::GpioPi(IoLoop &io, const std::string &path) : io{io} {
   gpiod::chip chip(path);
 
   if (!chip) {
@@ -20,40 +20,72 @@ GpioPi::GpioPi(const std::string &path) {
   std::cout << "[GPIO] Offset "
             << static_cast<unsigned int>(LogicalPin::SHUTDOWN)
             << " initialized\n";
+  std::cout << "[GPIO] Offset " << static_cast<unsigned int>(LogicalPin::TARE)
+            << " initialized\n";
+
+  if (request)
+    watchEdges();
 }
 
-GpioPi::~GpioPi() {}
+GpioPi::~GpioPi() {
+  // The watcher reads the request, end it first
+  io.shutdown();
 
-void GpioPi::poll() {
+  // Hand the lines back to the kernel
+  if (request) {
+    request->release();
+    request.reset();
+  }
+  std::cout << "[GPIO] Lines released" << std::endl;
+}
 
-  // Return to top of function if no events found (constant)
-  if (!request || !request->wait_edge_events(std::chrono::milliseconds{0}))
-    return;
+Task GpioPi::watchEdges() {
+  while (true) {
+    IoEvent ready = co_await io.readable(request->fd());
+    if (ready.events & (EPOLLERR | EPOLLHUP)) {
+      std::cerr << "[GPIO] Request lost\n";
+      io.forget(request->fd());
+      co_return;
+    }
 
-  // Store events in buffer
-  gpiod::edge_event_buffer buffer;
-  request->read_edge_events(buffer);
+    // Store events in buffer
+    request->read_edge_events(buffer);
 
-  // GPIO Event buffer
-  for (const auto &event : buffer) {
+    // GPIO Event buffer
+    for (const auto &event : buffer) {
 
-    auto pin =
-        static_cast<LogicalPin>(static_cast<unsigned int>(event.line_offset()));
+      auto pin = static_cast<LogicalPin>(
+          static_cast<unsigned int>(event.line_offset()));
 
-    // Outcome if events occur (easy to add more)
-    switch (pin) {
+      // Outcome if events occur (easy to add more)
+      switch (pin) {
 
-    case LogicalPin::SHUTDOWN:
-      handleShutdown(event);
-      break;
-    case LogicalPin::KEY:
-      handleKey(event);
-      break;
+      case LogicalPin::SHUTDOWN:
+        handleShutdown(event);
+        break;
+      case LogicalPin::KEY:
+        handleKey(event);
+        break;
+      case LogicalPin::TARE:
+        handleTare(event);
+        break;
+      }
     }
   }
 }
 
-const PinState GpioPi::getState() const { return state; }
+const PinState GpioPi::getState() const {
+  PinState state;
+  state.shutdownRequested = shutdownRequested.load(std::memory_order_acquire);
+  state.keyEnabled = keyEnabled.load(std::memory_order_relaxed);
+  state.shutdownAt = std::chrono::steady_clock::time_point(
+      std::chrono::nanoseconds(shutdownAt.load(std::memory_order_relaxed)));
+  return state;
+}
+
+bool GpioPi::consumeTare() {
+  return tarePending.exchange(false, std::memory_order_relaxed);
+}
 
 void GpioPi::setup(gpiod::request_builder &builder) {
 
@@ -69,17 +101,34 @@ void GpioPi::setup(gpiod::request_builder &builder) {
   builder.add_line_settings(
       gpiod::line::offset{static_cast<unsigned int>(LogicalPin::SHUTDOWN)},
       settings);
+  builder.add_line_settings(
+      gpiod::line::offset{static_cast<unsigned int>(LogicalPin::TARE)},
+      settings);
 }
 
 void GpioPi::handleShutdown(const gpiod::edge_event &event) {
-  // If event buffer is populated
-  state.shutdownRequested =
-      event.type() == gpiod::edge_event::event_type::RISING_EDGE;
+  bool rising = event.type() == gpiod::edge_event::event_type::RISING_EDGE;
+
+  // Edges are stamped on CLOCK_MONOTONIC, the clock of steady_clock, so the
+  // shutdown time starts at the press and not when the render loop sees it
+  if (rising && !shutdownRequested.load(std::memory_order_relaxed))
+    shutdownAt.store(static_cast<int64_t>(event.timestamp_ns()),
+                     std::memory_order_relaxed);
+
+  // Publishes shutdownAt along with the request
+  shutdownRequested.store(rising, std::memory_order_release);
 }
 
 void GpioPi::handleKey(const gpiod::edge_event &event) {
   // If event buffer is populated
-  state.keyEnabled = event.type() == gpiod::edge_event::event_type::RISING_EDGE;
+  keyEnabled.store(event.type() == gpiod::edge_event::event_type::RISING_EDGE,
+                   std::memory_order_relaxed);
+}
+
+void GpioPi::handleTare(const gpiod::edge_event &event) {
+  // Only the press counts, releasing the button does nothing
+  if (event.type() == gpiod::edge_event::event_type::RISING_EDGE)
+    tarePending.store(true, std::memory_order_relaxed);
 }
 
 #endif
\ No newline at end of file
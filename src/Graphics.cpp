@@ -1,6 +1,25 @@
 #include "Graphics.hpp"
 
-SDLManager::SDLManager(const std::string &windowTitle) {
+namespace {
+
+// Banner in the top left, empty while the weight speaks for itself
+std::string_view statusText(const WeightReading &reading) {
+  if (reading.stale)
+    return "Link lost";
+  if (reading.overload || reading.underload)
+    return "";
+  if (reading.net <= 0)
+    return "Step on the scale";
+  return reading.stable ? "Stable" : "";
+}
+
+} // namespace
+
+SDLManager::SDLManager(const std::string &windowTitle,
+                       const AppConfig &config) {
+  // Count SDL allocations from the very first one
+  installAllocationHooks();
+
   // Init SDL
   std::cout << "[SDL] Start initialization" << "\n";
   if (SDL_Init(SDL_INIT_VIDEO < 0))
@@ -10,6 +29,10 @@ SDLManager::SDLManager(const std::string &windowTitle) {
   if (TTF_Init() < 0)
     printErrMsg(SDL_GetError());
 
+  input.emplace();
+  input->setKeymap(config.keymap);
+  playlist.emplace();
+
   int windowFlags = SDL_WINDOW_SHOWN;
 #ifdef RPI
   windowFlags |= (SDL_WINDOW_BORDERLESS | SDL_WINDOW_FULLSCREEN);
@@ -20,271 +43,879 @@ SDLManager::SDLManager(const std::string &windowTitle) {
                                 SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH,
                                 WINDOW_HEIGHT, windowFlags));
 
-  int renderFlags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
   if (!window)
     printErrMsg(SDL_GetError());
+  else
+    input->setWindow(SDL_GetWindowID(getRawWindow()));
 
-  // Assign renderer to window
-  renderer.reset(SDL_CreateRenderer(getRawWindow(), -1, renderFlags));
-
-  // Try fallback first
-  if (!renderer)
-    renderer.reset(
-        SDL_CreateRenderer(getRawWindow(), -1, SDL_RENDERER_SOFTWARE));
-  if (!renderer)
-    printErrMsg(SDL_GetError());
+  createRenderer();
 
   // State of window
   status = true;
 
-  setup();
+  setup(config);
+  setIdleTimeouts(std::chrono::minutes(config.dimAfter),
+                  std::chrono::minutes(config.blankAfter));
+  setMirrorRate(config.mirrorFps);
+  setPlaylist(config);
+  setAdaptiveQuality(config);
+  setOperatorDisplay(config);
 
   std::cout << "[SDL] Initialization successful" << "\n";
 }
 SDLManager::~SDLManager() {
   std::cout << "[SDL] Application being shutdown...." << "\n";
 
+  // Free resources in dependency order while the libraries are still up
+  prerender.wait();
+  operatorScreen.reset();
+  playlist.reset();
+  labels.clear();
+  textures.clear();
+  weightGlyphs.reset();
+  labelGlyphs.reset();
+  playlistTexture.reset();
+  image.reset();
+  logo.reset();
+  imageSurface.reset();
+  logoSurface.reset();
+  renderer.reset();
+  window.reset();
+  input.reset();
+
   // End other libraries before SDL Library
   TTF_Quit();
   IMG_Quit();
   SDL_Quit();
-  std::exit(1);
+
+  std::cout << "[SDL] Shutdown complete" << std::endl;
+}
+
+void SDLManager::createRenderer() {
+  int renderFlags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
+
+  // Assign renderer to window
+  renderer.reset(SDL_CreateRenderer(getRawWindow(), -1, renderFlags));
+
+  // Try fallback first
+  if (!renderer)
+    renderer.reset(
+        SDL_CreateRenderer(getRawWindow(), -1, SDL_RENDERER_SOFTWARE));
+  if (!renderer)
+    printErrMsg(SDL_GetError());
+
+  useCompositor = false;
+#ifdef PPW_SIMD_COMPOSITOR
+  // Scaled, blended copies are slow in software, blend text ourselves
+  SDL_RendererInfo info;
+  if (renderer && SDL_GetRendererInfo(getRawRenderer(), &info) == 0 &&
+      (info.flags & SDL_RENDERER_SOFTWARE)) {
+    useCompositor = true;
+    std::cout << "[SDL] Software renderer, compositing text with "
+              << getCompositorName() << "\n";
+  }
+#endif
 }
 
-void SDLManager::setup() {
+void SDLManager::restart() {
+  std::cout << "[SDL] Restarting renderer\n";
+
+  // Everything created by the old renderer goes first
+  prerender.wait();
+  nextTime[0] = '\0';
+  nextTimeUploaded = false;
+  labels.clear();
+  textures.clear();
+  logo.reset();
+  image.reset();
+  playlistTexture.reset();
+  playlistUploaded = false;
+  renderer.reset();
+
+  createRenderer();
+
+  // Decoded images and glyphs stay in memory, only textures are new
+  if (logoSurface)
+    uploadTexture(logoSurface.get(), logo);
+  if (imageSurface)
+    uploadTexture(imageSurface.get(), image);
+  if (weightGlyphs && labelGlyphs)
+    rebuildTextTextures();
+  markAllDirty();
+
+  createPlaylistTexture();
+}
+
+void SDLManager::setup(const AppConfig &config) {
 
   // Set surface framings to default
-  createTextures();
+  createTextures(config);
 
   setSurfacePosition(&timeSpec, TIME_X, TIME_Y, TIME_WIDTH, TIME_HEIGHT);
   setSurfacePosition(&qrSpec, IMAGE_X, IMAGE_Y, IMAGE_WIDTH, IMAGE_HEIGHT);
   setSurfacePosition(&logoSpec, LOGO_X, LOGO_Y, LOGO_WIDTH, LOGO_HEIGHT);
   setSurfacePosition(&weightSpec, weightX, WEIGHT_Y, weightWidth,
                      WEIGHT_HEIGHT);
+  setSurfacePosition(&trendSpec, TREND_X, TREND_Y, TREND_WIDTH, TREND_HEIGHT);
+
+  // Weight and QR code share the middle band, a tap there switches them
+  input->clearZones();
+  input->addZone(InputAction::TOGGLE_VIEW,
+                 SDL_Rect{0, WEIGHT_Y, WINDOW_WIDTH, WEIGHT_HEIGHT});
 }
 
-void SDLManager::render(int newWeight, std::string_view clock) {
+void SDLManager::render(const WeightReading &reading, std::string_view clock,
+                        std::string_view price, const TrendSeries &trend) {
+
+  uint64_t allocationsBefore = getAllocationCount();
+  AllocationGuard steadyState(frameCount >= STEADY_STATE_FRAMES);
+  auto frameStart = std::chrono::steady_clock::now();
+
+  if (!updateDisplayState(reading)) {
+    renderOperator(reading, price, trend, frameStart);
+    SDL_Delay(16);
+    return;
+  }
+  bool promo = updatePlaylist();
 
   SDL_RenderClear(getRawRenderer());
 
-  bool weightCheck = checkWeight(newWeight);
+  bool weightCheck = checkWeight(reading);
   bool timepointCheck = checkTime(clock);
 
-  if (timepointCheck) {
+  if (timepointCheck && !flipTime(clock)) {
     updateTimeTexture(clock);
   }
 
   // Proceed if check valid and needs update
   if (weightCheck) {
-    std::cout << "[SDL] New weight: " << newWeight << "\n";
-    updateWeightTexture(newWeight);
+    std::cout << "[SDL] New weight: " << reading.net << " g\n";
+    updateWeightTexture(reading);
   }
 
-  // Switch the rendering to QR code or WEIGHT
+  bool priceCheck = price != priceText;
+  if (priceCheck) {
+    priceText = price;
+  }
+
+  prepareNextTime(!weightCheck && !timepointCheck && !priceCheck);
+
+  // Areas the mirror sends again, the trend may scroll in any frame
+  std::string_view status = statusText(reading);
+  if (showImage != mirroredImage)
+    markAllDirty();
+  if (timepointCheck)
+    markDirty(timeSpec.rect);
   if (showImage) {
-    SDL_RenderCopy(getRawRenderer(), getRawWeight(), NULL, &weightSpec.rect);
+    int labelHeight = labelGlyphs ? labelGlyphs->getHeight() : 0;
+    if (weightCheck)
+      markDirty(SDL_Rect{0, WEIGHT_Y, WINDOW_WIDTH, WEIGHT_HEIGHT});
+    if (priceCheck)
+      markDirty(SDL_Rect{0, PRICE_Y, WINDOW_WIDTH, labelHeight});
+    if (status != mirroredStatus)
+      markDirty(SDL_Rect{STATUS_X, STATUS_Y, TREND_X - STATUS_X, labelHeight});
+    markDirty(trendSpec.rect);
+  }
+  mirroredImage = showImage;
+  mirroredStatus = status;
+
+  // Switch the rendering to the playlist, QR code or WEIGHT
+  if (promo) {
+    SDL_RenderCopy(getRawRenderer(), playlistTexture.get(), NULL, NULL);
+  } else if (showImage) {
+    if (useCompositor) {
+      compositeWeight();
+    } else {
+      SDL_RenderCopy(getRawRenderer(), getRawWeight(),
+                     textures.getUsed(weightSlot), &weightSpec.rect);
+    }
+    renderLabel(priceText, LABEL_CENTERED, PRICE_Y);
+    renderLabel(status, STATUS_X, STATUS_Y);
+    renderTrend(trend);
   } else {
     SDL_RenderCopy(getRawRenderer(), getRawImage(), NULL, &qrSpec.rect);
   }
 
   // Always present time and logo
-  SDL_RenderCopy(getRawRenderer(), getRawTime(), NULL, &timeSpec.rect);
+  SDL_RenderCopy(getRawRenderer(), getRawTime(), textures.getUsed(timeSlot),
+                 &timeSpec.rect);
   SDL_RenderCopy(getRawRenderer(), getRawLogo(), NULL, &logoSpec.rect);
 
+  if (displayState == DisplayState::DIMMED)
+    dimFrame();
+
+  publishFrame();
+  auto presentAt = std::chrono::steady_clock::now();
+  frameWork = presentAt - frameStart;
+  quality.record(frameWork);
   SDL_RenderPresent(getRawRenderer());
+  input->framePresented();
+  applyQuality(quality.update(thermal.latest(), presentAt));
+
+  // Only once the customer frame is out
+  renderOperator(reading, priceText, trend, presentAt);
+
+  checkFrameAllocations(allocationsBefore);
+
   SDL_Delay(16);
 }
 
-void SDLManager::printErrMsg(const char *errMsg) {
-  std::cerr << "SDL_Error occured: " << errMsg << "\n";
+bool SDLManager::updateDisplayState(const WeightReading &reading) {
+  auto now = std::chrono::steady_clock::now();
+
+  if (reading.value != 0 || inputActivity)
+    lastActivity = now;
+  inputActivity = false;
+
+  auto idle = now - lastActivity;
+  DisplayState next = DisplayState::ACTIVE;
+  if (blankAfter.count() > 0 && idle >= blankAfter)
+    next = DisplayState::BLANKED;
+  else if (dimAfter.count() > 0 && idle >= dimAfter)
+    next = DisplayState::DIMMED;
+
+  if (next == displayState)
+    return displayState == DisplayState::ACTIVE;
+
+  DisplayState previous = displayState;
+  displayState = next;
+  markAllDirty();
+
+  switch (next) {
+  case DisplayState::ACTIVE:
+    if (previous == DisplayState::BLANKED)
+      panel.set(true);
+    std::cout << "[SDL] Display awake\n";
+    return true;
+
+  case DisplayState::DIMMED:
+    // One more frame, darkened, then it stays on screen
+    std::cout << "[SDL] Display dimmed\n";
+    return true;
+
+  case DisplayState::BLANKED:
+    // Black even if the panel has no backlight to switch
+    SDL_RenderClear(getRawRenderer());
+    // The viewer goes black too, whatever the mirror rate
+    nextMirrorAt = {};
+    publishFrame();
+    SDL_RenderPresent(getRawRenderer());
+    panel.set(false);
+    std::cout << "[SDL] Display blanked\n";
+    return false;
+  }
+  return true;
 }
 
-void SDLManager::createTextures() {
+bool SDLManager::updatePlaylist() {
+  auto now = std::chrono::steady_clock::now();
+
+  // lastActivity is this frame's, a reading cuts back right away
+  bool idle = showImage && renderQuality != Quality::MINIMAL &&
+              playlistTexture && !playlist->empty() &&
+              now - lastActivity >= playlistAfter;
+  if (!idle) {
+    if (playlistShown) {
+      playlistShown = false;
+      markAllDirty();
+      std::cout << "[SDL] Playlist stopped\n";
+    }
+    return false;
+  }
 
-// Loads the logo into memory
-#ifdef RPI
-  loadSurfaceOfIMG(LOGO);
-#else
-  loadSurfaceOfIMG(LOGO.c_str());
-#endif
-  logo.reset(SDL_CreateTextureFromSurface(getRawRenderer(), getRawSurface()));
-  if (!logo)
-    printErrMsg(SDL_GetError());
+  // A frame decoded while the weight was shown goes up right away
+  if (!playlistShown)
+    nextPlaylistAt = now;
+
+  if (now >= nextPlaylistAt) {
+    if (const PlaylistFrame *frame = playlist->front()) {
+      if (SDL_UpdateTexture(playlistTexture.get(), NULL,
+                            frame->pixels->pixels,
+                            frame->pixels->pitch) != 0)
+        printErrMsg(SDL_GetError());
+      else
+        playlistUploaded = true;
+
+      // Fewer uploads at reduced quality, animations slow down
+      std::chrono::milliseconds shown = frame->duration;
+      if (renderQuality == Quality::REDUCED)
+        shown = std::max(shown, PLAYLIST_REDUCED_FRAME);
+
+      // Paced by the schedule so animations keep their speed, a late frame
+      // (slow decode, stall) starts it over
+      nextPlaylistAt += shown;
+      if (nextPlaylistAt < now)
+        nextPlaylistAt = now + shown;
+
+      playlist->pop();
+      markAllDirty();
+    }
+  }
 
-// Loads the qr code into memory
-#ifdef RPI
-  loadSurfaceOfIMG(IMAGE);
-#else
-  loadSurfaceOfIMG(IMAGE.c_str());
-#endif
+  // Nothing decoded yet, the weight stays
+  if (!playlistUploaded)
+    return false;
 
-  image.reset(SDL_CreateTextureFromSurface(getRawRenderer(), getRawSurface()));
-  if (!image)
-    printErrMsg(SDL_GetError());
+  if (!playlistShown) {
+    playlistShown = true;
+    markAllDirty();
+    std::cout << "[SDL] Playlist started\n";
+  }
+  return true;
+}
 
-// Loads the specified font into memory time and weight uses same font. (can
-// switch)
-#ifdef RPI
-  loadFontSurface(FONT);
-#else
-  loadFontSurface(FONT.c_str());
-#endif
+void SDLManager::setPlaylist(const AppConfig &config) {
+  playlistAfter = std::chrono::seconds(config.playlistAfter);
+  if (playlist->setEntries(config.playlist,
+                           std::chrono::seconds(config.playlistSeconds),
+                           config.playlistFps))
+    playlistUploaded = false;
+  createPlaylistTexture();
+}
 
-  time.reset(SDL_CreateTextureFromSurface(getRawRenderer(), getRawSurface()));
-  if (!time)
-    printErrMsg(SDL_GetError());
+void SDLManager::setAdaptiveQuality(const AppConfig &config) {
+  quality.setEnabled(config.adaptiveQuality);
+  thermal.setRoot(config.sysfsRoot);
+}
 
-  weight.reset(SDL_CreateTextureFromSurface(getRawRenderer(), getRawSurface()));
-  if (!weight)
-    printErrMsg(SDL_GetError());
+void SDLManager::setOperatorDisplay(const AppConfig &config) {
+  operatorFps = config.operatorFps;
+  if (config.operatorDisplay != operatorIndex) {
+    operatorIndex = config.operatorDisplay;
+    openOperator();
+  } else if (operatorScreen) {
+    operatorScreen->setRate(operatorFps);
+  }
+}
+
+void SDLManager::openOperator() {
+  operatorScreen.reset();
+  if (operatorIndex == OPERATOR_OFF || !labelGlyphs)
+    return;
+
+  operatorScreen.emplace(operatorIndex, *labelGlyphs);
+  if (!operatorScreen->valid()) {
+    operatorScreen.reset();
+    return;
+  }
+  operatorScreen->setRate(operatorFps);
+}
+
+void SDLManager::renderOperator(const WeightReading &reading,
+                                std::string_view price,
+                                const TrendSeries &trend,
+                                std::chrono::steady_clock::time_point now) {
+  if (!operatorScreen)
+    return;
+
+  OperatorStatus status;
+  status.display = displayStateName(displayState);
+  status.quality = renderQuality;
+  status.thermal = thermal.latest();
+  status.frameWork =
+      std::chrono::duration_cast<std::chrono::milliseconds>(frameWork);
+  status.inputLatencyMs = input->getStats().lastLatencyMs;
+  status.price = price;
+  operatorScreen->render(reading, trend, status, now);
+}
+
+void SDLManager::applyQuality(Quality next) {
+  if (next == renderQuality)
+    return;
+
+  bool solidBefore = renderQuality == Quality::MINIMAL;
+  renderQuality = next;
+  trendStale = true;
+  if (solidBefore != (next == Quality::MINIMAL))
+    updateWeightTexture(previousReading);
+  markAllDirty();
 }
 
-// Imaging
-void SDLManager::loadSurfaceOfIMG(const char *filepath) {
-  surface.reset(IMG_Load(filepath));
+void SDLManager::createPlaylistTexture() {
+  if (playlistTexture || playlist->empty())
+    return;
 
-  if (!surface)
+  playlistTexture.reset(SDL_CreateTexture(
+      getRawRenderer(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+      PLAYLIST_WIDTH, PLAYLIST_HEIGHT));
+  if (!playlistTexture)
     printErrMsg(SDL_GetError());
 }
 
-void SDLManager::loadFontSurface(const char *filepath) {
+void SDLManager::dimFrame() {
+  SDL_SetRenderDrawBlendMode(getRawRenderer(), SDL_BLENDMODE_BLEND);
+  SDL_SetRenderDrawColor(getRawRenderer(), 0, 0, 0, DIM_ALPHA);
+  SDL_RenderFillRect(getRawRenderer(), NULL);
 
-  font.reset(TTF_OpenFont(filepath, 400));
+  // RenderClear uses the draw color, restore the black background
+  SDL_SetRenderDrawColor(getRawRenderer(), 0, 0, 0, SDL_ALPHA_OPAQUE);
+  SDL_SetRenderDrawBlendMode(getRawRenderer(), SDL_BLENDMODE_NONE);
+}
+
+void SDLManager::setIdleTimeouts(std::chrono::milliseconds dimAfter,
+                                 std::chrono::milliseconds blankAfter) {
+  this->dimAfter = dimAfter;
+  this->blankAfter = blankAfter;
+}
+
+void SDLManager::notifyActivity() { inputActivity = true; }
+
+void SDLManager::setMirrorRate(int32_t fps) {
+  if (fps == mirrorFps && (fps == 0 || mirror.isOpen()))
+    return;
+  mirrorFps = fps;
+
+  if (fps <= 0) {
+    mirror.close();
+    std::cout << "[SDL] Frame mirror off\n";
+    return;
+  }
 
-  if (!font)
+  // Sized like the frames read back, not the window
+  if (!mirror.isOpen()) {
+    int width = 0;
+    int height = 0;
+    if (SDL_GetRendererOutputSize(getRawRenderer(), &width, &height) != 0) {
+      printErrMsg(SDL_GetError());
+      return;
+    }
+    if (!mirror.open(width, height))
+      return;
+  }
+
+  nextMirrorAt = {};
+  markAllDirty();
+}
+
+void SDLManager::markDirty(const SDL_Rect &area) {
+  SDL_UnionRect(&mirrorDirty, &area, &mirrorDirty);
+}
+
+void SDLManager::markAllDirty() {
+  mirrorDirty = SDL_Rect{0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
+}
+
+void SDLManager::publishFrame() {
+  if (!mirror.isOpen() || SDL_RectEmpty(&mirrorDirty))
+    return;
+
+  auto now = std::chrono::steady_clock::now();
+  if (now < nextMirrorAt)
+    return;
+  nextMirrorAt = now + std::chrono::nanoseconds(std::chrono::seconds(1)) /
+                           mirrorFps;
+
+  // Straight into the shared slot, nothing waits for readers. GL renderers
+  // stage the read in a heap buffer: exempt from the guard, mirrored frames
+  // still show in memory reports
+  int failed = 0;
+  {
+    AllocationExemption staging;
+    failed = SDL_RenderReadPixels(getRawRenderer(), NULL,
+                                  SDL_PIXELFORMAT_ARGB8888, mirror.begin(),
+                                  mirror.getPitch());
+  }
+  if (failed != 0) {
+    mirror.cancel();
     printErrMsg(SDL_GetError());
+    return;
+  }
+
+  mirror.commit(
+      MirrorRect{mirrorDirty.x, mirrorDirty.y, mirrorDirty.w, mirrorDirty.h});
+  mirrorDirty = SDL_Rect{};
+}
+
+DisplayState SDLManager::getDisplayState() const { return displayState; }
+
+const char *displayStateName(DisplayState state) {
+  switch (state) {
+  case DisplayState::DIMMED:
+    return "dimmed";
+  case DisplayState::BLANKED:
+    return "blanked";
+  case DisplayState::ACTIVE:
+    break;
+  }
+  return "active";
+}
+
+void SDLManager::checkFrameAllocations(uint64_t allocationsBefore) {
+  ++frameCount;
+
+  if (frameCount >= STEADY_STATE_FRAMES &&
+      (frameCount - STEADY_STATE_FRAMES) % MEMORY_REPORT_FRAMES == 0) {
+    LabelCacheStats stats = labels.getStats();
+    InputStats inputs = input->getStats();
+    std::cout << "[SDL] RSS " << getResidentBytes() / 1024 << " KiB, "
+              << getAllocationCount() << " heap allocations, labels "
+              << stats.hits << " hits / " << stats.misses
+              << " misses, input to frame " << inputs.maxLatencyMs
+              << " ms max, quality " << qualityName(renderQuality) << "\n";
+  }
+
+  uint64_t made = getAllocationCount() - allocationsBefore;
+  if (made == 0 || frameCount <= STEADY_STATE_FRAMES)
+    return;
+
+  std::cout << "[SDL] " << made << " heap allocations in frame " << frameCount
+            << "\n";
+}
+
+void SDLManager::printErrMsg(const char *errMsg) {
+  std::cerr << "SDL_Error occured: " << errMsg << "\n";
+}
+
+void SDLManager::createTextures(const AppConfig &config) {
+
+  // Same decoding as a reload, only on this thread
+  AssetSet assets;
+  assets.logo = decodeImage(assetPath(config.logo));
+  assets.image = decodeImage(assetPath(config.image));
+  if (!decodeGlyphs(assetPath(config.font), assets)) {
+    // Empty atlases keep the text paths valid without a font
+    assets.weightGlyphs.emplace(nullptr, WEIGHT_CHARSET, TEXT_COLOR);
+    assets.labelGlyphs.emplace(nullptr, LABEL_CHARSET, TEXT_COLOR);
+  }
+
+  // Starts with an empty scale, previousReading is zero
+  applyAssets(assets);
+}
+
+void SDLManager::applyAssets(AssetSet &assets) {
 
-  const char *value = "0";
+  if (assets.logo) {
+    uploadTexture(assets.logo.get(), logo);
+    logoSurface = std::move(assets.logo);
+  }
+
+  if (assets.image) {
+    uploadTexture(assets.image.get(), image);
+    imageSurface = std::move(assets.image);
+  }
+
+  if (assets.weightGlyphs && assets.labelGlyphs) {
+    weightGlyphs = std::move(assets.weightGlyphs);
+    labelGlyphs = std::move(assets.labelGlyphs);
 
-  surface.reset(TTF_RenderUTF8_Solid(getRawFont(), value, weightSpec.color));
+    // Glyph sizes changed, reserve again and redraw what is shown
+    rebuildTextTextures();
 
-  if (!surface)
+    if (operatorScreen)
+      operatorScreen->setGlyphs(*labelGlyphs);
+  }
+
+  assets = AssetSet{};
+  markAllDirty();
+}
+
+void SDLManager::uploadTexture(SDL_Surface *surface,
+                               sdl_unique<SDL_Texture> &texture) {
+  sdl_unique<SDL_Texture> uploaded(
+      SDL_CreateTextureFromSurface(getRawRenderer(), surface));
+  if (uploaded)
+    texture = std::move(uploaded);
+  else
     printErrMsg(SDL_GetError());
 }
 
-void SDLManager::updateWeightTexture(int newWeight) {
+void SDLManager::rebuildTextTextures() {
+  prerender.wait();
+  nextTime[0] = '\0';
+  nextTimeUploaded = false;
+  textures.clear();
+  reserveTextTextures();
+
+  FixedText<MAX_LABEL_LENGTH> time = timepoint;
+  updateWeightTexture(previousReading);
+  updateTimeTexture(time);
+}
+
+void SDLManager::reserveTextTextures() {
+  weightSlot = textures.reserve(
+      getRawRenderer(),
+      weightGlyphs->getMaxAdvance() * static_cast<int>(WEIGHT_TEXT_LENGTH - 1),
+      weightGlyphs->getHeight());
+  if (weightSlot == TEXTURE_POOL_CAPACITY)
+    printErrMsg("weight texture could not be reserved");
+
+  timeSlot = textures.reserve(getRawRenderer(),
+                              labelGlyphs->getMaxAdvance() * MAX_LABEL_LENGTH,
+                              labelGlyphs->getHeight());
+  if (timeSlot == TEXTURE_POOL_CAPACITY)
+    printErrMsg("time texture could not be reserved");
+
+  nextTimeSlot = textures.reserve(
+      getRawRenderer(), labelGlyphs->getMaxAdvance() * MAX_LABEL_LENGTH,
+      labelGlyphs->getHeight());
+  if (nextTimeSlot == TEXTURE_POOL_CAPACITY)
+    printErrMsg("next time texture could not be reserved");
+
+  if (labels.reserve(getRawRenderer(),
+                     labelGlyphs->getMaxAdvance() * MAX_LABEL_LENGTH,
+                     labelGlyphs->getHeight()) == 0)
+    printErrMsg("label cache could not be reserved");
+
+  if (useCompositor) {
+    weightMaskPitch =
+        weightGlyphs->getMaxAdvance() * static_cast<int>(WEIGHT_TEXT_LENGTH - 1);
+    weightMask.assign(
+        static_cast<std::size_t>(weightMaskPitch) * weightGlyphs->getHeight(),
+        0);
+  }
+}
+
+void SDLManager::updateWeightTexture(const WeightReading &reading) {
 
-  std::string value = std::to_string(newWeight);
+  char value[WEIGHT_TEXT_LENGTH];
+  formatWeight(reading, value, sizeof(value));
 
-  setWeightWidth(newWeight);
+  setWeightWidth(checkLengthOfWeight(value));
   setSurfacePosition(&weightSpec, weightX, WEIGHT_Y, weightWidth,
                      WEIGHT_HEIGHT);
 
-  surface.reset(
-      TTF_RenderUTF8_Blended(getRawFont(), value.c_str(), weightSpec.color));
-  if (!surface)
+  // Solid text is opaque and copied without blending, cheaper to draw
+  bool solid = renderQuality == Quality::MINIMAL;
+  if (!textures.update(weightSlot, *weightGlyphs, value, solid))
     printErrMsg(SDL_GetError());
+  SDL_SetTextureBlendMode(getRawWeight(), solid ? SDL_BLENDMODE_NONE
+                                                : SDL_BLENDMODE_BLEND);
 
-  weight.reset(SDL_CreateTextureFromSurface(getRawRenderer(), getRawSurface()));
-  if (!weight)
-    printErrMsg(SDL_GetError());
+  if (useCompositor) {
+    weightMaskWidth =
+        weightGlyphs->composeMask(value, weightMask.data(), weightMaskPitch,
+                                  weightMaskPitch, weightGlyphs->getHeight());
+  }
+}
+
+void SDLManager::compositeWeight() {
+  // Everything queued so far must land in the surface first
+  SDL_RenderFlush(getRawRenderer());
+
+  SDL_Surface *target = SDL_GetWindowSurface(getRawWindow());
+  if (!target || target->format->BytesPerPixel != 4) {
+    SDL_RenderCopy(getRawRenderer(), getRawWeight(),
+                   textures.getUsed(weightSlot), &weightSpec.rect);
+    return;
+  }
+
+  // Unscaled glyphs, centered in the weight rect and clipped to the window
+  int height = weightGlyphs->getHeight();
+  int x = weightSpec.rect.x + (weightSpec.rect.w - weightMaskWidth) / 2;
+  int y = weightSpec.rect.y + (weightSpec.rect.h - height) / 2;
+
+  int left = std::max(0, -x);
+  int top = std::max(0, -y);
+  int width = std::min(weightMaskWidth, target->w - x) - left;
+  int rows = std::min(height, target->h - y) - top;
+  if (width <= 0 || rows <= 0)
+    return;
+
+  if (SDL_MUSTLOCK(target))
+    SDL_LockSurface(target);
+
+  auto *pixels = static_cast<Uint8 *>(target->pixels) +
+                 (y + top) * target->pitch + (x + left) * 4;
+  const SDL_Color &color = TEXT_COLOR;
+
+  blendMask(reinterpret_cast<uint32_t *>(pixels), target->pitch,
+            weightMask.data() + top * weightMaskPitch + left, weightMaskPitch,
+            width, rows,
+            SDL_MapRGBA(target->format, color.r, color.g, color.b, color.a));
+
+  if (SDL_MUSTLOCK(target))
+    SDL_UnlockSurface(target);
 }
 
 void SDLManager::updateTimeTexture(std::string_view currentTimepoint) {
 
-  timepoint = std::string(currentTimepoint);
+  timepoint = currentTimepoint;
 
-  surface.reset(
-      TTF_RenderUTF8_Solid(getRawFont(), timepoint.c_str(), weightSpec.color));
-  if (!surface)
+  if (!textures.update(timeSlot, *labelGlyphs, timepoint))
     printErrMsg(SDL_GetError());
+}
 
-  time.reset(SDL_CreateTextureFromSurface(getRawRenderer(), getRawSurface()));
-  if (!time) {
-    printErrMsg(SDL_GetError());
+void SDLManager::prepareNextTime(bool idle) {
+  if (nextTimeSlot == TEXTURE_POOL_CAPACITY || !labelGlyphs)
+    return;
+
+  auto now = std::chrono::system_clock::now();
+
+  if (nextTime[0] == '\0') {
+    nextTimeAt = nextMinute(now);
+    formatClock(nextTimeAt, nextTime, sizeof(nextTime));
+    nextTimeUploaded = false;
+    if (!prerender.request(textures, nextTimeSlot, *labelGlyphs, nextTime))
+      nextTime[0] = '\0';
+    return;
   }
-}
 
-bool SDLManager::checkWeight(int weight) {
-  // Weight gets incremented in main loop
-  // Set when parameters match
-  static int previousWeight{};
+  if (nextTimeUploaded || !prerender.ready())
+    return;
+
+  if (!idle && now < nextTimeAt - PRERENDER_UPLOAD_LEAD)
+    return;
 
-  if (weight > MAX_WEIGHT) {
+  if (!textures.upload(nextTimeSlot))
+    printErrMsg(SDL_GetError());
+  nextTimeUploaded = true;
+}
+
+bool SDLManager::flipTime(std::string_view currentTimepoint) {
+  if (!nextTimeUploaded || currentTimepoint != nextTime) {
+    // Late or for another minute (clock was set), prepare again
+    if (prerender.ready())
+      nextTime[0] = '\0';
     return false;
   }
 
-  if (weight != previousWeight) {
-    previousWeight = weight;
-    return true;
-  }
+  // The spare slot already holds the label, the old one becomes the spare
+  std::swap(timeSlot, nextTimeSlot);
+  timepoint = currentTimepoint;
 
-  previousWeight = weight;
-  return false;
+  nextTime[0] = '\0';
+  nextTimeUploaded = false;
+  return true;
 }
 
-bool SDLManager::checkTime(std::string_view currentTimepoint) {
-  std::string previousTimepoint{};
+void SDLManager::renderLabel(std::string_view text, int x, int y) {
+  if (!labelGlyphs)
+    return;
 
-  if (currentTimepoint == previousTimepoint.c_str()) {
-    return false;
-  } else {
-    previousTimepoint = currentTimepoint;
-    return true;
+  const CachedLabel *label = labels.get(*labelGlyphs, text);
+  if (!label)
+    return;
+
+  SDL_Rect rect{x == LABEL_CENTERED ? (WINDOW_WIDTH - label->used.w) / 2 : x,
+                y, label->used.w, label->used.h};
+  SDL_RenderCopy(getRawRenderer(), label->texture.get(), &label->used, &rect);
+}
+
+void SDLManager::renderTrend(const TrendSeries &trend) {
+  // Drawn from the last build in between, less work at lower quality
+  uint64_t interval =
+      TREND_REBUILD_FRAMES[static_cast<std::size_t>(renderQuality)];
+  if (trendStale || frameCount - trendBuiltAt >= interval) {
+    trendPointCount =
+        buildTrendEnvelope(trend, trendSpec.rect, trendPoints.data());
+    trendBuiltAt = frameCount;
+    trendStale = false;
   }
+
+  if (trendPointCount < 2)
+    return;
+
+  const SDL_Color &color = trendSpec.color;
+  SDL_SetRenderDrawColor(getRawRenderer(), color.r, color.g, color.b, color.a);
+  SDL_RenderDrawLines(getRawRenderer(), trendPoints.data(),
+                      trendPointCount);
+
+  // RenderClear uses the draw color, restore the black background
+  SDL_SetRenderDrawColor(getRawRenderer(), 0, 0, 0, SDL_ALPHA_OPAQUE);
+}
+
+bool SDLManager::checkWeight(const WeightReading &reading) {
+  // Only what is drawn matters, gross and tare changes are not shown
+  bool changed = reading.value != previousReading.value ||
+                 reading.decimals != previousReading.decimals ||
+                 reading.overload != previousReading.overload ||
+                 reading.underload != previousReading.underload ||
+                 reading.stale != previousReading.stale;
+
+  previousReading = reading;
+  return changed;
+}
+
+bool SDLManager::checkTime(std::string_view currentTimepoint) {
+  // timepoint holds what is currently drawn
+  return currentTimepoint != timepoint;
 }
 
 bool SDLManager::getStatus() { return status; }
 
-bool SDLManager::hasEvent() const { return !events.empty(); }
+std::chrono::steady_clock::time_point
+SDLManager::getShutdownRequestedAt() const {
+  return shutdownRequestedAt;
+}
+
+LabelCacheStats SDLManager::getLabelStats() const { return labels.getStats(); }
+
+bool SDLManager::readPixels(const SDL_Rect &area, void *pixels, int pitch) {
+  if (SDL_RenderReadPixels(getRawRenderer(), &area, SDL_PIXELFORMAT_ARGB8888,
+                           pixels, pitch) != 0) {
+    printErrMsg(SDL_GetError());
+    return false;
+  }
+  return true;
+}
 
 #ifdef RPI
 void SDLManager::poll(const PinState &state) {
 
-  // Key switches the image shown
-  showImage = state.keyEnabled;
+  // A turn of the key switches the image shown and wakes the display, taps
+  // switch it in between
+  if (state.keyEnabled != keyEnabled) {
+    keyEnabled = state.keyEnabled;
+    inputActivity = true;
+    showImage = keyEnabled;
+  }
 
-  // If button is pressed, shutdown
-  if (state.shutdownRequested) {
+  // If button is pressed, shutdown, timed from the edge
+  if (state.shutdownRequested && status) {
     status = false;
+    shutdownRequestedAt =
+        state.shutdownAt != std::chrono::steady_clock::time_point{}
+            ? state.shutdownAt
+            : std::chrono::steady_clock::now();
   }
 }
 #endif
 
 void SDLManager::pollEvents() {
+  InputBatch batch = input->drain(WINDOW_WIDTH, WINDOW_HEIGHT);
 
-  while (SDL_PollEvent(&event)) {
-
-    events.push(event);
-
-    while (hasEvent()) {
-
-      event = getNext();
-
-      switch (event.type) {
+  if (batch.quit && status) {
+    shutdownRequestedAt = std::chrono::steady_clock::now();
+    std::cout << "[SDL] Closing SDL Window " << '\n';
+    status = false;
+  }
 
-      case SDL_QUIT:
-        std::cout << "[SDL] Closing SDL Window " << '\n';
-        status = false;
-        break;
+  if (batch.closedWindow != 0 && operatorScreen &&
+      batch.closedWindow == operatorScreen->getWindowId())
+    operatorScreen.reset();
+
+  // Every texture of both renderers went with the device
+  if (batch.renderReset && status) {
+    std::cout << "[SDL] Render device reset\n";
+    restart();
+    if (operatorScreen)
+      openOperator();
+  } else if (batch.redraw) {
+    markAllDirty();
+  }
 
-      case SDL_KEYDOWN:
-        showImage = !showImage;
-        std::cout << "[SDL] Key pressed: "
-                  << SDL_GetKeyName(event.key.keysym.sym) << '\n';
-        break;
+  if (!batch.activity)
+    return;
+  inputActivity = true;
 
-      case SDL_MOUSEBUTTONDOWN:
-        std::cout << "[SDL] Switching texture | " << " X: " << event.button.x
-                  << " Y: " << event.button.y << "\n";
+  // The first touch of a sleeping display or the playlist only wakes it
+  if (displayState != DisplayState::ACTIVE || playlistShown)
+    return;
 
-        showImage = !showImage;
-        break;
-      default:
-        break;
-      }
-    }
-  }
+  if (batch.toggles % 2 != 0)
+    showImage = !showImage;
+  if (batch.tare)
+    tareRequested = true;
 }
 
-SDL_Event SDLManager::getNext() {
-  if (events.empty())
-    return SDL_Event{}; // return empty event if none
-  event = events.front();
-  events.pop();
-  return event;
+void SDLManager::setKeymap(std::string_view keymap) {
+  input->setKeymap(keymap);
 }
 
+bool SDLManager::consumeTare() { return std::exchange(tareRequested, false); }
+
+InputStats SDLManager::getInputStats() const { return input->getStats(); }
+
 void SDLManager::setRenderingColor(Uint8 r, Uint8 g, Uint8 b) {
   SDL_RenderClear(getRawRenderer());
   // Set a white window
@@ -305,17 +936,11 @@ void SDLManager::setSurfacePosition(SDLSpec *surface, Uint16 x, Uint16 y,
   surface->rect.h = h;
 }
 
-int SDLManager::checkLengthOfWeight(int weight) {
-
-  std::string value = std::to_string(weight);
-  Uint8 length = value.length();
-
-  return length;
+int SDLManager::checkLengthOfWeight(std::string_view text) {
+  return static_cast<int>(text.length());
 }
 
-void SDLManager::setWeightWidth(int weight) {
-  int length = checkLengthOfWeight(weight);
-
+void SDLManager::setWeightWidth(int length) {
   weightWidth = WEIGHT_CHAR_SIZE * length;
 
   weightX = ((WINDOW_WIDTH / 2) + weightWidth / 2) - weightWidth;
@@ -326,9 +951,11 @@ void SDLManager::setWeightWidth(int weight) {
 
 SDL_Window *SDLManager::getRawWindow() const { return window.get(); }
 SDL_Renderer *SDLManager::getRawRenderer() const { return renderer.get(); }
-SDL_Surface *SDLManager::getRawSurface() const { return surface.get(); }
 SDL_Texture *SDLManager::getRawLogo() const { return logo.get(); }
-SDL_Texture *SDLManager::getRawTime() const { return time.get(); }
+SDL_Texture *SDLManager::getRawTime() const {
+  return textures.getTexture(timeSlot);
+}
 SDL_Texture *SDLManager::getRawImage() const { return image.get(); }
-SDL_Texture *SDLManager::getRawWeight() const { return weight.get(); }
-TTF_Font *SDLManager::getRawFont() const { return font.get(); }
+SDL_Texture *SDLManager::getRawWeight() const {
+  return textures.getTexture(weightSlot);
+}
@@ -0,0 +1,223 @@
+#include "Input.hpp"
+
+namespace {
+
+InputAction parseAction(std::string_view name) {
+  if (name == "toggle")
+    return InputAction::TOGGLE_VIEW;
+  if (name == "tare")
+    return InputAction::TARE;
+  if (name == "quit")
+    return InputAction::QUIT;
+  return InputAction::NONE;
+}
+
+bool contains(const SDL_Rect &area, int x, int y) {
+  return x >= area.x && y >= area.y && x < area.x + area.w &&
+         y < area.y + area.h;
+}
+
+} // namespace
+
+InputManager::InputManager() { SDL_SetEventFilter(keepEvent, this); }
+
+InputManager::~InputManager() { SDL_SetEventFilter(nullptr, nullptr); }
+
+bool InputManager::setKeymap(std::string_view keymap) {
+  // Built aside, a keymap with one bad entry leaves the current one
+  std::array<KeyBinding, INPUT_KEYS> parsed{};
+  std::size_t count = 0;
+
+  bool valid = readKeymap(keymap, [&parsed, &count](std::string_view key,
+                                                    std::string_view name) {
+    std::string keyName(key);
+    SDL_Keycode code = SDL_GetKeyFromName(keyName.c_str());
+    InputAction action = parseAction(name);
+    if (code == SDLK_UNKNOWN || action == InputAction::NONE ||
+        count == parsed.size())
+      return false;
+    parsed[count++] = KeyBinding{code, action};
+    return true;
+  });
+
+  if (!valid) {
+    std::cout << "[Input] Keymap rejected, bindings kept\n";
+    return false;
+  }
+
+  keys = parsed;
+  keyCount = count;
+  return true;
+}
+
+bool InputManager::addZone(InputAction action, const SDL_Rect &area) {
+  if (zoneCount == zones.size())
+    return false;
+  zones[zoneCount++] = Zone{area, action};
+  return true;
+}
+
+void InputManager::clearZones() { zoneCount = 0; }
+
+void InputManager::setWindow(Uint32 id) { window = id; }
+
+InputBatch InputManager::drain(int width, int height) {
+  InputBatch out;
+  Uint32 firstAt = 0;
+
+  SDL_PumpEvents();
+
+  // A full batch may leave more behind
+  int count = 0;
+  do {
+    count = SDL_PeepEvents(batch.data(), INPUT_BATCH, SDL_GETEVENT,
+                           SDL_FIRSTEVENT, SDL_LASTEVENT);
+    for (int i = 0; i < count; ++i) {
+      bool before = out.activity;
+      handle(batch[i], width, height, out);
+      if (!before && out.activity)
+        firstAt = batch[i].common.timestamp;
+    }
+    if (count > 0)
+      stats.events += static_cast<uint64_t>(count);
+  } while (count == INPUT_BATCH);
+
+  // Measured from the first input the next frame answers
+  if (out.activity && !pending) {
+    pending = true;
+    pendingAt = firstAt;
+  }
+
+  return out;
+}
+
+void InputManager::framePresented() {
+  if (!pending)
+    return;
+  pending = false;
+
+  Uint32 latency = SDL_GetTicks() - pendingAt;
+  stats.lastLatencyMs = latency;
+  stats.maxLatencyMs = std::max(stats.maxLatencyMs, latency);
+  stats.totalLatencyMs += latency;
+  ++stats.measured;
+}
+
+InputStats InputManager::getStats() const {
+  InputStats out = stats;
+  out.filtered = filtered.load(std::memory_order_relaxed);
+  return out;
+}
+
+int InputManager::keepEvent(void *userdata, SDL_Event *event) {
+  switch (event->type) {
+  case SDL_QUIT:
+  case SDL_FINGERDOWN:
+  case SDL_RENDER_TARGETS_RESET:
+  case SDL_RENDER_DEVICE_RESET:
+    return 1;
+  case SDL_WINDOWEVENT:
+    // Closing, and what leaves a window to be drawn again
+    if (event->window.event == SDL_WINDOWEVENT_CLOSE ||
+        event->window.event == SDL_WINDOWEVENT_EXPOSED ||
+        event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+        event->window.event == SDL_WINDOWEVENT_RESTORED)
+      return 1;
+    break;
+  case SDL_KEYDOWN:
+    if (!event->key.repeat)
+      return 1;
+    break;
+  case SDL_MOUSEBUTTONDOWN:
+    // Touches arrive as SDL_FINGERDOWN already
+    if (event->button.which != SDL_TOUCH_MOUSEID)
+      return 1;
+    break;
+  default:
+    break;
+  }
+
+  static_cast<InputManager *>(userdata)->filtered.fetch_add(
+      1, std::memory_order_relaxed);
+  return 0;
+}
+
+void InputManager::handle(const SDL_Event &event, int width, int height,
+                          InputBatch &out) {
+  InputAction action = InputAction::NONE;
+
+  switch (event.type) {
+  case SDL_QUIT:
+    out.quit = true;
+    return;
+
+  case SDL_WINDOWEVENT:
+    // SDL_QUIT only follows the last window, the customer's ends it all
+    if (event.window.event != SDL_WINDOWEVENT_CLOSE)
+      out.redraw = true;
+    else if (window == 0 || event.window.windowID == window)
+      out.quit = true;
+    else
+      out.closedWindow = event.window.windowID;
+    return;
+
+  case SDL_RENDER_TARGETS_RESET:
+    out.redraw = true;
+    return;
+
+  case SDL_RENDER_DEVICE_RESET:
+    out.renderReset = true;
+    return;
+
+  case SDL_KEYDOWN:
+    action = lookupKey(event.key.keysym.sym);
+    break;
+
+  case SDL_MOUSEBUTTONDOWN:
+    if (window == 0 || event.button.windowID == window)
+      action = hitTest(event.button.x, event.button.y);
+    break;
+
+  case SDL_FINGERDOWN:
+    if (window != 0 && event.tfinger.windowID != window)
+      break;
+    // Touch positions are relative to the screen the window fills
+    action = hitTest(static_cast<int>(event.tfinger.x * width),
+                     static_cast<int>(event.tfinger.y * height));
+    break;
+
+  default:
+    return;
+  }
+
+  out.activity = true;
+  switch (action) {
+  case InputAction::TOGGLE_VIEW:
+    ++out.toggles;
+    break;
+  case InputAction::TARE:
+    out.tare = true;
+    break;
+  case InputAction::QUIT:
+    out.quit = true;
+    break;
+  case InputAction::NONE:
+    break;
+  }
+}
+
+InputAction InputManager::lookupKey(SDL_Keycode key) const {
+  for (std::size_t i = 0; i < keyCount; ++i) {
+    if (keys[i].key == key)
+      return keys[i].action;
+  }
+  return InputAction::NONE;
+}
+
+InputAction InputManager::hitTest(int x, int y) const {
+  for (std::size_t i = 0; i < zoneCount; ++i) {
+    if (contains(zones[i].area, x, y))
+      return zones[i].action;
+  }
+  return InputAction::NONE;
+}
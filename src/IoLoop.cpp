@@ -0,0 +1,243 @@
+#include "IoLoop.hpp"
+
+IoLoop::Awaiter::Awaiter(IoLoop &loop, std::initializer_list<IoWait> list,
+                         Clock::time_point deadline)
+    : loop{loop}, deadline{deadline} {
+  for (const IoWait &wait : list) {
+    if (count == waits.size()) {
+      std::cerr << "[IO] More than " << MAX_WAIT_FDS << " descriptors\n";
+      break;
+    }
+    waits[count++] = wait;
+  }
+}
+
+bool IoLoop::Awaiter::await_ready() const noexcept {
+  // Nothing to wait for resumes at once with a timeout
+  bool anyFd = std::any_of(waits.begin(), waits.begin() + count,
+                           [](const IoWait &wait) { return wait.fd >= 0; });
+  return !anyFd && (deadline == NEVER || deadline <= Clock::now());
+}
+
+void IoLoop::Awaiter::await_suspend(std::coroutine_handle<> coroutine) {
+  handle = coroutine;
+  loop.attach(*this);
+}
+
+IoLoop::IoLoop() {
+  epollFd = epoll_create1(EPOLL_CLOEXEC);
+  if (epollFd < 0)
+    std::cerr << "[IO] epoll failed\n";
+
+  stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (stopFd < 0)
+    std::cerr << "[IO] Stop descriptor failed\n";
+
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = stopFd;
+  if (epollFd >= 0 && stopFd >= 0 &&
+      epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &event) < 0)
+    std::cerr << "[IO] Stop descriptor not watched\n";
+
+  timed.reserve(MAX_WAIT_FDS);
+}
+
+IoLoop::~IoLoop() {
+  shutdown();
+
+  if (stopFd >= 0)
+    close(stopFd);
+  if (epollFd >= 0)
+    close(epollFd);
+}
+
+void IoLoop::start() {
+  if (worker.joinable() || stopped.load())
+    return;
+
+  worker = std::thread(&IoLoop::run, this);
+}
+
+void IoLoop::stop() {
+  if (stopped.exchange(true))
+    return;
+
+  uint64_t one = 1;
+  if (stopFd >= 0 && write(stopFd, &one, sizeof(one)) < 0)
+    std::cerr << "[IO] Stop signal failed\n";
+}
+
+void IoLoop::shutdown() {
+  stop();
+
+  if (worker.joinable())
+    worker.join();
+
+  // Suspended coroutines never resume again, free their frames
+  std::vector<std::coroutine_handle<>> suspended;
+  for (auto &[fd, entry] : entries) {
+    if (entry.waiter)
+      suspended.push_back(entry.waiter->handle);
+  }
+  for (Awaiter *awaiter : timed)
+    suspended.push_back(awaiter->handle);
+
+  std::sort(suspended.begin(), suspended.end(),
+            [](auto a, auto b) { return a.address() < b.address(); });
+  suspended.erase(std::unique(suspended.begin(), suspended.end()),
+                  suspended.end());
+
+  entries.clear();
+  timed.clear();
+
+  for (std::coroutine_handle<> handle : suspended)
+    handle.destroy();
+}
+
+IoLoop::Awaiter IoLoop::wait(std::initializer_list<IoWait> waits,
+                             Clock::time_point deadline) {
+  return Awaiter(*this, waits, deadline);
+}
+
+IoLoop::Awaiter IoLoop::readable(int fd, Clock::time_point deadline) {
+  return Awaiter(*this, {IoWait{fd, EPOLLIN}}, deadline);
+}
+
+IoLoop::Awaiter IoLoop::sleepUntil(Clock::time_point deadline) {
+  return Awaiter(*this, {}, deadline);
+}
+
+void IoLoop::forget(int fd) {
+  auto entry = entries.find(fd);
+  if (entry == entries.end())
+    return;
+
+  if (entry->second.registered)
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+
+  // A waiter keeps its other descriptors and deadline
+  entries.erase(entry);
+}
+
+void IoLoop::run() {
+  std::array<epoll_event, IO_EVENT_BATCH> events;
+
+  while (!stopped.load()) {
+    int count = epoll_wait(epollFd, events.data(),
+                           static_cast<int>(events.size()), nextTimeout());
+    if (count < 0) {
+      if (errno == EINTR)
+        continue;
+      std::cerr << "[IO] epoll_wait failed\n";
+      break;
+    }
+
+    for (int i = 0; i < count; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == stopFd)
+        return;
+
+      // Closed and forgotten by an earlier resume in this batch
+      auto entry = entries.find(fd);
+      if (entry == entries.end())
+        continue;
+
+      Awaiter *waiter = entry->second.waiter;
+      if (!waiter) {
+        // Nobody waits, stop level triggered wakeups until someone does
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        entry->second.registered = 0;
+        continue;
+      }
+
+      int index = 0;
+      while (waiter->waits[index].fd != fd)
+        ++index;
+
+      resume(*waiter, IoEvent{index, events[i].events});
+    }
+
+    expireTimers();
+  }
+}
+
+void IoLoop::attach(Awaiter &awaiter) {
+  for (std::size_t i = 0; i < awaiter.count; ++i) {
+    const IoWait &wait = awaiter.waits[i];
+    if (wait.fd < 0)
+      continue;
+
+    Entry &entry = entries[wait.fd];
+    if (entry.waiter && entry.waiter != &awaiter)
+      std::cerr << "[IO] Two coroutines wait on fd " << wait.fd << "\n";
+    entry.waiter = &awaiter;
+
+    if (entry.registered == wait.events)
+      continue;
+
+    epoll_event event{};
+    event.events = wait.events;
+    event.data.fd = wait.fd;
+    int op = entry.registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(epollFd, op, wait.fd, &event) < 0) {
+      std::cerr << "[IO] Could not watch fd " << wait.fd << "\n";
+      continue;
+    }
+    entry.registered = wait.events;
+  }
+
+  if (awaiter.deadline != NEVER)
+    timed.push_back(&awaiter);
+}
+
+void IoLoop::detach(Awaiter &awaiter) {
+  for (std::size_t i = 0; i < awaiter.count; ++i) {
+    auto entry = entries.find(awaiter.waits[i].fd);
+    if (entry != entries.end() && entry->second.waiter == &awaiter)
+      entry->second.waiter = nullptr;
+  }
+
+  auto found = std::find(timed.begin(), timed.end(), &awaiter);
+  if (found != timed.end()) {
+    *found = timed.back();
+    timed.pop_back();
+  }
+}
+
+void IoLoop::resume(Awaiter &awaiter, IoEvent result) {
+  detach(awaiter);
+  awaiter.result = result;
+  // The awaiter lives in the coroutine frame, do not touch it after this
+  awaiter.handle.resume();
+}
+
+void IoLoop::expireTimers() {
+  // Resumed coroutines may add deadlines, search again after each one
+  while (true) {
+    auto now = Clock::now();
+    auto expired = std::find_if(timed.begin(), timed.end(),
+                                [now](const Awaiter *awaiter) {
+                                  return awaiter->deadline <= now;
+                                });
+    if (expired == timed.end())
+      return;
+
+    resume(**expired, IoEvent{});
+  }
+}
+
+int IoLoop::nextTimeout() const {
+  if (timed.empty())
+    return -1;
+
+  auto nearest = (*std::min_element(timed.begin(), timed.end(),
+                                    [](const Awaiter *a, const Awaiter *b) {
+                                      return a->deadline < b->deadline;
+                                    }))
+                     ->deadline;
+
+  auto left = std::chrono::ceil<std::chrono::milliseconds>(nearest -
+                                                           Clock::now());
+  return static_cast<int>(std::clamp<long long>(left.count(), 0, INT32_MAX));
+}
@@ -0,0 +1,107 @@
+#include "LabelCache.hpp"
+
+namespace {
+
+std::size_t keyHash(const GlyphAtlas &atlas, std::string_view text) {
+  std::size_t hash = std::hash<std::string_view>{}(text);
+  return hash ^ (std::hash<const GlyphAtlas *>{}(&atlas) +
+                 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2));
+}
+
+} // namespace
+
+std::size_t LabelCache::reserve(SDL_Renderer *renderer, int width,
+                                int height, std::size_t budget) {
+  clear();
+  if (width <= 0 || height <= 0)
+    return 0;
+
+  staging.reset(SDL_CreateRGBSurfaceWithFormat(0, width, height, 32,
+                                               SDL_PIXELFORMAT_ARGB8888));
+  if (!staging) {
+    std::cerr << "SDL_Error occured: " << SDL_GetError() << "\n";
+    return 0;
+  }
+
+  entryBytes = static_cast<std::size_t>(width) * height * 4;
+  std::size_t count = std::max<std::size_t>(1, budget / entryBytes);
+
+  entries.resize(count);
+  for (CachedLabel &entry : entries) {
+    entry.texture.reset(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                          SDL_TEXTUREACCESS_STREAMING, width,
+                                          height));
+    if (!entry.texture) {
+      std::cerr << "SDL_Error occured: " << SDL_GetError() << "\n";
+      clear();
+      return 0;
+    }
+    // Glyph pixels carry their own coverage
+    SDL_SetTextureBlendMode(entry.texture.get(), SDL_BLENDMODE_BLEND);
+  }
+
+  return count;
+}
+
+const CachedLabel *LabelCache::get(const GlyphAtlas &atlas,
+                                   std::string_view text) {
+  if (entries.empty() || text.empty() ||
+      text.size() > LABEL_CACHE_TEXT_LENGTH)
+    return nullptr;
+
+  ++tick;
+  std::size_t hash = keyHash(atlas, text);
+
+  // Hit, or the least recently used entry to replace
+  CachedLabel *victim = &entries.front();
+  for (CachedLabel &entry : entries) {
+    if (entry.lastUsed != 0 && entry.hash == hash && entry.atlas == &atlas &&
+        entry.text == text) {
+      entry.lastUsed = tick;
+      ++stats.hits;
+      return &entry;
+    }
+    if (entry.lastUsed < victim->lastUsed)
+      victim = &entry;
+  }
+
+  ++stats.misses;
+  if (victim->lastUsed != 0)
+    ++stats.evictions;
+  else
+    ++stats.entries;
+
+  int width = atlas.compose(text, staging.get());
+  int height = std::min(atlas.getHeight(), staging->h);
+
+  victim->used = SDL_Rect{0, 0, width, height};
+  victim->atlas = &atlas;
+  victim->text = text;
+  victim->hash = hash;
+  victim->lastUsed = tick;
+
+  if (width > 0 &&
+      SDL_UpdateTexture(victim->texture.get(), &victim->used, staging->pixels,
+                        staging->pitch) != 0) {
+    // Free again, the texture holds nothing usable
+    victim->lastUsed = 0;
+    --stats.entries;
+    return nullptr;
+  }
+
+  return victim;
+}
+
+LabelCacheStats LabelCache::getStats() const {
+  LabelCacheStats out = stats;
+  out.bytes = out.entries * entryBytes;
+  return out;
+}
+
+void LabelCache::clear() {
+  entries.clear();
+  staging.reset();
+  entryBytes = 0;
+  tick = 0;
+  stats.entries = 0;
+}
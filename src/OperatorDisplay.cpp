@@ -0,0 +1,199 @@
+#include "OperatorDisplay.hpp"
+
+namespace {
+
+// What the indicator says about the reading
+const char *readingState(const WeightReading &reading) {
+  if (reading.stale)
+    return "Link lost";
+  if (reading.overload)
+    return "Overload";
+  if (reading.underload)
+    return "Underload";
+  return reading.stable ? "Stable" : "Moving";
+}
+
+} // namespace
+
+OperatorDisplay::OperatorDisplay(int32_t display, const GlyphAtlas &glyphs)
+    : glyphs(&glyphs), display(display) {
+  slots.fill(TEXTURE_POOL_CAPACITY);
+  setRate(DEFAULT_OPERATOR_FPS);
+
+  int displays = SDL_GetNumVideoDisplays();
+  if (display >= displays) {
+    std::cerr << "[Operator] No display " << display << ", " << displays
+              << " connected\n";
+    return;
+  }
+
+  int windowFlags = SDL_WINDOW_SHOWN;
+#ifdef RPI
+  windowFlags |= (SDL_WINDOW_BORDERLESS | SDL_WINDOW_FULLSCREEN_DESKTOP);
+#endif
+
+  window.reset(SDL_CreateWindow(
+      "Operator", SDL_WINDOWPOS_CENTERED_DISPLAY(display),
+      SDL_WINDOWPOS_CENTERED_DISPLAY(display), OPERATOR_WIDTH, OPERATOR_HEIGHT,
+      windowFlags));
+  if (!window) {
+    std::cerr << "[Operator] Could not open a window: " << SDL_GetError()
+              << "\n";
+    return;
+  }
+
+  // Presents never wait for a vblank of this monitor
+  renderer.reset(
+      SDL_CreateRenderer(window.get(), -1, SDL_RENDERER_ACCELERATED));
+  if (!renderer)
+    renderer.reset(SDL_CreateRenderer(window.get(), -1, SDL_RENDERER_SOFTWARE));
+  if (!renderer) {
+    std::cerr << "[Operator] Could not create a renderer: " << SDL_GetError()
+              << "\n";
+    return;
+  }
+
+  SDL_RenderSetLogicalSize(renderer.get(), OPERATOR_WIDTH, OPERATOR_HEIGHT);
+  SDL_SetRenderDrawColor(renderer.get(), 0, 0, 0, SDL_ALPHA_OPAQUE);
+  reserveLines();
+
+  std::cout << "[Operator] Window on display " << display << "\n";
+}
+
+OperatorDisplay::~OperatorDisplay() {
+  if (window)
+    std::cout << "[Operator] Window on display " << display << " closed\n";
+}
+
+bool OperatorDisplay::valid() const { return window && renderer; }
+
+void OperatorDisplay::setRate(int32_t fps) {
+  period = std::chrono::milliseconds(1000 / std::max(fps, 1));
+}
+
+void OperatorDisplay::setGlyphs(const GlyphAtlas &next) {
+  glyphs = &next;
+  if (!renderer)
+    return;
+
+  textures.clear();
+  reserveLines();
+}
+
+Uint32 OperatorDisplay::getWindowId() const {
+  return window ? SDL_GetWindowID(window.get()) : 0;
+}
+
+void OperatorDisplay::reserveLines() {
+  for (std::size_t line = 0; line < OPERATOR_LINES; ++line) {
+    slots[line] = textures.reserve(
+        renderer.get(),
+        glyphs->getMaxAdvance() * static_cast<int>(OPERATOR_LINE_LENGTH),
+        glyphs->getHeight());
+    if (slots[line] == TEXTURE_POOL_CAPACITY)
+      std::cerr << "[Operator] Line " << line << " could not be reserved\n";
+
+    // Composed again in the next frame
+    shown[line].clear();
+  }
+  dirty = true;
+}
+
+void OperatorDisplay::updateLine(std::size_t line, const char *text) {
+  if (shown[line] == std::string_view(text))
+    return;
+
+  shown[line] = text;
+  textures.update(slots[line], *glyphs, shown[line]);
+  dirty = true;
+}
+
+void OperatorDisplay::updateTrend(const TrendSeries &trend) {
+  int count = buildTrendEnvelope(trend, trendRect, trendBuild.data());
+
+  auto same = [](const SDL_Point &a, const SDL_Point &b) {
+    return a.x == b.x && a.y == b.y;
+  };
+  bool moved = count != trendPointCount ||
+               !std::equal(trendBuild.begin(), trendBuild.begin() + count,
+                           trendPoints.begin(), same);
+  if (!moved)
+    return;
+
+  std::copy_n(trendBuild.begin(), count, trendPoints.begin());
+  trendPointCount = count;
+  dirty = true;
+}
+
+void OperatorDisplay::render(const WeightReading &reading,
+                             const TrendSeries &trend,
+                             const OperatorStatus &status,
+                             std::chrono::steady_clock::time_point now) {
+  if (!valid() || now < nextAt)
+    return;
+  nextAt = now + period;
+
+  // Room for the longest numbers, the line cuts what does not fit
+  char text[3 * OPERATOR_LINE_LENGTH];
+
+  std::snprintf(text, sizeof(text), "Net %d g  Tare %d g", reading.net,
+                reading.tare);
+  updateLine(0, text);
+
+  std::snprintf(text, sizeof(text), "Gross %d g  %s", reading.gross,
+                readingState(reading));
+  updateLine(1, text);
+
+  std::snprintf(text, sizeof(text), "Price %.*s",
+                static_cast<int>(status.price.size()), status.price.data());
+  updateLine(2, status.price.empty() ? "No price" : text);
+
+  std::snprintf(text, sizeof(text), "Screen %s  quality %s", status.display,
+                qualityName(status.quality));
+  updateLine(3, text);
+
+  const ThermalSample &thermal = status.thermal;
+  if (thermal.milliCelsius == 0)
+    std::snprintf(text, sizeof(text), "No thermal zone");
+  else
+    std::snprintf(text, sizeof(text), "%d.%d C  %d/%d MHz%s",
+                  thermal.milliCelsius / 1000,
+                  std::abs(thermal.milliCelsius % 1000) / 100,
+                  thermal.curKHz / 1000, thermal.maxKHz / 1000,
+                  thermal.throttled() ? "  throttled" : "");
+  updateLine(4, text);
+
+  std::snprintf(text, sizeof(text), "Frame %d ms  input %u ms",
+                static_cast<int>(status.frameWork.count()),
+                status.inputLatencyMs);
+  updateLine(5, text);
+
+  updateTrend(trend);
+
+  // Nothing new, the monitor keeps showing the last frame
+  if (!dirty)
+    return;
+  dirty = false;
+
+  SDL_RenderClear(renderer.get());
+
+  int y = OPERATOR_MARGIN;
+  for (std::size_t line = 0; line < OPERATOR_LINES; ++line) {
+    const SDL_Rect *used = textures.getUsed(slots[line]);
+    if (used) {
+      SDL_Rect rect{OPERATOR_MARGIN, y, used->w, used->h};
+      SDL_RenderCopy(renderer.get(), textures.getTexture(slots[line]), used,
+                     &rect);
+    }
+    y += glyphs->getHeight();
+  }
+
+  if (trendPointCount >= 2) {
+    const SDL_Color &color = OPERATOR_TREND_COLOR;
+    SDL_SetRenderDrawColor(renderer.get(), color.r, color.g, color.b, color.a);
+    SDL_RenderDrawLines(renderer.get(), trendPoints.data(), trendPointCount);
+    SDL_SetRenderDrawColor(renderer.get(), 0, 0, 0, SDL_ALPHA_OPAQUE);
+  }
+
+  SDL_RenderPresent(renderer.get());
+}
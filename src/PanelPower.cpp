@@ -0,0 +1,34 @@
+#include "PanelPower.hpp"
+
+PanelPower::PanelPower(const std::string &root) {
+  std::error_code error;
+  for (const auto &entry : std::filesystem::directory_iterator(root, error)) {
+    std::filesystem::path power = entry.path() / "bl_power";
+    if (access(power.c_str(), W_OK) == 0) {
+      powerPath = power.string();
+      std::cout << "[Panel] Backlight " << entry.path().filename().string()
+                << "\n";
+      return;
+    }
+  }
+}
+
+bool PanelPower::available() const { return !powerPath.empty(); }
+
+bool PanelPower::set(bool on) {
+  if (powerPath.empty())
+    return false;
+
+  int fd = open(powerPath.c_str(), O_WRONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  // FB_BLANK_UNBLANK and FB_BLANK_POWERDOWN
+  const char *value = on ? "0" : "4";
+  bool written = write(fd, value, 1) == 1;
+  close(fd);
+
+  if (!written)
+    std::cout << "[Panel] Backlight could not be switched\n";
+  return written;
+}
@@ -0,0 +1,202 @@
+#include "Playlist.hpp"
+
+namespace {
+
+// Image files taken from a directory entry
+bool isImage(const std::filesystem::path &path) {
+  std::string extension = path.extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+         extension == ".bmp";
+}
+
+} // namespace
+
+Playlist::Playlist() : worker(&Playlist::run, this) {}
+
+Playlist::~Playlist() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+
+  if (worker.joinable())
+    worker.join();
+}
+
+bool Playlist::setEntries(std::string_view list,
+                          std::chrono::milliseconds stillTime, int32_t fps) {
+  std::vector<std::string> parsed;
+  while (!list.empty()) {
+    std::size_t comma = list.find(',');
+    std::string_view item = trimSetting(list.substr(0, comma));
+    list = comma == std::string_view::npos ? std::string_view{}
+                                           : list.substr(comma + 1);
+    if (!item.empty())
+      parsed.emplace_back(item);
+  }
+
+  std::chrono::milliseconds period(1000 / std::max(fps, 1));
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (parsed == entries && stillTime == still && period == frameTime)
+      return false;
+
+    entries = std::move(parsed);
+    still = stillTime;
+    frameTime = period;
+    ++generation;
+    count = 0;
+    failed = 0;
+    std::cout << "[Playlist] " << entries.size() << " entries\n";
+  }
+  wake.notify_one();
+  return true;
+}
+
+bool Playlist::empty() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.empty();
+}
+
+const PlaylistFrame *Playlist::front() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return count > 0 ? &frames[head] : nullptr;
+}
+
+void Playlist::pop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0)
+      return;
+    head = (head + 1) % PLAYLIST_QUEUE;
+    --count;
+  }
+  wake.notify_one();
+}
+
+void Playlist::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while (true) {
+    wake.wait(lock, [this] {
+      return stopping || (!entries.empty() && failed < entries.size() &&
+                          count < PLAYLIST_QUEUE);
+    });
+    if (stopping)
+      return;
+
+    if (workerGeneration != generation) {
+      workerGeneration = generation;
+      entry = 0;
+      animation.clear();
+      animationFrame = 0;
+    }
+
+    // The next entry once the frames of an animation are through
+    bool animated = animationFrame < animation.size();
+    std::string current;
+    if (!animated) {
+      current = entries[entry];
+      entry = (entry + 1) % entries.size();
+    }
+    std::chrono::milliseconds duration = animated ? frameTime : still;
+    std::chrono::milliseconds animationTime = frameTime;
+    uint64_t decoding = generation;
+
+    // Not shown until counted, the render thread never touches it meanwhile
+    PlaylistFrame &frame = frames[(head + count) % PLAYLIST_QUEUE];
+    lock.unlock();
+
+    std::string path;
+    bool decoded = false;
+    if (animated) {
+      path = animation[animationFrame++];
+    } else if (startEntry(current, path) && !animation.empty()) {
+      duration = animationTime;
+    }
+
+    if (!path.empty()) {
+      if (!frame.pixels)
+        frame.pixels.reset(SDL_CreateRGBSurfaceWithFormat(
+            0, PLAYLIST_WIDTH, PLAYLIST_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888));
+      decoded = frame.pixels && decodeInto(path, frame.pixels.get());
+    }
+
+    lock.lock();
+    if (decoding != generation)
+      continue;
+
+    if (!decoded) {
+      if (++failed == entries.size())
+        std::cerr << "[Playlist] Nothing to play, stopped\n";
+      continue;
+    }
+
+    frame.duration = duration;
+    failed = 0;
+    ++count;
+  }
+}
+
+bool Playlist::startEntry(const std::string &current, std::string &path) {
+  animation.clear();
+  animationFrame = 0;
+
+  path = assetPath(current);
+  std::error_code error;
+  if (!std::filesystem::is_directory(path, error))
+    return true;
+
+  // Frames in name order, numbered files play as numbered
+  for (const auto &file : std::filesystem::directory_iterator(path, error)) {
+    if (file.is_regular_file(error) && isImage(file.path()))
+      animation.push_back(file.path().string());
+  }
+  std::sort(animation.begin(), animation.end());
+
+  if (animation.empty()) {
+    std::cerr << "[Playlist] No images in " << path << "\n";
+    path.clear();
+    return false;
+  }
+
+  path = animation[animationFrame++];
+  return true;
+}
+
+bool Playlist::decodeInto(const std::string &path, SDL_Surface *frame) {
+  sdl_unique<SDL_Surface> image(IMG_Load(path.c_str()));
+  if (image)
+    image.reset(
+        SDL_ConvertSurfaceFormat(image.get(), SDL_PIXELFORMAT_ARGB8888, 0));
+  if (!image) {
+    std::cerr << "[Playlist] Could not decode " << path << ": "
+              << SDL_GetError() << "\n";
+    return false;
+  }
+
+  // Fitted and centered, the rest stays black
+  double scale = std::min(static_cast<double>(PLAYLIST_WIDTH) / image->w,
+                          static_cast<double>(PLAYLIST_HEIGHT) / image->h);
+  int width = std::max(1, static_cast<int>(image->w * scale));
+  int height = std::max(1, static_cast<int>(image->h * scale));
+  SDL_Rect target{(PLAYLIST_WIDTH - width) / 2, (PLAYLIST_HEIGHT - height) / 2,
+                  width, height};
+
+  SDL_FillRect(frame, NULL, SDL_MapRGBA(frame->format, 0, 0, 0, 255));
+  SDL_SetSurfaceBlendMode(image.get(), SDL_BLENDMODE_NONE);
+
+  int result = width == image->w && height == image->h
+                   ? SDL_BlitSurface(image.get(), NULL, frame, &target)
+                   : SDL_BlitScaled(image.get(), NULL, frame, &target);
+  if (result != 0) {
+    std::cerr << "[Playlist] Could not fit " << path << ": " << SDL_GetError()
+              << "\n";
+    return false;
+  }
+  return true;
+}
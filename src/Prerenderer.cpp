@@ -0,0 +1,65 @@
+#include "Prerenderer.hpp"
+
+Prerenderer::Prerenderer() : worker(&Prerenderer::run, this) {}
+
+Prerenderer::~Prerenderer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+
+  if (worker.joinable())
+    worker.join();
+}
+
+bool Prerenderer::request(TexturePool &target, std::size_t slot,
+                          const GlyphAtlas &glyphs, std::string_view label) {
+  if (label.size() >= sizeof(text))
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (queued)
+      return false;
+
+    pool = &target;
+    handle = slot;
+    atlas = &glyphs;
+    label.copy(text, label.size());
+    length = label.size();
+    queued = true;
+    done.store(false, std::memory_order_relaxed);
+  }
+  wake.notify_one();
+  return true;
+}
+
+bool Prerenderer::ready() const {
+  // Pairs with the release in run(), the staging pixels are visible after
+  return done.load(std::memory_order_acquire);
+}
+
+void Prerenderer::wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  wake.wait(lock, [this] { return !queued; });
+}
+
+void Prerenderer::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while (true) {
+    wake.wait(lock, [this] { return queued || stopping; });
+    if (stopping)
+      return;
+
+    // request() refuses new jobs until this one is done, compose unlocked
+    lock.unlock();
+    pool->compose(handle, *atlas, std::string_view(text, length));
+    lock.lock();
+
+    queued = false;
+    done.store(true, std::memory_order_release);
+    wake.notify_all();
+  }
+}
@@ -1 +1,54 @@
-#include "QRManager.hpp"
\ No newline at end of file
+#include "QRManager.hpp"
+
+QRManager::QRManager() {
+  payload.reserve(MAX_QR_PAYLOAD);
+  quote.reserve(MAX_QR_PAYLOAD);
+}
+
+bool QRManager::setPayload(std::string_view newPayload) {
+  if (newPayload.size() > MAX_QR_PAYLOAD)
+    return false;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  held = !newPayload.empty();
+  apply(held ? newPayload : std::string_view(quote));
+
+  if (held)
+    std::cout << "[QR] Payload held (" << payload.size() << " bytes)\n";
+  else
+    std::cout << "[QR] Payload released, quotes are current\n";
+  return true;
+}
+
+bool QRManager::setQuote(std::string_view newQuote) {
+  if (newQuote.size() > MAX_QR_PAYLOAD)
+    return false;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  quote = newQuote;
+  if (!held)
+    apply(quote);
+  return true;
+}
+
+bool QRManager::isHeld() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return held;
+}
+
+void QRManager::copyPayload(std::string &out) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  out.assign(payload);
+}
+
+uint64_t QRManager::getVersion() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return version;
+}
+
+void QRManager::apply(std::string_view text) {
+  if (text == payload)
+    return;
+  payload = text;
+  ++version;
+}
@@ -0,0 +1,135 @@
+#include "Spectrum.hpp"
+
+#include <cmath>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+inline float goertzelPower(float c, float s1, float s2) {
+  return s1 * s1 + s2 * s2 - c * s1 * s2;
+}
+
+void bankScalar(const float *samples, std::size_t count,
+                const float *coefficients, std::size_t bins, float *power) {
+  for (std::size_t k = 0; k < bins; ++k) {
+    float c = coefficients[k];
+    float s1 = 0.0f;
+    float s2 = 0.0f;
+    for (std::size_t n = 0; n < count; ++n) {
+      float s0 = samples[n] + c * s1 - s2;
+      s2 = s1;
+      s1 = s0;
+    }
+    power[k] = goertzelPower(c, s1, s2);
+  }
+}
+
+#if defined(__ARM_NEON)
+
+// Every step depends on the previous one, four vectors keep the pipe full
+void bank(const float *samples, std::size_t count, const float *coefficients,
+          std::size_t bins, float *power) {
+  std::size_t k = 0;
+  for (; k + 16 <= bins; k += 16) {
+    float32x4_t c[4];
+    float32x4_t s1[4];
+    float32x4_t s2[4];
+    for (int v = 0; v < 4; ++v) {
+      c[v] = vld1q_f32(coefficients + k + 4 * v);
+      s1[v] = vdupq_n_f32(0.0f);
+      s2[v] = s1[v];
+    }
+
+    for (std::size_t n = 0; n < count; ++n) {
+      float32x4_t x = vdupq_n_f32(samples[n]);
+      for (int v = 0; v < 4; ++v) {
+        float32x4_t s0 = vsubq_f32(vmlaq_f32(x, c[v], s1[v]), s2[v]);
+        s2[v] = s1[v];
+        s1[v] = s0;
+      }
+    }
+
+    for (int v = 0; v < 4; ++v) {
+      float32x4_t p = vmlaq_f32(vmulq_f32(s2[v], s2[v]), s1[v], s1[v]);
+      p = vmlsq_f32(p, vmulq_f32(c[v], s1[v]), s2[v]);
+      vst1q_f32(power + k + 4 * v, p);
+    }
+  }
+
+  bankScalar(samples, count, coefficients + k, bins - k, power + k);
+}
+
+constexpr const char *KERNEL_NAME = "NEON";
+
+#elif defined(__SSE2__)
+
+// Every step depends on the previous one, four vectors keep the pipe full
+void bank(const float *samples, std::size_t count, const float *coefficients,
+          std::size_t bins, float *power) {
+  std::size_t k = 0;
+  for (; k + 16 <= bins; k += 16) {
+    __m128 c[4];
+    __m128 s1[4];
+    __m128 s2[4];
+    for (int v = 0; v < 4; ++v) {
+      c[v] = _mm_loadu_ps(coefficients + k + 4 * v);
+      s1[v] = _mm_setzero_ps();
+      s2[v] = s1[v];
+    }
+
+    for (std::size_t n = 0; n < count; ++n) {
+      __m128 x = _mm_set1_ps(samples[n]);
+      for (int v = 0; v < 4; ++v) {
+        __m128 s0 =
+            _mm_sub_ps(_mm_add_ps(x, _mm_mul_ps(c[v], s1[v])), s2[v]);
+        s2[v] = s1[v];
+        s1[v] = s0;
+      }
+    }
+
+    for (int v = 0; v < 4; ++v) {
+      __m128 p = _mm_add_ps(_mm_mul_ps(s1[v], s1[v]), _mm_mul_ps(s2[v], s2[v]));
+      p = _mm_sub_ps(p, _mm_mul_ps(_mm_mul_ps(c[v], s1[v]), s2[v]));
+      _mm_storeu_ps(power + k + 4 * v, p);
+    }
+  }
+
+  bankScalar(samples, count, coefficients + k, bins - k, power + k);
+}
+
+constexpr const char *KERNEL_NAME = "SSE2";
+
+#else
+
+void bank(const float *samples, std::size_t count, const float *coefficients,
+          std::size_t bins, float *power) {
+  bankScalar(samples, count, coefficients, bins, power);
+}
+
+constexpr const char *KERNEL_NAME = "scalar";
+
+#endif
+
+} // namespace
+
+float goertzelCoefficient(double frequency) {
+  return static_cast<float>(2.0 * std::cos(2.0 * M_PI * frequency));
+}
+
+void goertzelBank(const float *samples, std::size_t count,
+                  const float *coefficients, std::size_t bins, float *power) {
+  bank(samples, count, coefficients, bins, power);
+}
+
+void goertzelBankScalar(const float *samples, std::size_t count,
+                        const float *coefficients, std::size_t bins,
+                        float *power) {
+  bankScalar(samples, count, coefficients, bins, power);
+}
+
+const char *getSpectrumName() { return KERNEL_NAME; }
@@ -0,0 +1,512 @@
+#include "TelemetryServer.hpp"
+
+namespace {
+
+const char *unitName(WeightUnit unit) {
+  switch (unit) {
+  case WeightUnit::KILOGRAM:
+    return "kg";
+  case WeightUnit::POUND:
+    return "lb";
+  case WeightUnit::GRAM:
+    break;
+  }
+  return "g";
+}
+
+bool sameReading(const WeightReading &a, const WeightReading &b) {
+  return a.gross == b.gross && a.tare == b.tare && a.value == b.value &&
+         a.decimals == b.decimals && a.unit == b.unit && a.stable == b.stable &&
+         a.overload == b.overload && a.underload == b.underload &&
+         a.stale == b.stale;
+}
+
+void appendNumber(std::string &out, int64_t value) {
+  char digits[24];
+  auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value);
+  out.append(digits, end);
+}
+
+} // namespace
+
+TelemetryServer::TelemetryServer(WeightSource source, QRManager &qr,
+                                 const TelemetryConfig &config)
+    : source(std::move(source)), qr(qr), config(config) {
+
+  scratch.reserve(256 + 2 * MAX_QR_PAYLOAD);
+  payload.reserve(MAX_QR_PAYLOAD);
+
+  epollFd = epoll_create1(EPOLL_CLOEXEC);
+  wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+  if (epollFd < 0 || wakeFd < 0 || timerFd < 0 || !openListeners()) {
+    std::cout << "[API] Server not started\n";
+    return;
+  }
+
+  // Periodic check of the weight source
+  itimerspec period{};
+  period.it_interval.tv_nsec = TELEMETRY_POLL_NS;
+  period.it_value.tv_nsec = TELEMETRY_POLL_NS;
+  timerfd_settime(timerFd, 0, &period, nullptr);
+
+  for (int fd : {wakeFd, timerFd, unixFd, tcpFd}) {
+    if (fd < 0)
+      continue;
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+  }
+
+  state = true;
+  worker = std::thread(&TelemetryServer::run, this);
+
+  std::cout << "[API] Listening on " << config.socketPath << "\n";
+}
+
+TelemetryServer::~TelemetryServer() {
+  state = false;
+
+  uint64_t one = 1;
+  if (wakeFd >= 0 && write(wakeFd, &one, sizeof(one)) < 0) {
+    std::cout << "[API] Wake signal failed\n";
+  }
+
+  if (worker.joinable())
+    worker.join();
+
+  for (auto &[fd, client] : clients) {
+    close(fd);
+  }
+  clients.clear();
+
+  for (int fd : {unixFd, tcpFd, timerFd, wakeFd, epollFd}) {
+    if (fd >= 0)
+      close(fd);
+  }
+
+  if (unixFd >= 0)
+    unlink(config.socketPath.c_str());
+
+  std::cout << "[API] Stopped" << std::endl;
+}
+
+bool TelemetryServer::openListeners() {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (config.socketPath.size() >= sizeof(address.sun_path)) {
+    std::cout << "[API] Socket path too long\n";
+    return false;
+  }
+  std::strcpy(address.sun_path, config.socketPath.c_str());
+
+  // A previous run may have left the file behind
+  unlink(config.socketPath.c_str());
+
+  unixFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (unixFd < 0 ||
+      bind(unixFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) <
+          0 ||
+      listen(unixFd, SOMAXCONN) < 0) {
+    std::cout << "[API] " << config.socketPath
+              << " could not be opened: " << std::strerror(errno) << "\n";
+    return false;
+  }
+
+  if (config.tcpPort == 0)
+    return true;
+
+  sockaddr_in inet{};
+  inet.sin_family = AF_INET;
+  inet.sin_port = htons(config.tcpPort);
+  if (inet_pton(AF_INET, config.tcpAddress.c_str(), &inet.sin_addr) != 1) {
+    // Unix socket still works
+    std::cout << "[API] Invalid TCP address " << config.tcpAddress << "\n";
+    return true;
+  }
+
+  int reuse = 1;
+  tcpFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (tcpFd < 0 ||
+      setsockopt(tcpFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0 ||
+      bind(tcpFd, reinterpret_cast<sockaddr *>(&inet), sizeof(inet)) < 0 ||
+      listen(tcpFd, SOMAXCONN) < 0) {
+    // Unix socket still works
+    std::cout << "[API] TCP port " << config.tcpPort
+              << " could not be opened: " << std::strerror(errno) << "\n";
+    if (tcpFd >= 0)
+      close(tcpFd);
+    tcpFd = -1;
+    return true;
+  }
+
+  std::cout << "[API] Listening on " << config.tcpAddress << ":"
+            << config.tcpPort << "\n";
+  return true;
+}
+
+void TelemetryServer::run() {
+  epoll_event events[32];
+
+  while (state.load()) {
+    int ready = epoll_wait(epollFd, events, std::size(events), -1);
+    if (ready < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    for (int i = 0; i < ready; ++i) {
+      int fd = events[i].data.fd;
+
+      if (fd == wakeFd)
+        return;
+
+      if (fd == timerFd) {
+        uint64_t expirations;
+        if (read(timerFd, &expirations, sizeof(expirations)) > 0)
+          publishWeight();
+        continue;
+      }
+
+      if (fd == unixFd || fd == tcpFd) {
+        acceptClients(fd);
+        continue;
+      }
+
+      auto it = clients.find(fd);
+      if (it == clients.end() || it->second.closed)
+        continue;
+
+      if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+        dropClient(fd);
+        continue;
+      }
+      if (events[i].events & EPOLLIN)
+        readClient(it->second);
+      if ((events[i].events & EPOLLOUT) && !it->second.closed)
+        flushClient(it->second);
+    }
+
+    // Close after the batch so no event refers to a reused descriptor
+    for (int fd : closing) {
+      if (clients.erase(fd) > 0)
+        close(fd);
+    }
+    closing.clear();
+  }
+}
+
+void TelemetryServer::acceptClients(int listener) {
+  while (true) {
+    int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+      return;
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+      close(fd);
+      continue;
+    }
+
+    // The only allocation of a request buffer, it never grows past this
+    auto it = clients.try_emplace(fd, fd, &pool).first;
+    it->second.input.reserve(MAX_REQUEST_LENGTH);
+    std::cout << "[API] Client " << fd << " connected\n";
+  }
+}
+
+void TelemetryServer::readClient(Client &client) {
+  char buffer[512];
+
+  while (!client.closed) {
+    ssize_t bytes = recv(client.fd, buffer, sizeof(buffer), 0);
+    if (bytes == 0) {
+      dropClient(client.fd);
+      return;
+    }
+    if (bytes < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        dropClient(client.fd);
+      return;
+    }
+
+    // Handle every complete line, the length is checked before appending
+    std::string_view data(buffer, static_cast<std::size_t>(bytes));
+    while (!client.closed && !data.empty()) {
+      std::size_t end = data.find('\n');
+      std::string_view part = data.substr(0, end);
+      if (client.input.size() + part.size() > MAX_REQUEST_LENGTH) {
+        std::cout << "[API] Client " << client.fd << " request too long\n";
+        dropClient(client.fd);
+        return;
+      }
+
+      if (end == std::string_view::npos) {
+        client.input.append(part);
+        break;
+      }
+
+      if (client.input.empty()) {
+        handleRequest(client, part);
+      } else {
+        client.input.append(part);
+        handleRequest(client, client.input);
+        client.input.clear();
+      }
+      data.remove_prefix(end + 1);
+    }
+  }
+}
+
+void TelemetryServer::handleRequest(Client &client, std::string_view line) {
+  std::string command;
+  if (!findJsonString(line, "cmd", command)) {
+    queue(client,
+          makeMessage("{\"type\":\"error\",\"message\":\"missing cmd\"}\n"));
+    return;
+  }
+
+  static const Message ok =
+      std::make_shared<const std::pmr::string>("{\"type\":\"ok\"}\n");
+
+  if (command == "get") {
+    queue(client, serialize(source(), "state"));
+  } else if (command == "subscribe") {
+    client.subscribed = true;
+    queue(client, ok);
+  } else if (command == "unsubscribe") {
+    client.subscribed = false;
+    queue(client, ok);
+  } else if (command == "set_qr") {
+    std::string payload;
+    if (findJsonString(line, "payload", payload) && qr.setPayload(payload)) {
+      queue(client, ok);
+    } else {
+      queue(client, makeMessage("{\"type\":\"error\",\"message\":"
+                                "\"invalid payload\"}\n"));
+    }
+  } else {
+    queue(client,
+          makeMessage("{\"type\":\"error\",\"message\":\"unknown cmd\"}\n"));
+  }
+}
+
+void TelemetryServer::queue(Client &client, const Message &message) {
+  if (client.closed)
+    return;
+
+  if (client.output.size() >= MAX_PENDING_MESSAGES) {
+    std::cout << "[API] Client " << client.fd << " stopped reading\n";
+    dropClient(client.fd);
+    return;
+  }
+
+  client.output.push_back(message);
+  flushClient(client);
+}
+
+void TelemetryServer::flushClient(Client &client) {
+  while (!client.closed && !client.output.empty()) {
+    const std::pmr::string &message = *client.output.front();
+    ssize_t sent = send(client.fd, message.data() + client.offset,
+                        message.size() - client.offset, MSG_NOSIGNAL);
+
+    if (sent < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // Resume when the client has read some
+        watchWritable(client, true);
+        return;
+      }
+      if (errno == EINTR)
+        continue;
+      dropClient(client.fd);
+      return;
+    }
+
+    client.offset += static_cast<std::size_t>(sent);
+    if (client.offset == message.size()) {
+      client.output.pop_front();
+      client.offset = 0;
+    }
+  }
+
+  if (!client.closed)
+    watchWritable(client, false);
+}
+
+void TelemetryServer::publishWeight() {
+  WeightReading reading = source();
+  if (published && sameReading(reading, lastReading))
+    return;
+
+  lastReading = reading;
+  published = true;
+
+  // Serialized once, every subscriber shares the same buffer
+  Message message;
+  for (auto &[fd, client] : clients) {
+    if (!client.subscribed)
+      continue;
+    if (!message)
+      message = serialize(reading, "weight");
+    queue(client, message);
+  }
+}
+
+TelemetryServer::Message
+TelemetryServer::serialize(const WeightReading &reading,
+                           std::string_view type) {
+  char text[WEIGHT_TEXT_LENGTH];
+  formatWeight(reading, text, sizeof(text));
+
+  // Built in the reused scratch, then copied once into the pool
+  std::string &out = scratch;
+  out.clear();
+  out += "{\"type\":";
+  appendJsonString(out, type);
+  out += ",\"gross\":";
+  appendNumber(out, reading.gross);
+  out += ",\"tare\":";
+  appendNumber(out, reading.tare);
+  out += ",\"net\":";
+  appendNumber(out, reading.net);
+  out += ",\"display\":";
+  appendJsonString(out, text);
+  out += ",\"unit\":";
+  appendJsonString(out, unitName(reading.unit));
+  out += ",\"stable\":";
+  out += reading.stable ? "true" : "false";
+  out += ",\"overload\":";
+  out += reading.overload ? "true" : "false";
+  out += ",\"underload\":";
+  out += reading.underload ? "true" : "false";
+  out += ",\"stale\":";
+  out += reading.stale ? "true" : "false";
+
+  if (type == "state") {
+    qr.copyPayload(payload);
+    out += ",\"qr\":";
+    appendJsonString(out, payload);
+    out += ",\"rss\":";
+    appendNumber(out, static_cast<int64_t>(getResidentBytes()));
+  }
+
+  out += "}\n";
+  return makeMessage(out);
+}
+
+TelemetryServer::Message TelemetryServer::makeMessage(std::string_view text) {
+  // String, its characters and the control block all come from the pool
+  return std::allocate_shared<std::pmr::string>(
+      std::pmr::polymorphic_allocator<std::pmr::string>(&pool), text);
+}
+
+void TelemetryServer::watchWritable(Client &client, bool enable) {
+  if (client.writing == enable)
+    return;
+
+  epoll_event event{};
+  event.events = enable ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+  event.data.fd = client.fd;
+  epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &event);
+  client.writing = enable;
+}
+
+void TelemetryServer::dropClient(int fd) {
+  auto it = clients.find(fd);
+  if (it == clients.end() || it->second.closed)
+    return;
+
+  // Stop reacting to it, the descriptor is closed after the batch
+  epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+  it->second.closed = true;
+  it->second.subscribed = false;
+  it->second.output.clear();
+  closing.push_back(fd);
+
+  std::cout << "[API] Client " << fd << " disconnected\n";
+}
+
+bool findJsonString(std::string_view json, std::string_view key,
+                    std::string &out) {
+  // Locate "key" followed by a colon
+  std::size_t pos = 0;
+  while ((pos = json.find(key, pos)) != std::string_view::npos) {
+    bool quoted = pos > 0 && pos + key.size() < json.size() &&
+                  json[pos - 1] == '"' && json[pos + key.size()] == '"';
+    pos += key.size();
+    if (!quoted)
+      continue;
+
+    std::size_t colon = json.find_first_not_of(" \t", pos + 1);
+    if (colon == std::string_view::npos || json[colon] != ':')
+      continue;
+
+    std::size_t quote = json.find_first_not_of(" \t", colon + 1);
+    if (quote == std::string_view::npos || json[quote] != '"')
+      return false;
+
+    out.clear();
+    for (std::size_t i = quote + 1; i < json.size(); ++i) {
+      char c = json[i];
+      if (c == '"')
+        return true;
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (++i == json.size())
+        return false;
+      switch (json[i]) {
+      case 'n':
+        out += '\n';
+        break;
+      case 't':
+        out += '\t';
+        break;
+      case 'r':
+        out += '\r';
+        break;
+      default: // \" \\ \/
+        out += json[i];
+        break;
+      }
+    }
+    return false;
+  }
+  return false;
+}
+
+void appendJsonString(std::string &out, std::string_view text) {
+  out += '"';
+  for (char c : text) {
+    switch (c) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\r':
+      out += "\\r";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+        continue; // Other control characters are dropped
+      out += c;
+      break;
+    }
+  }
+  out += '"';
+}
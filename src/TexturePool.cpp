@@ -0,0 +1,84 @@
+#include "TexturePool.hpp"
+
+std::size_t TexturePool::reserve(SDL_Renderer *renderer, int width,
+                                 int height) {
+  if (count >= slots.size() || width <= 0 || height <= 0)
+    return TEXTURE_POOL_CAPACITY;
+
+  PooledTexture &slot = slots[count];
+
+  slot.texture.reset(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                       SDL_TEXTUREACCESS_STREAMING, width,
+                                       height));
+  slot.staging.reset(SDL_CreateRGBSurfaceWithFormat(0, width, height, 32,
+                                                    SDL_PIXELFORMAT_ARGB8888));
+  if (!slot.texture || !slot.staging) {
+    std::cerr << "SDL_Error occured: " << SDL_GetError() << "\n";
+    slot = PooledTexture{};
+    return TEXTURE_POOL_CAPACITY;
+  }
+
+  // Glyph pixels carry their own coverage
+  SDL_SetTextureBlendMode(slot.texture.get(), SDL_BLENDMODE_BLEND);
+  SDL_FillRect(slot.staging.get(), NULL, 0);
+
+  return count++;
+}
+
+bool TexturePool::update(std::size_t handle, const GlyphAtlas &atlas,
+                         std::string_view text, bool solid) {
+  return compose(handle, atlas, text, solid) && upload(handle);
+}
+
+bool TexturePool::compose(std::size_t handle, const GlyphAtlas &atlas,
+                          std::string_view text, bool solid) {
+  if (handle >= count)
+    return false;
+
+  PooledTexture &slot = slots[handle];
+
+  int width = atlas.compose(text, slot.staging.get());
+  int height = std::min(atlas.getHeight(), slot.staging->h);
+
+  slot.used = SDL_Rect{0, 0, width, height};
+
+  // Text color or the black background, both opaque
+  if (solid) {
+    for (int y = 0; y < height; ++y) {
+      auto *row = reinterpret_cast<Uint32 *>(
+          static_cast<Uint8 *>(slot.staging->pixels) + y * slot.staging->pitch);
+      for (int x = 0; x < width; ++x)
+        row[x] = row[x] >= 0x80000000u ? row[x] | 0xFF000000u : 0xFF000000u;
+    }
+  }
+  return true;
+}
+
+bool TexturePool::upload(std::size_t handle) {
+  if (handle >= count)
+    return false;
+
+  PooledTexture &slot = slots[handle];
+
+  // Empty text keeps the old pixels, they are outside the used rect
+  if (slot.used.w == 0)
+    return true;
+
+  return SDL_UpdateTexture(slot.texture.get(), &slot.used,
+                           slot.staging->pixels, slot.staging->pitch) == 0;
+}
+
+SDL_Texture *TexturePool::getTexture(std::size_t handle) const {
+  return handle < count ? slots[handle].texture.get() : nullptr;
+}
+
+const SDL_Rect *TexturePool::getUsed(std::size_t handle) const {
+  return handle < count ? &slots[handle].used : nullptr;
+}
+
+void TexturePool::clear() {
+  for (PooledTexture &slot : slots) {
+    slot = PooledTexture{};
+  }
+  count = 0;
+}
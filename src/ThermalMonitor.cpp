@@ -0,0 +1,174 @@
+#include "ThermalMonitor.hpp"
+
+namespace {
+
+// A sysfs attribute holding one integer, 0 if missing
+int32_t readValue(const std::string &path, int base = 10) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return 0;
+
+  char text[32];
+  ssize_t length = ::read(fd, text, sizeof(text));
+  close(fd);
+  if (length <= 0)
+    return 0;
+
+  // Hex attributes may carry a 0x prefix
+  const char *first = text;
+  if (base == 16 && length > 2 && text[0] == '0' &&
+      (text[1] == 'x' || text[1] == 'X'))
+    first += 2;
+
+  int32_t value = 0;
+  std::from_chars(first, text + length, value, base);
+  return value;
+}
+
+} // namespace
+
+ThermalMonitor::ThermalMonitor(const std::string &root)
+    : root(root), worker(&ThermalMonitor::run, this) {}
+
+ThermalMonitor::~ThermalMonitor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+
+  if (worker.joinable())
+    worker.join();
+}
+
+void ThermalMonitor::setRoot(const std::string &next) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (next == root)
+      return;
+    root = next;
+  }
+  wake.notify_one();
+}
+
+ThermalSample ThermalMonitor::latest() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return sample;
+}
+
+void ThermalMonitor::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  std::string reading;
+  std::string firmware;
+
+  while (!stopping) {
+    bool moved = reading != root;
+    reading = root;
+
+    // Files are read unlocked, latest() never waits for a slow sensor
+    lock.unlock();
+    if (moved) {
+      firmware = findFirmwareFlags(reading);
+      if (firmware.empty())
+        std::cout << "[Thermal] No firmware throttling flags below "
+                  << reading << ", throttling is not detected\n";
+    }
+    ThermalSample next = read(reading, firmware);
+    if (moved && next.milliCelsius == 0)
+      std::cout << "[Thermal] No thermal zone below " << reading << "\n";
+    lock.lock();
+
+    sample = next;
+    wake.wait_for(lock, THERMAL_PERIOD,
+                  [this, &reading] { return stopping || root != reading; });
+  }
+}
+
+ThermalSample ThermalMonitor::read(const std::string &root,
+                                   const std::string &firmware) {
+  ThermalSample out;
+  out.milliCelsius = readValue(root + '/' + THERMAL_ZONE_TEMP);
+  out.curKHz = readValue(root + '/' + CPU_CUR_FREQ);
+  out.maxKHz = readValue(root + '/' + CPU_MAX_FREQ);
+  out.limitKHz = readValue(root + '/' + CPU_LIMIT_FREQ);
+  if (!firmware.empty())
+    out.firmwareFlags = static_cast<uint32_t>(readValue(firmware, 16));
+  return out;
+}
+
+std::string ThermalMonitor::findFirmwareFlags(const std::string &root) {
+  for (const char *pattern : FIRMWARE_THROTTLED) {
+    std::string full = root + '/' + pattern;
+    glob_t matches{};
+    std::string found;
+    if (glob(full.c_str(), 0, nullptr, &matches) == 0 && matches.gl_pathc > 0)
+      found = matches.gl_pathv[0];
+    globfree(&matches);
+    if (!found.empty())
+      return found;
+  }
+  return {};
+}
+
+const char *qualityName(Quality quality) {
+  switch (quality) {
+  case Quality::REDUCED:
+    return "reduced";
+  case Quality::MINIMAL:
+    return "minimal";
+  case Quality::FULL:
+    break;
+  }
+  return "full";
+}
+
+void QualityController::setEnabled(bool on) { enabled = on; }
+
+void QualityController::record(std::chrono::steady_clock::duration work) {
+  ++frames;
+  if (work > QUALITY_FRAME_BUDGET)
+    ++slowFrames;
+}
+
+Quality QualityController::update(const ThermalSample &sample,
+                                  std::chrono::steady_clock::time_point now) {
+  if (now < nextAt)
+    return level;
+  nextAt = now + THERMAL_PERIOD;
+
+  bool hot = sample.milliCelsius >= THERMAL_HOT;
+  bool warm = sample.milliCelsius >= THERMAL_COOL;
+  bool slow = slowFrames * QUALITY_SLOW_DIVISOR > frames;
+  uint32_t slowShare = frames > 0 ? slowFrames * 100 / frames : 0;
+  bool calmPeriod = !warm && !sample.throttled() && slowFrames == 0;
+  frames = 0;
+  slowFrames = 0;
+
+  Quality next = level;
+  if (!enabled) {
+    next = Quality::FULL;
+  } else if (hot || sample.throttled() || slow) {
+    calm = 0;
+    if (level != Quality::MINIMAL)
+      next = static_cast<Quality>(static_cast<uint8_t>(level) + 1);
+  } else if (!calmPeriod) {
+    calm = 0;
+  } else if (level != Quality::FULL && ++calm >= QUALITY_RECOVER) {
+    calm = 0;
+    next = static_cast<Quality>(static_cast<uint8_t>(level) - 1);
+  }
+
+  if (next != level) {
+    std::cout << "[Quality] " << qualityName(level) << " -> "
+              << qualityName(next) << ": " << sample.milliCelsius / 1000
+              << "." << std::abs(sample.milliCelsius % 1000) / 100 << " C, "
+              << sample.curKHz / 1000 << "/" << sample.maxKHz / 1000 << "/"
+              << sample.limitKHz / 1000 << " MHz, throttled 0x" << std::hex
+              << sample.firmwareFlags << std::dec << ", " << slowShare
+              << "% slow frames\n";
+    level = next;
+  }
+  return level;
+}
+
+Quality QualityController::get() const { return level; }
@@ -0,0 +1,43 @@
+#include "TrendPlot.hpp"
+
+int buildTrendEnvelope(const TrendSeries &trend, const SDL_Rect &rect,
+                       SDL_Point *points) {
+  // Scale the y-axis to what is visible
+  int32_t low = INT32_MAX;
+  int32_t high = INT32_MIN;
+  for (const TrendBucket &bucket : trend) {
+    if (!bucket.filled)
+      continue;
+    low = std::min(low, bucket.min);
+    high = std::max(high, bucket.max);
+  }
+
+  if (low > high)
+    return 0;
+
+  if (high - low < TREND_MIN_SPAN) {
+    int32_t center = low + (high - low) / 2;
+    low = center - TREND_MIN_SPAN / 2;
+    high = low + TREND_MIN_SPAN;
+  }
+
+  int64_t span = int64_t{high} - low;
+  auto toY = [&](int32_t value) {
+    return rect.y + rect.h - 1 -
+           static_cast<int>((int64_t{value} - low) * (rect.h - 1) / span);
+  };
+
+  // Two points per column, min then max, draws the envelope
+  int count = 0;
+  for (std::size_t column = 0; column < trend.size(); ++column) {
+    const TrendBucket &bucket = trend[column];
+    if (!bucket.filled)
+      continue;
+
+    int x = rect.x + static_cast<int>(column * rect.w / trend.size());
+    points[count++] = SDL_Point{x, toY(bucket.min)};
+    points[count++] = SDL_Point{x, toY(bucket.max)};
+  }
+
+  return count;
+}
@@ -0,0 +1,327 @@
+#include "VibrationFilter.hpp"
+
+namespace {
+
+// Power of a sine of amplitude A in a bin is (A * windowSum / 2)^2
+float amplitudeOf(float power, float windowSum) {
+  return 2.0f * std::sqrt(std::max(power, 0.0f)) / windowSum;
+}
+
+// Peaks this close, in bins, are the same disturbance
+constexpr double MATCH_BINS = 1.5;
+
+// Smaller moves of a tracked disturbance keep the notch as it is
+constexpr double RETUNE_BINS = 0.1;
+
+} // namespace
+
+NotchCoefficients NotchCoefficients::at(double frequency, double q) {
+  double w0 = 2.0 * M_PI * frequency;
+  double alpha = std::sin(w0) / (2.0 * q);
+  double a0 = 1.0 + alpha;
+
+  NotchCoefficients out;
+  out.b0 = 1.0 / a0;
+  out.b1 = -2.0 * std::cos(w0) / a0;
+  out.a2 = (1.0 - alpha) / a0;
+  return out;
+}
+
+void NotchCascade::set(const NotchSet &next) {
+  std::array<Stage, VIBRATION_NOTCHES> updated{};
+
+  for (std::size_t i = 0; i < next.count; ++i) {
+    Stage &stage = updated[i];
+    stage.coefficients = next.notches[i];
+    stage.id = next.ids[i];
+
+    auto end = stages.begin() + count;
+    auto kept = std::find_if(stages.begin(), end, [&](const Stage &old) {
+      return old.id == stage.id;
+    });
+    if (kept != end) {
+      stage.z1 = kept->z1;
+      stage.z2 = kept->z2;
+    } else {
+      // Settled on a constant input, the output starts where it is
+      stage.z2 = (stage.coefficients.b0 - stage.coefficients.a2) * last;
+      stage.z1 = stage.z2;
+    }
+  }
+
+  stages = updated;
+  count = next.count;
+}
+
+double NotchCascade::process(double x) {
+  last = x;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    Stage &stage = stages[i];
+    const NotchCoefficients &c = stage.coefficients;
+    double y = c.b0 * x + stage.z1;
+    stage.z1 = c.b1 * (x - y) + stage.z2;
+    stage.z2 = c.b0 * x - c.a2 * y;
+    x = y;
+  }
+  return x;
+}
+
+std::size_t NotchCascade::size() const { return count; }
+
+VibrationAnalyzer::VibrationAnalyzer() {
+  for (std::size_t n = 0; n < VIBRATION_WINDOW; ++n) {
+    window[n] = static_cast<float>(
+        0.5 - 0.5 * std::cos(2.0 * M_PI * static_cast<double>(n) /
+                             VIBRATION_WINDOW));
+    windowSum += window[n];
+  }
+
+  for (std::size_t k = 0; k < VIBRATION_BINS; ++k)
+    coefficients[k] = goertzelCoefficient(static_cast<double>(k) /
+                                          VIBRATION_WINDOW);
+}
+
+std::size_t VibrationAnalyzer::analyze(
+    const float *samples, std::array<VibrationPeak, VIBRATION_NOTCHES> &peaks) {
+  // The weight itself is DC, only what moves around it matters
+  float mean = 0.0f;
+  for (std::size_t n = 0; n < VIBRATION_WINDOW; ++n)
+    mean += samples[n];
+  mean /= VIBRATION_WINDOW;
+
+  for (std::size_t n = 0; n < VIBRATION_WINDOW; ++n)
+    block[n] = (samples[n] - mean) * window[n];
+
+  goertzelBank(block.data(), block.size(), coefficients.data(),
+               coefficients.size(), power.data());
+
+  sorted = power;
+  auto middle = sorted.begin() + sorted.size() / 2;
+  std::nth_element(sorted.begin(), middle, sorted.end());
+
+  float floor = VIBRATION_MIN_AMPLITUDE * windowSum / 2.0f;
+  float threshold = std::max(*middle * VIBRATION_PEAK_RATIO, floor * floor);
+
+  std::size_t found = 0;
+  for (std::size_t k = VIBRATION_MIN_BIN; k + 1 < VIBRATION_BINS; ++k) {
+    if (power[k] < threshold || power[k] < power[k - 1] ||
+        power[k] <= power[k + 1])
+      continue;
+
+    // Parabola through the magnitudes around the peak
+    float left = std::sqrt(power[k - 1]);
+    float centre = std::sqrt(power[k]);
+    float right = std::sqrt(power[k + 1]);
+    float curve = left - 2.0f * centre + right;
+    float offset = curve < 0.0f ? 0.5f * (left - right) / curve : 0.0f;
+
+    VibrationPeak peak;
+    peak.frequency = (static_cast<double>(k) + offset) / VIBRATION_WINDOW;
+    peak.amplitude = amplitudeOf(power[k], windowSum);
+
+    // Strongest first, the weakest drops out
+    std::size_t at = std::min(found, peaks.size());
+    while (at > 0 && peaks[at - 1].amplitude < peak.amplitude) {
+      if (at < peaks.size())
+        peaks[at] = peaks[at - 1];
+      --at;
+    }
+    if (at < peaks.size()) {
+      peaks[at] = peak;
+      found = std::min(found + 1, peaks.size());
+    }
+  }
+
+  return found;
+}
+
+VibrationFilter::VibrationFilter() : worker(&VibrationFilter::run, this) {}
+
+VibrationFilter::~VibrationFilter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+
+  if (worker.joinable())
+    worker.join();
+}
+
+void VibrationFilter::setEnabled(bool on) {
+  if (enabled.exchange(on, std::memory_order_relaxed) != on)
+    std::cout << "[Vibration] Filter " << (on ? "on" : "off") << "\n";
+}
+
+int32_t VibrationFilter::filter(int32_t raw,
+                                std::chrono::steady_clock::time_point now) {
+  if (!enabled.load(std::memory_order_relaxed)) {
+    // Starts over, the published notches are taken again once enabled
+    if (samples != 0) {
+      samples = 0;
+      sinceHop = 0;
+      appliedVersion = 0;
+      cascade.set(NotchSet{});
+    }
+    return raw;
+  }
+
+  std::size_t slot = samples % VIBRATION_WINDOW;
+  history[slot] = static_cast<float>(raw);
+  times[slot] = now;
+  ++samples;
+  ++sinceHop;
+
+  if (samples >= VIBRATION_WINDOW && sinceHop >= VIBRATION_HOP)
+    submit();
+
+  // Taken between two samples, a busy worker delays it by one
+  if (version.load(std::memory_order_acquire) != appliedVersion &&
+      mutex.try_lock()) {
+    cascade.set(published);
+    appliedVersion = version.load(std::memory_order_relaxed);
+    mutex.unlock();
+  }
+
+  double filtered = cascade.process(raw);
+  if (cascade.size() == 0)
+    return raw;
+  return static_cast<int32_t>(std::lround(filtered));
+}
+
+void VibrationFilter::submit() {
+  std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+  if (!lock.owns_lock() || queued)
+    return;
+
+  // Oldest first, samples points at the oldest slot
+  std::size_t oldest = samples % VIBRATION_WINDOW;
+  for (std::size_t n = 0; n < VIBRATION_WINDOW; ++n)
+    pending[n] = history[(oldest + n) % VIBRATION_WINDOW];
+
+  std::chrono::duration<double> span =
+      times[(oldest + VIBRATION_WINDOW - 1) % VIBRATION_WINDOW] -
+      times[oldest];
+  pendingRate =
+      span.count() > 0.0 ? (VIBRATION_WINDOW - 1) / span.count() : 0.0;
+
+  queued = true;
+  sinceHop = 0;
+  lock.unlock();
+  wake.notify_one();
+}
+
+void VibrationFilter::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while (true) {
+    wake.wait(lock, [this] { return queued || stopping; });
+    if (stopping)
+      return;
+
+    work = pending;
+    double rate = pendingRate;
+    lock.unlock();
+
+    std::array<VibrationPeak, VIBRATION_NOTCHES> peaks{};
+    std::size_t found = analyzer.analyze(work.data(), peaks);
+    bool changed = track(peaks, found, rate);
+
+    NotchSet next;
+    for (const Tracked &entry : tracked) {
+      if (!entry.active)
+        continue;
+      next.notches[next.count] = NotchCoefficients::at(entry.frequency);
+      next.ids[next.count] = entry.id;
+      ++next.count;
+    }
+
+    lock.lock();
+    queued = false;
+    if (changed) {
+      published = next;
+      version.fetch_add(1, std::memory_order_release);
+    }
+  }
+}
+
+bool VibrationFilter::track(
+    const std::array<VibrationPeak, VIBRATION_NOTCHES> &peaks,
+    std::size_t found, double rate) {
+  bool changed = false;
+  std::array<bool, VIBRATION_NOTCHES> matched{};
+
+  auto inUse = [](const Tracked &entry) {
+    return entry.active || entry.hits > 0;
+  };
+
+  for (std::size_t i = 0; i < found; ++i) {
+    const VibrationPeak &peak = peaks[i];
+
+    // The nearest tracked disturbance, else a free or the weakest unproven
+    Tracked *target = nullptr;
+    double nearest = MATCH_BINS / VIBRATION_WINDOW;
+    for (std::size_t t = 0; t < tracked.size(); ++t) {
+      double distance = std::abs(tracked[t].frequency - peak.frequency);
+      if (inUse(tracked[t]) && !matched[t] && distance <= nearest) {
+        target = &tracked[t];
+        nearest = distance;
+      }
+    }
+
+    if (!target) {
+      for (Tracked &entry : tracked) {
+        if (entry.active || matched[&entry - tracked.data()])
+          continue;
+        if (!target || !inUse(entry) ||
+            (inUse(*target) && entry.amplitude < target->amplitude))
+          target = &entry;
+      }
+      if (!target)
+        continue;
+      *target = Tracked{};
+      target->frequency = peak.frequency;
+      target->id = nextId++;
+    }
+
+    if (target->active &&
+        std::abs(target->frequency - peak.frequency) >
+            RETUNE_BINS / VIBRATION_WINDOW) {
+      target->frequency = peak.frequency;
+      changed = true;
+    } else if (!target->active) {
+      target->frequency = peak.frequency;
+    }
+    target->amplitude = peak.amplitude;
+    target->hits = std::min(target->hits + 1, VIBRATION_CONFIRM);
+    target->misses = 0;
+    matched[target - tracked.data()] = true;
+  }
+
+  for (std::size_t t = 0; t < tracked.size(); ++t) {
+    Tracked &entry = tracked[t];
+    if (!inUse(entry))
+      continue;
+
+    if (!matched[t]) {
+      entry.hits = 0;
+      if (entry.active && ++entry.misses >= VIBRATION_RELEASE) {
+        std::cout << "[Vibration] " << entry.frequency * rate
+                  << " Hz gone, filter released\n";
+        entry = Tracked{};
+        changed = true;
+      }
+      continue;
+    }
+
+    if (!entry.active && entry.hits >= VIBRATION_CONFIRM) {
+      entry.active = true;
+      changed = true;
+      std::cout << "[Vibration] Filtering " << entry.frequency * rate
+                << " Hz, " << entry.amplitude << " g\n";
+    }
+  }
+
+  return changed;
+}
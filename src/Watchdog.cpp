@@ -0,0 +1,283 @@
+#include "Watchdog.hpp"
+
+namespace {
+
+// Backtrace of one thread, filled by its own signal handler
+struct ThreadTrace {
+  pid_t tid = 0;
+  std::atomic<int> depth{-1}; // -1 until the handler ran.
+  void *frames[WATCHDOG_TRACE_DEPTH] = {};
+};
+
+std::array<ThreadTrace, WATCHDOG_MAX_THREADS> traces;
+std::atomic<std::size_t> traceCount{0};
+
+int traceSignal() { return SIGRTMIN + 4; }
+
+pid_t currentThread() { return static_cast<pid_t>(syscall(SYS_gettid)); }
+
+// Async signal safe once backtrace() was called outside a handler
+void captureTrace(int) {
+  int savedErrno = errno;
+  pid_t tid = currentThread();
+
+  std::size_t count = traceCount.load(std::memory_order_acquire);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (traces[i].tid != tid)
+      continue;
+    int depth = backtrace(traces[i].frames, WATCHDOG_TRACE_DEPTH);
+    traces[i].depth.store(depth, std::memory_order_release);
+    break;
+  }
+
+  errno = savedErrno;
+}
+
+std::string threadName(pid_t tid) {
+  std::ifstream file("/proc/self/task/" + std::to_string(tid) + "/comm");
+  std::string name;
+  std::getline(file, name);
+  return name;
+}
+
+} // namespace
+
+Watchdog::Watchdog(const AppConfig &config, StateSource display,
+                   const std::string &ringPath)
+    : frameDeadline(config.frameDeadline),
+      serialDeadline(config.serialDeadline),
+      restart(config.watchdogRestart), display(std::move(display)) {
+
+  // Loads the unwinder now, a handler must not do it
+  void *frame = nullptr;
+  backtrace(&frame, 1);
+
+  struct sigaction action {};
+  action.sa_handler = captureTrace;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  sigaction(traceSignal(), &action, nullptr);
+
+  ringFd = open(ringPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (ringFd < 0 ||
+      ftruncate(ringFd, static_cast<off_t>(WATCHDOG_SLOTS *
+                                           WATCHDOG_SLOT_SIZE)) < 0) {
+    std::cout << "[Watchdog] " << ringPath
+              << " could not be opened: " << std::strerror(errno) << "\n";
+  } else {
+    findNextSlot();
+  }
+
+  worker = std::thread(&Watchdog::run, this);
+
+  std::cout << "[Watchdog] Frame deadline " << frameDeadline.count()
+            << " ms, serial deadline " << serialDeadline.count() << " ms\n";
+}
+
+Watchdog::~Watchdog() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+
+  if (worker.joinable())
+    worker.join();
+
+  if (ringFd >= 0)
+    close(ringFd);
+}
+
+Heartbeat &Watchdog::frame() { return frameBeat; }
+
+Heartbeat &Watchdog::serial() { return serialBeat; }
+
+bool Watchdog::consumeRestart() {
+  return restartPending.exchange(false, std::memory_order_acquire);
+}
+
+void Watchdog::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while (!wake.wait_for(lock, WATCHDOG_TICK, [this] { return stopping; })) {
+    auto now = std::chrono::steady_clock::now();
+    sample(now);
+
+    if (missed(frameBeat, frameDeadline, now, frameStalled)) {
+      record("frame deadline missed");
+      if (restart)
+        restartPending.store(true, std::memory_order_release);
+    }
+
+    if (missed(serialBeat, serialDeadline, now, serialStalled))
+      record("serial deadline missed");
+
+    // The restart needs the render thread, it never came back
+    if (restart && frameStalled &&
+        now - frameBeat.getLast() > WATCHDOG_EXIT_AFTER * frameDeadline) {
+      record("render thread did not recover, exiting");
+      std::_Exit(EXIT_FAILURE);
+    }
+  }
+}
+
+void Watchdog::sample(std::chrono::steady_clock::time_point now) {
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+
+  uint64_t frames = frameBeat.getCount();
+
+  WatchdogSample &next = samples[sampleCount++ % samples.size()];
+  next.at = now;
+  next.frameAgeMs =
+      duration_cast<milliseconds>(now - frameBeat.getLast()).count();
+  next.serialAgeMs =
+      duration_cast<milliseconds>(now - serialBeat.getLast()).count();
+  next.frames = frames - framesBefore;
+  next.rssKiB = getResidentBytes() / 1024;
+  next.display = display ? display() : "";
+
+  framesBefore = frames;
+}
+
+bool Watchdog::missed(const Heartbeat &heartbeat,
+                      std::chrono::milliseconds deadline,
+                      std::chrono::steady_clock::time_point now,
+                      bool &stalled) {
+  if (deadline.count() <= 0)
+    return false;
+
+  if (now - heartbeat.getLast() <= deadline) {
+    if (stalled)
+      std::cout << "[Watchdog] Recovered\n";
+    stalled = false;
+    return false;
+  }
+
+  if (stalled)
+    return false;
+  stalled = true;
+  return true;
+}
+
+void Watchdog::record(const char *reason) {
+  std::cout << "[Watchdog] " << reason << ", incident " << incident << "\n";
+
+  std::string out;
+  out.reserve(WATCHDOG_SLOT_SIZE);
+
+  char line[256];
+  std::time_t wall = std::time(nullptr);
+  std::tm local{};
+  localtime_r(&wall, &local);
+  std::strftime(line, sizeof(line), "%Y-%m-%d %H:%M:%S", &local);
+
+  out += "incident " + std::to_string(incident) + " " + line + " " + reason +
+         "\n";
+  out += "display " + std::string(display ? display() : "") + "\n";
+
+  // Oldest sample first, ages relative to the newest
+  out += "samples (age ms: frame serial, frames/tick, rss KiB, display)\n";
+  std::size_t count = std::min(sampleCount, samples.size());
+  for (std::size_t i = sampleCount - count; i < sampleCount; ++i) {
+    const WatchdogSample &entry = samples[i % samples.size()];
+    std::snprintf(line, sizeof(line), "  %6lld %6lld %4llu %8llu %s\n",
+                  static_cast<long long>(entry.frameAgeMs),
+                  static_cast<long long>(entry.serialAgeMs),
+                  static_cast<unsigned long long>(entry.frames),
+                  static_cast<unsigned long long>(entry.rssKiB),
+                  entry.display);
+    out += line;
+  }
+
+  captureThreads(out);
+
+  if (ringFd < 0) {
+    std::cout << out;
+    ++incident;
+    return;
+  }
+
+  // Fills the whole slot, nothing of an older incident is left in it
+  if (out.size() >= WATCHDOG_SLOT_SIZE)
+    out.resize(WATCHDOG_SLOT_SIZE - 1);
+  out.resize(WATCHDOG_SLOT_SIZE, '\0');
+
+  off_t offset =
+      static_cast<off_t>((incident % WATCHDOG_SLOTS) * WATCHDOG_SLOT_SIZE);
+  if (pwrite(ringFd, out.data(), out.size(), offset) !=
+          static_cast<ssize_t>(out.size()) ||
+      fdatasync(ringFd) < 0) {
+    std::cout << "[Watchdog] Incident could not be written: "
+              << std::strerror(errno) << "\n";
+  }
+  ++incident;
+}
+
+void Watchdog::captureThreads(std::string &out) {
+  pid_t self = currentThread();
+
+  // Every thread but this one gets a slot before any signal is sent
+  std::size_t count = 0;
+  std::error_code error;
+  for (const auto &entry :
+       std::filesystem::directory_iterator("/proc/self/task", error)) {
+    pid_t tid = static_cast<pid_t>(std::atoi(entry.path().filename().c_str()));
+    if (tid == self || count == traces.size())
+      continue;
+    traces[count].tid = tid;
+    traces[count].depth.store(-1, std::memory_order_relaxed);
+    ++count;
+  }
+  traceCount.store(count, std::memory_order_release);
+
+  for (std::size_t i = 0; i < count; ++i)
+    syscall(SYS_tgkill, getpid(), traces[i].tid, traceSignal());
+
+  // Threads answer as soon as they are scheduled
+  auto giveUp = std::chrono::steady_clock::now() + WATCHDOG_TRACE_WAIT;
+  for (std::size_t i = 0; i < count; ++i) {
+    while (traces[i].depth.load(std::memory_order_acquire) < 0 &&
+           std::chrono::steady_clock::now() < giveUp)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    ThreadTrace &trace = traces[i];
+    out += "thread " + std::to_string(trace.tid) + " " +
+           threadName(trace.tid) + "\n";
+
+    int depth = trace.depth.load(std::memory_order_acquire);
+    if (depth < 0) {
+      out += "  no answer (signal masked or uninterruptible)\n";
+      continue;
+    }
+
+    // Addresses resolve with addr2line -e pay-per-weigh
+    char **symbols = backtrace_symbols(trace.frames, depth);
+    for (int frame = 0; frame < depth; ++frame) {
+      out += "  ";
+      out += symbols ? symbols[frame] : "?";
+      out += "\n";
+    }
+    std::free(symbols);
+  }
+
+  // Late answers find no slot
+  traceCount.store(0, std::memory_order_release);
+}
+
+void Watchdog::findNextSlot() {
+  // Every slot starts with "incident <n>", continue after the newest
+  for (std::size_t slot = 0; slot < WATCHDOG_SLOTS; ++slot) {
+    char head[32] = {};
+    if (pread(ringFd, head, sizeof(head) - 1,
+              static_cast<off_t>(slot * WATCHDOG_SLOT_SIZE)) <= 0)
+      continue;
+
+    unsigned long long number = 0;
+    if (std::sscanf(head, "incident %llu", &number) == 1 &&
+        number + 1 > incident)
+      incident = number + 1;
+  }
+}
@@ -0,0 +1,166 @@
+#include "WeightPipeline.hpp"
+
+namespace {
+
+// Largest raw value that still fits the fixed-point format with headroom
+constexpr int32_t RAW_LIMIT = INT32_MAX >> (WEIGHT_FRACTION_BITS + 1);
+
+/**
+ * @brief Shift right with rounding half away from zero.
+ */
+int64_t roundShift(int64_t value, int shift) {
+  int64_t half = int64_t{1} << (shift - 1);
+  if (value >= 0)
+    return (value + half) >> shift;
+  return -((-value + half) >> shift);
+}
+
+/**
+ * @brief Fixed-point grams to whole grams.
+ */
+int32_t toGrams(int32_t valueQ) {
+  return static_cast<int32_t>(roundShift(valueQ, WEIGHT_FRACTION_BITS));
+}
+
+uint8_t decimalsOf(WeightUnit unit) {
+  return unit == WeightUnit::GRAM ? 0 : 3;
+}
+
+} // namespace
+
+WeightPipeline::WeightPipeline(const WeightConfig &config) : config(config) {}
+
+WeightReading WeightPipeline::process(int32_t raw) {
+  raw = std::clamp(raw, -RAW_LIMIT, RAW_LIMIT);
+
+  bool stable = checkStable(raw);
+
+  int32_t grossQ = raw * WEIGHT_ONE - zeroOffsetQ;
+
+  // Only follow drift around an empty platform
+  if (stable && tareQ == 0) {
+    trackZero(grossQ);
+    grossQ = raw * WEIGHT_ONE - zeroOffsetQ;
+  }
+
+  WeightReading reading;
+  reading.gross = toGrams(grossQ);
+  reading.overload = reading.gross > MAX_WEIGHT;
+  reading.underload = reading.gross < MIN_WEIGHT;
+
+  // Tare waits for a stable, in-range sample
+  if (stable && reading.valid() && tareRequested.exchange(false)) {
+    tareQ = std::max(grossQ, 0);
+  }
+
+  int32_t netQ = grossQ - tareQ;
+
+  reading.tare = toGrams(tareQ);
+  reading.net = toGrams(netQ);
+  reading.unit = config.unit;
+  reading.decimals = decimalsOf(config.unit);
+  reading.value = applyDivision(toDisplay(netQ));
+  reading.stable = stable;
+
+  return reading;
+}
+
+void WeightPipeline::requestTare() { tareRequested = true; }
+
+void WeightPipeline::configure(const WeightConfig &newConfig) {
+  config = newConfig;
+}
+
+const WeightConfig &WeightPipeline::getConfig() const { return config; }
+
+void WeightPipeline::trackZero(int32_t grossQ) {
+  if (std::abs(grossQ) > config.zeroTrackBand * WEIGHT_ONE || grossQ == 0)
+    return;
+
+  // Move a fraction of the error per sample, at least one step
+  int32_t step = grossQ / (1 << config.zeroTrackRate);
+  if (step == 0)
+    step = grossQ > 0 ? 1 : -1;
+
+  int32_t limitQ = config.zeroTrackLimit * WEIGHT_ONE;
+  zeroOffsetQ = std::clamp(zeroOffsetQ + step, -limitQ, limitQ);
+}
+
+bool WeightPipeline::checkStable(int32_t raw) {
+  history[historyIndex] = raw;
+  historyIndex = (historyIndex + 1) % MOTION_WINDOW;
+  historyCount = std::min(historyCount + 1, MOTION_WINDOW);
+
+  if (historyCount < MOTION_WINDOW)
+    return false;
+
+  auto [low, high] = std::minmax_element(history.begin(), history.end());
+  return *high - *low <= config.motionBand;
+}
+
+int32_t WeightPipeline::toDisplay(int32_t netQ) const {
+  switch (config.unit) {
+  case WeightUnit::POUND:
+    return static_cast<int32_t>(roundShift(
+        int64_t{netQ} * MILLI_LB_PER_GRAM_Q16, 16 + WEIGHT_FRACTION_BITS));
+  case WeightUnit::KILOGRAM: // Grams are milli-kilograms
+  case WeightUnit::GRAM:
+    break;
+  }
+  return toGrams(netQ);
+}
+
+int32_t WeightPipeline::applyDivision(int32_t value) const {
+  int32_t division = std::max(config.division, 1);
+  int32_t magnitude = std::abs(value);
+
+  if (config.rounding == WeightRounding::NEAREST)
+    magnitude += division / 2;
+
+  magnitude = magnitude / division * division;
+  return value < 0 ? -magnitude : magnitude;
+}
+
+std::size_t formatWeight(const WeightReading &reading, char *buffer,
+                         std::size_t length) {
+  if (length < WEIGHT_TEXT_LENGTH) {
+    if (length > 0)
+      buffer[0] = '\0';
+    return 0;
+  }
+
+  if (!reading.valid()) {
+    const char *text = reading.stale      ? "---"
+                       : reading.overload ? "OL"
+                                          : "UL";
+    std::strcpy(buffer, text);
+    return std::strlen(text);
+  }
+
+  char *cursor = buffer;
+  char *end = buffer + length - 1;
+
+  int32_t value = reading.value;
+  if (value < 0) {
+    *cursor++ = '-';
+    value = -value;
+  }
+
+  int32_t scale = 1;
+  for (uint8_t i = 0; i < reading.decimals; ++i)
+    scale *= 10;
+
+  cursor = std::to_chars(cursor, end, value / scale).ptr;
+
+  if (reading.decimals > 0) {
+    *cursor++ = '.';
+    int32_t fraction = value % scale;
+    // Zero pad the fraction to its decimals
+    for (int32_t digit = scale / 10; digit > 0; digit /= 10) {
+      *cursor++ = static_cast<char>('0' + (fraction / digit) % 10);
+    }
+  }
+
+  *cursor = '\0';
+  return static_cast<std::size_t>(cursor - buffer);
+}
@@ -0,0 +1,81 @@
+// Steady-state frames of the render loop against the allocation guard.
+//
+// Linked with the archive built with PPW_ALLOCATION_GUARD: a heap allocation
+// in a guarded section aborts the process, which fails the test.
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+#include "AllocationCounter.hpp"
+#include "Billing.hpp"
+#include "Config.hpp"
+#include "Graphics.hpp"
+#include "WeightPipeline.hpp"
+
+namespace {
+
+// Frames after the render loop turned steady
+constexpr uint64_t STEADY_FRAMES = 240;
+
+// Clock labels as ClockService flips them
+constexpr const char *CLOCKS[] = {"2026-01-01 12:00", "2026-01-01 12:01"};
+
+} // namespace
+
+TEST(AllocationGuardDeathTest, AbortsOnAGuardedAllocation) {
+  GTEST_FLAG_SET(death_test_style, "threadsafe");
+
+  EXPECT_DEATH(
+      {
+        AllocationGuard steadyState;
+        int *volatile value = new int(1);
+        delete value;
+      },
+      "Heap allocation in a steady state section");
+}
+
+TEST(AllocationGuard, ExemptionsAndDisabledGuardsAllowAllocations) {
+  uint64_t before = getAllocationCount();
+  {
+    AllocationGuard steadyState;
+    AllocationExemption staging;
+    int *volatile value = new int(1);
+    delete value;
+  }
+  {
+    AllocationGuard warmup(false);
+    int *volatile value = new int(1);
+    delete value;
+  }
+  EXPECT_EQ(getAllocationCount(), before + 2);
+}
+
+TEST(AllocationGuard, SteadyFramesDoNotAllocate) {
+  setenv("SDL_VIDEODRIVER", "offscreen", 0);
+  setenv("SDL_RENDER_DRIVER", "software", 0);
+
+  // The mirror reads every frame back inside the guarded render
+  AppConfig config;
+  config.mirrorFps = MAX_MIRROR_FPS;
+  SDLManager sdl("allocation-guard-test", config);
+
+  WeightPipeline pipeline;
+  TrendSeries trend{};
+  char price[PRICE_TEXT_LENGTH] = "";
+
+  for (uint64_t frame = 0; frame < STEADY_STATE_FRAMES + STEADY_FRAMES;
+       ++frame) {
+    // A new weight, price and trend column every few frames
+    auto raw = static_cast<int32_t>(1000 + (frame / 4) % 50);
+    WeightReading reading = pipeline.process(raw);
+    formatPrice(raw * 2, "SEK", price, sizeof(price));
+
+    TrendBucket &bucket = trend[frame % TREND_COLUMNS];
+    bucket = TrendBucket{raw - 1, raw + 1, true};
+
+    sdl.render(reading, CLOCKS[(frame / 60) % 2], price, trend);
+  }
+
+  // Reaching this line means no guarded section allocated
+  EXPECT_TRUE(sdl.getStatus());
+}
@@ -0,0 +1,90 @@
+// SIMD compositor against its scalar reference.
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Compositor.hpp"
+
+namespace {
+
+// Widths cover every tail length of the 4, 8 and 16 pixel kernels
+constexpr int MAX_WIDTH = 67;
+constexpr int ROWS = 5;
+
+constexpr uint32_t TEXT_COLOR = OPAQUE | 0x20C0E0u;
+
+struct Planes {
+  std::vector<uint32_t> pixels;
+  std::vector<uint8_t> mask;
+};
+
+Planes randomPlanes(int width, std::mt19937 &random) {
+  Planes planes{std::vector<uint32_t>(width * ROWS),
+                std::vector<uint8_t>(width * ROWS)};
+  for (uint32_t &pixel : planes.pixels)
+    pixel = random();
+  for (uint8_t &coverage : planes.mask)
+    coverage = static_cast<uint8_t>(random());
+
+  // Make sure both ends of the coverage range are hit
+  planes.mask.front() = 0;
+  planes.mask.back() = 255;
+  return planes;
+}
+
+} // namespace
+
+TEST(Compositor, MatchesTheScalarReference) {
+  std::mt19937 random(1337);
+
+  for (int width = 1; width <= MAX_WIDTH; ++width) {
+    Planes planes = randomPlanes(width, random);
+    std::vector<uint32_t> expected = planes.pixels;
+    int pitch = width * static_cast<int>(sizeof(uint32_t));
+
+    blendMask(planes.pixels.data(), pitch, planes.mask.data(), width, width,
+              ROWS, TEXT_COLOR);
+    blendMaskScalar(expected.data(), pitch, planes.mask.data(), width, width,
+                    ROWS, TEXT_COLOR);
+
+    ASSERT_EQ(planes.pixels, expected)
+        << "width " << width << " with " << getCompositorName();
+  }
+}
+
+TEST(Compositor, HonoursPitches) {
+  // Blend the left half of a wider surface, the right half stays
+  constexpr int WIDTH = 19;
+  constexpr int STRIDE = 2 * WIDTH;
+  std::vector<uint32_t> pixels(STRIDE * ROWS, 0x11223344u);
+  std::vector<uint8_t> mask(STRIDE * ROWS, 255);
+
+  blendMask(pixels.data(), STRIDE * sizeof(uint32_t), mask.data(), STRIDE,
+            WIDTH, ROWS, TEXT_COLOR);
+
+  for (int row = 0; row < ROWS; ++row) {
+    for (int column = 0; column < STRIDE; ++column) {
+      uint32_t expected = column < WIDTH ? TEXT_COLOR : 0x11223344u;
+      ASSERT_EQ(pixels[row * STRIDE + column], expected);
+    }
+  }
+}
+
+TEST(Compositor, CoverageEnds) {
+  uint32_t pixel = 0x80402010u;
+  uint8_t none = 0;
+  blendMaskScalar(&pixel, 4, &none, 1, 1, 1, TEXT_COLOR);
+  EXPECT_EQ(pixel, 0x80402010u);
+
+  uint8_t full = 255;
+  blendMaskScalar(&pixel, 4, &full, 1, 1, 1, TEXT_COLOR);
+  EXPECT_EQ(pixel, TEXT_COLOR);
+
+  // Half coverage lands halfway, rounded
+  uint32_t black = OPAQUE;
+  uint8_t half = 128;
+  blendMaskScalar(&black, 4, &half, 1, 1, 1, OPAQUE | 0xFFFFFFu);
+  EXPECT_EQ(black & 0xFFu, 128u);
+}
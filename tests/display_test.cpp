@@ -0,0 +1,126 @@
+// Dimming, blanking and waking the display through SDLManager::render().
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+#include "Graphics.hpp"
+#include "WeightPipeline.hpp"
+
+namespace {
+
+// Idle timeouts, short to keep the run quick
+constexpr std::chrono::milliseconds DIM_AFTER{100};
+constexpr std::chrono::milliseconds BLANK_AFTER{300};
+
+// Longest wait for a state the timeouts should reach
+constexpr std::chrono::seconds STATE_TIMEOUT{2};
+
+constexpr SDL_Rect WEIGHT_AREA{0, WEIGHT_Y, WINDOW_WIDTH, WEIGHT_HEIGHT};
+
+using Clock = std::chrono::steady_clock;
+using Frame = std::vector<uint32_t>;
+
+} // namespace
+
+/**
+ * @brief An SDLManager with short idle timeouts.
+ */
+class DisplayPower : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    setenv("SDL_VIDEODRIVER", "offscreen", 0);
+    setenv("SDL_RENDER_DRIVER", "software", 0);
+    sdl = new SDLManager("display-test");
+  }
+
+  static void TearDownTestSuite() {
+    delete sdl;
+    sdl = nullptr;
+  }
+
+  void SetUp() override { sdl->setIdleTimeouts(DIM_AFTER, BLANK_AFTER); }
+
+  void render(const WeightReading &reading) {
+    sdl->render(reading, "2026-01-01 12:00", "", trend);
+  }
+
+  Frame read() {
+    Frame frame(static_cast<std::size_t>(WEIGHT_AREA.w) * WEIGHT_AREA.h);
+    EXPECT_TRUE(sdl->readPixels(
+        WEIGHT_AREA, frame.data(),
+        WEIGHT_AREA.w * static_cast<int>(sizeof(uint32_t))));
+    return frame;
+  }
+
+  // Renders an empty scale until the display reaches a state
+  std::vector<DisplayState> idleUntil(DisplayState wanted) {
+    std::vector<DisplayState> seen{sdl->getDisplayState()};
+    auto giveUp = Clock::now() + STATE_TIMEOUT;
+    while (sdl->getDisplayState() != wanted && Clock::now() < giveUp) {
+      render(empty);
+      if (sdl->getDisplayState() != seen.back())
+        seen.push_back(sdl->getDisplayState());
+    }
+    return seen;
+  }
+
+  static inline SDLManager *sdl = nullptr;
+  WeightPipeline pipeline;
+  WeightReading empty = pipeline.process(0);
+  TrendSeries trend{};
+};
+
+TEST_F(DisplayPower, DimsThenBlanksThenWakesOnAReading) {
+  WeightReading loaded = pipeline.process(1337);
+  render(loaded);
+  ASSERT_EQ(sdl->getDisplayState(), DisplayState::ACTIVE);
+  Frame active = read();
+
+  // An empty scale goes through every state in order
+  std::vector<DisplayState> seen = idleUntil(DisplayState::BLANKED);
+  std::vector<DisplayState> expected{DisplayState::ACTIVE,
+                                     DisplayState::DIMMED,
+                                     DisplayState::BLANKED};
+  ASSERT_EQ(seen, expected);
+
+  // Blanked is a black frame, whatever the panel does with its backlight
+  Frame blank = read();
+  for (uint32_t pixel : blank)
+    ASSERT_EQ(pixel & 0xFFFFFFu, 0u);
+
+  // The first frame after the reading already shows it
+  auto loadedAt = Clock::now();
+  render(loaded);
+  auto woken = Clock::now() - loadedAt;
+
+  EXPECT_EQ(sdl->getDisplayState(), DisplayState::ACTIVE);
+  EXPECT_LT(woken, WAKE_BUDGET);
+  EXPECT_EQ(read(), active);
+}
+
+TEST_F(DisplayPower, ActivityWakesADimmedDisplay) {
+  render(pipeline.process(1337));
+  ASSERT_EQ(idleUntil(DisplayState::DIMMED).back(), DisplayState::DIMMED);
+
+  // Dimmed frames are not presented again
+  render(empty);
+  EXPECT_EQ(sdl->getDisplayState(), DisplayState::DIMMED);
+
+  sdl->notifyActivity();
+  render(empty);
+  EXPECT_EQ(sdl->getDisplayState(), DisplayState::ACTIVE);
+}
+
+TEST_F(DisplayPower, NoTimeoutsNeverDim) {
+  sdl->setIdleTimeouts(std::chrono::milliseconds(0),
+                       std::chrono::milliseconds(0));
+  render(pipeline.process(1337));
+
+  auto until = Clock::now() + BLANK_AFTER + DIM_AFTER;
+  while (Clock::now() < until) {
+    render(empty);
+    ASSERT_EQ(sdl->getDisplayState(), DisplayState::ACTIVE);
+  }
+}
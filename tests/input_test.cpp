@@ -0,0 +1,120 @@
+// Keymaps and the events InputManager passes on.
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include "Config.hpp"
+#include "Input.hpp"
+
+namespace {
+
+// Window ids of the customer and the operator window
+constexpr Uint32 CUSTOMER_WINDOW = 1;
+constexpr Uint32 OPERATOR_WINDOW = 2;
+
+SDL_Event windowEvent(Uint32 id, Uint8 type) {
+  SDL_Event event{};
+  event.type = SDL_WINDOWEVENT;
+  event.window.windowID = id;
+  event.window.event = type;
+  return event;
+}
+
+SDL_Event keyDown(SDL_Keycode key) {
+  SDL_Event event{};
+  event.type = SDL_KEYDOWN;
+  event.key.windowID = CUSTOMER_WINDOW;
+  event.key.keysym.sym = key;
+  return event;
+}
+
+} // namespace
+
+TEST(Keymap, ValidatedWithTheConfiguration) {
+  EXPECT_TRUE(validKeymap(DEFAULT_KEYMAP));
+  EXPECT_TRUE(validKeymap(":: toggle, Left Shift:tare"));
+
+  EXPECT_FALSE(validKeymap("Space:jump"));
+  EXPECT_FALSE(validKeymap("Space:toggle, Nokey:tare"));
+  EXPECT_FALSE(validKeymap("Space"));
+
+  char path[] = "/tmp/ppw-keymap-XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+
+  // A bad keymap rejects the file like any other setting
+  std::ofstream(path) << "keymap = T:tare, Space:jump\n";
+  AppConfig config;
+  EXPECT_FALSE(loadConfig(path, config));
+  EXPECT_EQ(config.keymap, DEFAULT_KEYMAP);
+  std::remove(path);
+}
+
+/**
+ * @brief An InputManager on the offscreen video driver.
+ */
+class Events : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    setenv("SDL_VIDEODRIVER", "offscreen", 0);
+    ASSERT_EQ(SDL_Init(SDL_INIT_VIDEO), 0) << SDL_GetError();
+  }
+
+  static void TearDownTestSuite() { SDL_Quit(); }
+
+  void SetUp() override {
+    input.setWindow(CUSTOMER_WINDOW);
+    ASSERT_TRUE(input.setKeymap(DEFAULT_KEYMAP));
+    input.drain(WIDTH, HEIGHT);
+  }
+
+  InputBatch push(SDL_Event event) {
+    SDL_PushEvent(&event);
+    return input.drain(WIDTH, HEIGHT);
+  }
+
+  static constexpr int WIDTH = 1280;
+  static constexpr int HEIGHT = 720;
+  InputManager input;
+};
+
+TEST_F(Events, ClosingTheCustomerWindowQuits) {
+  InputBatch batch =
+      push(windowEvent(CUSTOMER_WINDOW, SDL_WINDOWEVENT_CLOSE));
+  EXPECT_TRUE(batch.quit);
+  EXPECT_EQ(batch.closedWindow, 0u);
+}
+
+TEST_F(Events, ClosingAnotherWindowOnlyClosesIt) {
+  InputBatch batch =
+      push(windowEvent(OPERATOR_WINDOW, SDL_WINDOWEVENT_CLOSE));
+  EXPECT_FALSE(batch.quit);
+  EXPECT_EQ(batch.closedWindow, OPERATOR_WINDOW);
+  EXPECT_FALSE(batch.activity);
+}
+
+TEST_F(Events, ExposedWindowsAndRenderResetsPass) {
+  EXPECT_TRUE(push(windowEvent(CUSTOMER_WINDOW, SDL_WINDOWEVENT_EXPOSED))
+                  .redraw);
+
+  SDL_Event reset{};
+  reset.type = SDL_RENDER_TARGETS_RESET;
+  EXPECT_TRUE(push(reset).redraw);
+
+  reset.type = SDL_RENDER_DEVICE_RESET;
+  EXPECT_TRUE(push(reset).renderReset);
+}
+
+TEST_F(Events, BadKeymapKeepsTheBindings) {
+  EXPECT_TRUE(push(keyDown(SDLK_t)).tare);
+
+  EXPECT_FALSE(input.setKeymap("T:toggle, Space:jump"));
+  InputBatch batch = push(keyDown(SDLK_t));
+  EXPECT_TRUE(batch.tare);
+  EXPECT_EQ(batch.toggles, 0);
+}
@@ -0,0 +1,216 @@
+// Text layout with the configured font, the label cache and the trend plot.
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Assets.hpp"
+#include "Config.hpp"
+#include "GlyphAtlas.hpp"
+#include "Graphics.hpp"
+#include "LabelCache.hpp"
+#include "TrendPlot.hpp"
+
+namespace {
+
+constexpr SDL_Rect PLOT{TREND_X, TREND_Y, TREND_WIDTH, TREND_HEIGHT};
+
+bool inside(const SDL_Point &point, const SDL_Rect &rect) {
+  return point.x >= rect.x && point.x < rect.x + rect.w &&
+         point.y >= rect.y && point.y < rect.y + rect.h;
+}
+
+bool inside(const SDL_Rect &inner, const SDL_Rect &outer) {
+  return inner.x >= outer.x && inner.y >= outer.y &&
+         inner.x + inner.w <= outer.x + outer.w &&
+         inner.y + inner.h <= outer.y + outer.h;
+}
+
+} // namespace
+
+/**
+ * @brief Headless SDL with a software renderer and the configured font.
+ */
+class TextLayout : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    setenv("SDL_VIDEODRIVER", "offscreen", 0);
+    setenv("SDL_RENDER_DRIVER", "software", 0);
+
+    ASSERT_EQ(SDL_Init(SDL_INIT_VIDEO), 0) << SDL_GetError();
+    ASSERT_EQ(TTF_Init(), 0) << SDL_GetError();
+
+    window.reset(SDL_CreateWindow("layout", 0, 0, 64, 64, SDL_WINDOW_HIDDEN));
+    renderer.reset(
+        SDL_CreateRenderer(window.get(), -1, SDL_RENDERER_SOFTWARE));
+    ASSERT_TRUE(renderer) << SDL_GetError();
+
+    assets = new AssetSet();
+    ASSERT_TRUE(decodeGlyphs(assetPath(AppConfig{}.font), *assets));
+  }
+
+  static void TearDownTestSuite() {
+    delete assets;
+    assets = nullptr;
+    renderer.reset();
+    window.reset();
+    TTF_Quit();
+    SDL_Quit();
+  }
+
+  void SetUp() override {
+    if (!assets || !assets->weightGlyphs || !assets->labelGlyphs)
+      GTEST_SKIP() << "font missing";
+  }
+
+  static inline sdl_unique<SDL_Window> window;
+  static inline sdl_unique<SDL_Renderer> renderer;
+  static inline AssetSet *assets = nullptr;
+};
+
+TEST_F(TextLayout, GlyphsAdvanceSideBySide) {
+  const GlyphAtlas &atlas = *assets->weightGlyphs;
+
+  EXPECT_GT(atlas.measure("1"), 0);
+  EXPECT_EQ(atlas.measure("11"), 2 * atlas.measure("1"));
+  EXPECT_EQ(atlas.measure("1337"), atlas.measure("13") + atlas.measure("37"));
+  EXPECT_LE(atlas.measure("8"), atlas.getMaxAdvance());
+  EXPECT_EQ(atlas.measure(""), 0);
+}
+
+TEST_F(TextLayout, ComposeFillsTheMeasuredWidth) {
+  const GlyphAtlas &atlas = *assets->weightGlyphs;
+
+  sdl_unique<SDL_Surface> target(SDL_CreateRGBSurfaceWithFormat(
+      0, atlas.getMaxAdvance() * static_cast<int>(WEIGHT_TEXT_LENGTH - 1),
+      atlas.getHeight(), 32, SDL_PIXELFORMAT_ARGB8888));
+  ASSERT_TRUE(target);
+
+  EXPECT_EQ(atlas.compose("1337", target.get()), atlas.measure("1337"));
+
+  std::vector<Uint8> mask(static_cast<std::size_t>(target->w) * target->h);
+  EXPECT_EQ(atlas.composeMask("1337", mask.data(), target->w, target->w,
+                              target->h),
+            atlas.measure("1337"));
+
+  // Coverage is somewhere inside the text, nothing right of it
+  int width = atlas.measure("1337");
+  bool covered = false;
+  bool spilled = false;
+  for (int y = 0; y < target->h; ++y) {
+    for (int x = 0; x < target->w; ++x) {
+      Uint8 coverage = mask[static_cast<std::size_t>(y) * target->w + x];
+      covered |= x < width && coverage > 0;
+      spilled |= x >= width && coverage > 0;
+    }
+  }
+  EXPECT_TRUE(covered);
+  EXPECT_FALSE(spilled);
+}
+
+TEST_F(TextLayout, TextThatDoesNotFitIsCut) {
+  const GlyphAtlas &atlas = *assets->weightGlyphs;
+  int narrow = atlas.measure("13");
+
+  sdl_unique<SDL_Surface> target(SDL_CreateRGBSurfaceWithFormat(
+      0, narrow, atlas.getHeight(), 32, SDL_PIXELFORMAT_ARGB8888));
+  ASSERT_TRUE(target);
+  EXPECT_LE(atlas.compose("1337", target.get()), narrow);
+}
+
+TEST_F(TextLayout, LabelsAreSizedByTheirText) {
+  const GlyphAtlas &atlas = *assets->labelGlyphs;
+
+  LabelCache cache;
+  ASSERT_GT(cache.reserve(renderer.get(),
+                          atlas.getMaxAdvance() *
+                              static_cast<int>(LABEL_CACHE_TEXT_LENGTH),
+                          atlas.getHeight()),
+            0u);
+
+  const CachedLabel *label = cache.get(atlas, "17.25 SEK");
+  ASSERT_NE(label, nullptr);
+  EXPECT_EQ(label->used.w, atlas.measure("17.25 SEK"));
+  EXPECT_EQ(label->used.h, atlas.getHeight());
+
+  // Repeated labels are looked up, not composed again
+  EXPECT_EQ(cache.get(atlas, "17.25 SEK"), label);
+  LabelCacheStats stats = cache.getStats();
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.hits, 1u);
+
+  EXPECT_EQ(cache.get(atlas, ""), nullptr);
+  std::string_view tooLong = "a label longer than the cache holds";
+  ASSERT_GT(tooLong.size(), LABEL_CACHE_TEXT_LENGTH);
+  EXPECT_EQ(cache.get(atlas, tooLong), nullptr);
+
+  cache.clear();
+}
+
+TEST(ScreenLayout, AreasLieInsideTheWindow) {
+  constexpr SDL_Rect WINDOW{0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
+
+  EXPECT_TRUE(inside(SDL_Rect{0, WEIGHT_Y, WINDOW_WIDTH, WEIGHT_HEIGHT},
+                     WINDOW));
+  EXPECT_TRUE(inside(SDL_Rect{IMAGE_X, IMAGE_Y, IMAGE_WIDTH, IMAGE_HEIGHT},
+                     WINDOW));
+  EXPECT_TRUE(
+      inside(SDL_Rect{LOGO_X, LOGO_Y, LOGO_WIDTH, LOGO_HEIGHT}, WINDOW));
+  EXPECT_TRUE(
+      inside(SDL_Rect{TIME_X, TIME_Y, TIME_WIDTH, TIME_HEIGHT}, WINDOW));
+  EXPECT_TRUE(inside(PLOT, WINDOW));
+
+  // The weight and QR code share the center, the price sits below it
+  EXPECT_EQ(WEIGHT_Y + WEIGHT_HEIGHT / 2, WINDOW_HEIGHT / 2);
+  EXPECT_EQ(IMAGE_X + IMAGE_WIDTH / 2, WINDOW_WIDTH / 2);
+  EXPECT_GE(PRICE_Y, WEIGHT_Y + WEIGHT_HEIGHT);
+  EXPECT_LT(PRICE_Y, TIME_Y);
+}
+
+TEST(TrendEnvelope, EmptyTrendDrawsNothing) {
+  TrendSeries trend{};
+  SDL_Point points[TREND_POINTS];
+  EXPECT_EQ(buildTrendEnvelope(trend, PLOT, points), 0);
+}
+
+TEST(TrendEnvelope, TwoPointsPerFilledColumn) {
+  TrendSeries trend{};
+  trend[0] = TrendBucket{100, 200, true};
+  trend[TREND_COLUMNS / 2] = TrendBucket{150, 150, true};
+  trend[TREND_COLUMNS - 1] = TrendBucket{0, 50, true};
+
+  SDL_Point points[TREND_POINTS];
+  ASSERT_EQ(buildTrendEnvelope(trend, PLOT, points), 6);
+
+  for (const SDL_Point &point : std::span(points, 6))
+    EXPECT_TRUE(inside(point, PLOT)) << point.x << "," << point.y;
+
+  // Columns spread over the width, oldest on the left
+  EXPECT_EQ(points[0].x, PLOT.x);
+  EXPECT_EQ(points[2].x, PLOT.x + PLOT.w / 2);
+  EXPECT_GT(points[4].x, points[2].x);
+
+  // The axis spans 0..200: max on top, min at the bottom
+  EXPECT_EQ(points[1].y, PLOT.y);
+  EXPECT_EQ(points[4].y, PLOT.y + PLOT.h - 1);
+  EXPECT_EQ(points[2].y, points[3].y);
+  EXPECT_LT(points[1].y, points[0].y);
+}
+
+TEST(TrendEnvelope, FlatTrendKeepsTheMinimumSpan) {
+  TrendSeries trend{};
+  for (TrendBucket &bucket : trend)
+    bucket = TrendBucket{1337, 1337, true};
+
+  SDL_Point points[TREND_POINTS];
+  ASSERT_EQ(buildTrendEnvelope(trend, PLOT, points),
+            static_cast<int>(TREND_POINTS));
+
+  // Noise is not blown up to the full height, it stays centered
+  int middle = PLOT.y + PLOT.h / 2;
+  EXPECT_NEAR(points[0].y, middle, 1);
+  EXPECT_EQ(points[0].y, points[1].y);
+  EXPECT_EQ(points[TREND_POINTS - 1].x, PLOT.x + PLOT.w - 1);
+}
@@ -0,0 +1,130 @@
+// QR payload of a sale and the payload holder.
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+#include "Billing.hpp"
+#include "QRManager.hpp"
+
+namespace {
+
+std::string_view payloadOf(int32_t amount, int32_t net, char *text) {
+  return {text, formatPayload(amount, "SEK", net, text, PAYLOAD_TEXT_LENGTH)};
+}
+
+} // namespace
+
+TEST(FormatPayload, EncodesAmountCurrencyAndNet) {
+  char text[PAYLOAD_TEXT_LENGTH];
+  EXPECT_EQ(payloadOf(1250, 1337, text),
+            "PPW;amount=12.50;currency=SEK;net=1337");
+  EXPECT_EQ(payloadOf(5, 10, text), "PPW;amount=0.05;currency=SEK;net=10");
+  EXPECT_EQ(payloadOf(0, 0, text), "PPW;amount=0.00;currency=SEK;net=0");
+}
+
+TEST(FormatPayload, NoPriceIsAnEmptyPayload) {
+  char text[PAYLOAD_TEXT_LENGTH] = "PPW;amount=1.00";
+  EXPECT_EQ(formatPayload(NO_PRICE, "SEK", 1337, text, sizeof(text)), 0u);
+  EXPECT_EQ(text[0], '\0');
+}
+
+TEST(FormatPayload, CutPayloadsAreEmpty) {
+  char full[PAYLOAD_TEXT_LENGTH];
+  std::size_t needed = formatPayload(1250, "SEK", 1337, full, sizeof(full));
+  ASSERT_GT(needed, 0u);
+
+  // Exactly enough room for the payload and its terminator
+  char exact[PAYLOAD_TEXT_LENGTH];
+  EXPECT_EQ(formatPayload(1250, "SEK", 1337, exact, needed + 1), needed);
+  EXPECT_STREQ(exact, full);
+
+  // Any less would cut it, "amount=12" must never be scanned for 12.50
+  for (std::size_t length = 1; length <= needed; ++length) {
+    char cut[PAYLOAD_TEXT_LENGTH] = "PPW;amount=1.00";
+    EXPECT_EQ(formatPayload(1250, "SEK", 1337, cut, length), 0u) << length;
+    EXPECT_EQ(cut[0], '\0');
+  }
+  EXPECT_EQ(formatPayload(1250, "SEK", 1337, full, 0), 0u);
+}
+
+TEST(FormatPayload, FollowsTheQuote) {
+  Tariff tariff;
+  tariff.pricePerKg = 1000; // 10.00 SEK per kilogram
+  Billing billing(tariff);
+
+  WeightReading reading;
+  reading.net = 2000;
+  reading.value = 2000;
+  reading.stable = true;
+
+  char text[PAYLOAD_TEXT_LENGTH];
+  EXPECT_EQ(payloadOf(billing.quote(reading), reading.net, text),
+            "PPW;amount=20.00;currency=SEK;net=2000");
+
+  // Moving weights are never billed
+  reading.stable = false;
+  EXPECT_EQ(billing.quote(reading), NO_PRICE);
+  EXPECT_EQ(payloadOf(billing.quote(reading), reading.net, text), "");
+}
+
+TEST(QRManager, VersionFollowsEveryChange) {
+  QRManager qr;
+  EXPECT_EQ(qr.getVersion(), 0u);
+
+  ASSERT_TRUE(qr.setPayload("PPW;amount=12.50;currency=SEK;net=1337"));
+  EXPECT_EQ(qr.getVersion(), 1u);
+
+  std::string payload;
+  qr.copyPayload(payload);
+  EXPECT_EQ(payload, "PPW;amount=12.50;currency=SEK;net=1337");
+
+  ASSERT_TRUE(qr.setPayload(""));
+  EXPECT_EQ(qr.getVersion(), 2u);
+  qr.copyPayload(payload);
+  EXPECT_TRUE(payload.empty());
+}
+
+TEST(QRManager, HeldPayloadOutlivesQuotes) {
+  QRManager qr;
+  std::string payload;
+
+  ASSERT_TRUE(qr.setQuote("PPW;amount=12.50;currency=SEK;net=1337"));
+  EXPECT_FALSE(qr.isHeld());
+  qr.copyPayload(payload);
+  EXPECT_EQ(payload, "PPW;amount=12.50;currency=SEK;net=1337");
+
+  // The back office holds its payload, the next price does not replace it
+  ASSERT_TRUE(qr.setPayload("https://pay.example/123"));
+  EXPECT_TRUE(qr.isHeld());
+  uint64_t version = qr.getVersion();
+  ASSERT_TRUE(qr.setQuote("PPW;amount=20.00;currency=SEK;net=2000"));
+  EXPECT_EQ(qr.getVersion(), version);
+  qr.copyPayload(payload);
+  EXPECT_EQ(payload, "https://pay.example/123");
+
+  // Cleared, the latest quote is current again
+  ASSERT_TRUE(qr.setPayload(""));
+  EXPECT_FALSE(qr.isHeld());
+  qr.copyPayload(payload);
+  EXPECT_EQ(payload, "PPW;amount=20.00;currency=SEK;net=2000");
+
+  ASSERT_TRUE(qr.setQuote(""));
+  qr.copyPayload(payload);
+  EXPECT_TRUE(payload.empty());
+}
+
+TEST(QRManager, RejectsOversizePayloads) {
+  QRManager qr;
+  ASSERT_TRUE(qr.setPayload("PPW;amount=1.00;currency=SEK;net=100"));
+
+  std::string oversize(MAX_QR_PAYLOAD + 1, 'x');
+  EXPECT_FALSE(qr.setPayload(oversize));
+  EXPECT_EQ(qr.getVersion(), 1u);
+
+  std::string payload;
+  qr.copyPayload(payload);
+  EXPECT_EQ(payload, "PPW;amount=1.00;currency=SEK;net=100");
+
+  EXPECT_TRUE(qr.setPayload(std::string(MAX_QR_PAYLOAD, 'x')));
+}
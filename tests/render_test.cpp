@@ -0,0 +1,102 @@
+// Frames of SDLManager::render() read back from the software renderer.
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "Config.hpp"
+#include "Graphics.hpp"
+#include "WeightPipeline.hpp"
+
+namespace {
+
+// Weight rows only, the trend and price lie outside
+constexpr SDL_Rect WEIGHT_AREA{0, WEIGHT_Y, WINDOW_WIDTH, WEIGHT_HEIGHT};
+
+// Rows of the price label below the weight
+constexpr SDL_Rect PRICE_AREA{0, PRICE_Y, WINDOW_WIDTH, LOGO_HEIGHT};
+
+using Frame = std::vector<uint32_t>;
+
+bool lit(const Frame &frame) {
+  return std::any_of(frame.begin(), frame.end(),
+                     [](uint32_t pixel) { return (pixel & 0xFFFFFFu) != 0; });
+}
+
+} // namespace
+
+/**
+ * @brief One window for the suite, SDL is set up once per process.
+ */
+class Render : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    setenv("SDL_VIDEODRIVER", "offscreen", 0);
+    setenv("SDL_RENDER_DRIVER", "software", 0);
+    sdl = new SDLManager("render-test");
+  }
+
+  static void TearDownTestSuite() {
+    delete sdl;
+    sdl = nullptr;
+  }
+
+  // Renders a reading and reads an area of the frame back
+  Frame draw(const WeightReading &reading, const SDL_Rect &area,
+             std::string_view price = "") {
+    sdl->render(reading, "2026-01-01 12:00", price, trend);
+
+    Frame frame(static_cast<std::size_t>(area.w) * area.h);
+    EXPECT_TRUE(sdl->readPixels(area, frame.data(),
+                                area.w * static_cast<int>(sizeof(uint32_t))));
+    return frame;
+  }
+
+  WeightReading readingOf(int32_t raw) { return pipeline.process(raw); }
+
+  static inline SDLManager *sdl = nullptr;
+  WeightPipeline pipeline;
+  TrendSeries trend{};
+};
+
+TEST_F(Render, DrawsTheWeight) {
+  EXPECT_TRUE(lit(draw(readingOf(1337), WEIGHT_AREA)));
+}
+
+TEST_F(Render, SameValueSamePixels) {
+  Frame first = draw(readingOf(1337), WEIGHT_AREA);
+  Frame second = draw(readingOf(1338), WEIGHT_AREA);
+  Frame again = draw(readingOf(1337), WEIGHT_AREA);
+
+  EXPECT_NE(first, second);
+  EXPECT_EQ(first, again);
+}
+
+TEST_F(Render, StaleReadingsAreNotShownAsWeights) {
+  WeightReading stale = readingOf(1337);
+  stale.stale = true;
+
+  Frame weight = draw(readingOf(1337), WEIGHT_AREA);
+  Frame dashes = draw(stale, WEIGHT_AREA);
+  EXPECT_TRUE(lit(dashes));
+  EXPECT_NE(weight, dashes);
+}
+
+TEST_F(Render, PriceIsDrawnBelowTheWeight) {
+  WeightReading reading = readingOf(1337);
+
+  Frame without = draw(reading, PRICE_AREA);
+  Frame with = draw(reading, PRICE_AREA, "17.25 SEK");
+  EXPECT_FALSE(lit(without));
+  EXPECT_TRUE(lit(with));
+
+  // Dropping the price clears its rows again
+  EXPECT_EQ(draw(reading, PRICE_AREA), without);
+}
+
+TEST_F(Render, RestartRedrawsFromDecodedAssets) {
+  Frame before = draw(readingOf(1337), WEIGHT_AREA);
+  sdl->restart();
+  EXPECT_EQ(draw(readingOf(1337), WEIGHT_AREA), before);
+}
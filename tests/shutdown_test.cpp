@@ -0,0 +1,112 @@
+// Teardown of the loop thread and its services within SHUTDOWN_BUDGET.
+#include <gtest/gtest.h>
+
+#include <pty.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string_view>
+#include <thread>
+
+#include "ClockService.hpp"
+#include "Config.hpp"
+#include "Device.hpp"
+#include "IoLoop.hpp"
+
+namespace {
+
+// Time the reader gets to open the port and take the lines
+constexpr std::chrono::milliseconds SETTLE{300};
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief The loop thread and its services in the order main() builds them.
+ */
+struct Services {
+  explicit Services(const AppConfig &config) : device(io, config), clock(io) {
+    io.start();
+  }
+
+  IoLoop io;
+  Device device;
+  ClockService clock;
+};
+
+/**
+ * @brief Requests the stop like main() and times the teardown.
+ */
+std::chrono::microseconds timeShutdown(std::optional<Services> &services) {
+  Clock::time_point requested = Clock::now();
+  services->device.stop();
+  services.reset(); // Clock, Device, then the loop
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                               requested);
+}
+
+} // namespace
+
+/**
+ * @brief A pty stands in for the indicator.
+ */
+class Shutdown : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char name[64];
+    ASSERT_EQ(openpty(&master, &slave, name, nullptr, nullptr), 0);
+    config.port = name;
+  }
+
+  void TearDown() override {
+    close(master);
+    close(slave);
+  }
+
+  void send(std::string_view lines) {
+    ASSERT_EQ(write(master, lines.data(), lines.size()),
+              static_cast<ssize_t>(lines.size()));
+  }
+
+  int master = -1;
+  int slave = -1;
+  AppConfig config;
+};
+
+TEST_F(Shutdown, StreamingIndicator) {
+  std::optional<Services> services(std::in_place, config);
+
+  // Weights keep arriving while the stop is requested
+  std::atomic<bool> streaming{true};
+  std::thread indicator([&] {
+    while (streaming) {
+      send("1337\n");
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+  });
+  std::this_thread::sleep_for(SETTLE);
+  ASSERT_GT(services->device.getLinkStatus().frames, 0u);
+
+  auto elapsed = timeShutdown(services);
+  streaming = false;
+  indicator.join();
+
+  EXPECT_LT(elapsed, SHUTDOWN_BUDGET);
+}
+
+TEST_F(Shutdown, SilentIndicator) {
+  std::optional<Services> services(std::in_place, config);
+  std::this_thread::sleep_for(SETTLE);
+
+  EXPECT_LT(timeShutdown(services), SHUTDOWN_BUDGET);
+}
+
+TEST_F(Shutdown, MissingPort) {
+  // The reader waits out its reconnect backoff, the stop must cut it short
+  config.port = "/dev/ppw-test-missing";
+  std::optional<Services> services(std::in_place, config);
+  std::this_thread::sleep_for(SETTLE);
+
+  EXPECT_LT(timeShutdown(services), SHUTDOWN_BUDGET);
+}
@@ -0,0 +1,153 @@
+// Clients of the local API and its settings.
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "AllocationCounter.hpp"
+#include "Config.hpp"
+#include "QRManager.hpp"
+#include "TelemetryServer.hpp"
+
+namespace {
+
+// Clients sending more than MAX_REQUEST_LENGTH without a newline
+constexpr int OVERSIZE_CLIENTS = 2000;
+constexpr std::size_t OVERSIZE_BYTES = MAX_REQUEST_LENGTH + 504;
+
+// Growth of the resident set allowed after the first clients
+constexpr uint64_t RSS_SLACK = 2 * 1024 * 1024;
+
+std::string socketPath() { return testing::TempDir() + "ppw-api-test.sock"; }
+
+// Connected and blocking, with a receive timeout so a test never hangs
+int connectTo(const std::string &path) {
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return -1;
+
+  timeval timeout{2, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+  if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) <
+      0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// A TCP port nobody listens on right now
+uint16_t freePort() {
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+  getsockname(fd, reinterpret_cast<sockaddr *>(&address), &length);
+  close(fd);
+  return ntohs(address.sin_port);
+}
+
+// Sends an overlong request and waits until the server hangs up
+bool sendOversize(const std::string &path) {
+  int fd = connectTo(path);
+  if (fd < 0)
+    return false;
+
+  std::string request(OVERSIZE_BYTES, 'x');
+  send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+
+  char buffer[64];
+  ssize_t bytes;
+  while ((bytes = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+  }
+  close(fd);
+  return bytes == 0 || errno == ECONNRESET;
+}
+
+} // namespace
+
+TEST(TelemetryServer, OversizeRequestsDoNotGrowMemory) {
+  QRManager qr;
+  TelemetryConfig config;
+  config.socketPath = socketPath();
+  TelemetryServer api([] { return WeightReading{}; }, qr, config);
+
+  // Let the pool reach its working size
+  for (int i = 0; i < OVERSIZE_CLIENTS / 10; ++i)
+    ASSERT_TRUE(sendOversize(config.socketPath));
+  uint64_t before = getResidentBytes();
+
+  for (int i = 0; i < OVERSIZE_CLIENTS; ++i)
+    ASSERT_TRUE(sendOversize(config.socketPath)) << i;
+  EXPECT_LT(getResidentBytes(), before + RSS_SLACK);
+}
+
+TEST(TelemetryServer, TcpIsServedOnLoopback) {
+  QRManager qr;
+  TelemetryConfig config;
+  config.socketPath = socketPath();
+  config.tcpPort = freePort();
+  EXPECT_STREQ(config.tcpAddress.c_str(), "127.0.0.1");
+  TelemetryServer api([] { return WeightReading{}; }, qr, config);
+
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  timeval timeout{2, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(config.tcpPort);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr *>(&address),
+                    sizeof(address)),
+            0);
+
+  std::string request = "{\"cmd\":\"get\"}\n";
+  send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+  char reply[512];
+  ssize_t bytes = recv(fd, reply, sizeof(reply), 0);
+  close(fd);
+  ASSERT_GT(bytes, 0);
+  EXPECT_TRUE(std::string_view(reply, static_cast<std::size_t>(bytes))
+                  .starts_with("{\"type\":\"state\""));
+}
+
+TEST(ApiSettings, ParsedFromTheConfiguration) {
+  char path[] = "/tmp/ppw-api-XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+
+  AppConfig config;
+  EXPECT_EQ(config.apiPort, 0);
+  EXPECT_EQ(config.apiAddress, "127.0.0.1");
+
+  std::ofstream(path) << "api_port = 7007\napi_address = 10.0.0.5\n";
+  EXPECT_TRUE(loadConfig(path, config));
+  EXPECT_EQ(config.apiPort, 7007);
+  EXPECT_EQ(config.apiAddress, "10.0.0.5");
+
+  for (const char *invalid : {"api_port = 70000\n", "api_port = -1\n",
+                              "api_address = shop\n"}) {
+    std::ofstream(path) << invalid;
+    AppConfig kept = config;
+    EXPECT_FALSE(loadConfig(path, kept)) << invalid;
+    EXPECT_EQ(kept, config);
+  }
+  std::remove(path);
+}
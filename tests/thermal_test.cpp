@@ -0,0 +1,128 @@
+// Thermal samples read from a stand-in sysfs and the quality steps.
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "ThermalMonitor.hpp"
+
+namespace {
+
+// Longest wait for the sampler to read a root
+constexpr std::chrono::seconds SAMPLE_TIMEOUT{2};
+
+using Clock = std::chrono::steady_clock;
+
+void writeFile(const std::filesystem::path &path, const char *text) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream(path) << text;
+}
+
+// Waits for the sampler to read its root
+ThermalSample firstSample(const ThermalMonitor &monitor) {
+  auto deadline = Clock::now() + SAMPLE_TIMEOUT;
+  ThermalSample sample = monitor.latest();
+  while (sample.milliCelsius == 0 && Clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    sample = monitor.latest();
+  }
+  return sample;
+}
+
+// A Pi 5 at 50 C, idling at 1.5 of 2.4 GHz
+ThermalSample idle() {
+  ThermalSample sample;
+  sample.milliCelsius = 50000;
+  sample.curKHz = 1500000;
+  sample.maxKHz = 2400000;
+  sample.limitKHz = 2400000;
+  return sample;
+}
+
+} // namespace
+
+TEST(ThermalSample, ThrottledFollowsTheFirmwareFlags) {
+  ThermalSample sample = idle();
+  EXPECT_FALSE(sample.throttled());
+
+  // An administrator's cap is not throttling
+  sample.maxKHz = 1800000;
+  EXPECT_FALSE(sample.throttled());
+
+  sample.firmwareFlags = 0x4; // Throttled now
+  EXPECT_TRUE(sample.throttled());
+  sample.firmwareFlags = 0x8; // Soft temperature limit
+  EXPECT_TRUE(sample.throttled());
+
+  // Throttled and under-voltage since boot, but not now
+  sample.firmwareFlags = 0x50000;
+  EXPECT_FALSE(sample.throttled());
+}
+
+TEST(ThermalMonitor, ReadsTheFilesBelowItsRoot) {
+  std::filesystem::path root =
+      std::filesystem::path(testing::TempDir()) / "thermal-test";
+  std::filesystem::remove_all(root);
+  writeFile(root / THERMAL_ZONE_TEMP, "81234\n");
+  writeFile(root / CPU_CUR_FREQ, "1500000\n");
+  writeFile(root / CPU_MAX_FREQ, "2400000\n");
+  writeFile(root / CPU_LIMIT_FREQ, "2400000\n");
+  // Pi 5 layout, reached through the firmware driver
+  writeFile(root / "bus/platform/drivers/raspberrypi-firmware" /
+                "soc@107c000000:firmware/get_throttled",
+            "50005\n");
+
+  ThermalMonitor monitor(root.string());
+  ThermalSample sample = firstSample(monitor);
+
+  EXPECT_EQ(sample.milliCelsius, 81234);
+  EXPECT_EQ(sample.curKHz, 1500000);
+  EXPECT_EQ(sample.maxKHz, 2400000);
+  EXPECT_EQ(sample.limitKHz, 2400000);
+  EXPECT_EQ(sample.firmwareFlags, 0x50005u);
+  EXPECT_TRUE(sample.throttled());
+
+  std::filesystem::remove_all(root);
+}
+
+TEST(ThermalMonitor, FindsTheFirmwareFlagsOnTheDevicePath) {
+  std::filesystem::path root =
+      std::filesystem::path(testing::TempDir()) / "thermal-device-test";
+  std::filesystem::remove_all(root);
+  writeFile(root / THERMAL_ZONE_TEMP, "60000\n");
+  writeFile(root / "devices/platform/soc@107c000000" /
+                "soc@107c000000:firmware/get_throttled",
+            "0x4\n");
+
+  ThermalMonitor monitor(root.string());
+  ThermalSample sample = firstSample(monitor);
+
+  EXPECT_EQ(sample.milliCelsius, 60000);
+  EXPECT_EQ(sample.firmwareFlags, 0x4u);
+  EXPECT_TRUE(sample.throttled());
+
+  std::filesystem::remove_all(root);
+}
+
+TEST(QualityController, StepsDownWhileThrottledAndBackWhenCalm) {
+  QualityController quality;
+  auto now = Clock::now();
+
+  ThermalSample throttled = idle();
+  throttled.firmwareFlags = 0x4;
+  EXPECT_EQ(quality.update(throttled, now), Quality::REDUCED);
+  now += THERMAL_PERIOD;
+  EXPECT_EQ(quality.update(throttled, now), Quality::MINIMAL);
+
+  // A capped but unthrottled CPU is calm
+  ThermalSample capped = idle();
+  capped.maxKHz = 1800000;
+  for (int i = 0; i < QUALITY_RECOVER; ++i) {
+    now += THERMAL_PERIOD;
+    quality.update(capped, now);
+  }
+  EXPECT_EQ(quality.get(), Quality::REDUCED);
+}
@@ -0,0 +1,147 @@
+// Notch filters, the disturbance analysis and the vibration filter.
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <thread>
+
+#include "VibrationFilter.hpp"
+
+namespace {
+
+// Indicator rate and a platform shaking at 8 Hz
+constexpr double SAMPLE_RATE = 50.0;
+constexpr double SHAKE_FREQUENCY = 8.0;
+constexpr double SHAKE_AMPLITUDE = 20.0;
+
+// Load on the platform in grams
+constexpr double LOAD = 1000.0;
+
+double shake(std::size_t n, double cycles = SHAKE_FREQUENCY / SAMPLE_RATE) {
+  return SHAKE_AMPLITUDE * std::sin(2.0 * std::numbers::pi * cycles * n);
+}
+
+double rms(double sumOfSquares, std::size_t count) {
+  return std::sqrt(sumOfSquares / static_cast<double>(count));
+}
+
+} // namespace
+
+TEST(NotchCascade, RemovesItsFrequencyAndPassesDc) {
+  constexpr double CYCLES = SHAKE_FREQUENCY / SAMPLE_RATE;
+
+  NotchSet set;
+  set.count = 1;
+  set.notches[0] = NotchCoefficients::at(CYCLES);
+  set.ids[0] = 1;
+
+  NotchCascade cascade;
+  cascade.set(set);
+  ASSERT_EQ(cascade.size(), 1u);
+
+  double residual = 0.0;
+  std::size_t counted = 0;
+  for (std::size_t n = 0; n < 2000; ++n) {
+    double y = cascade.process(LOAD + shake(n, CYCLES));
+    if (n >= 1000) {
+      residual += (y - LOAD) * (y - LOAD);
+      ++counted;
+    }
+  }
+  EXPECT_LT(rms(residual, counted), 0.5);
+
+  // Away from the notch the signal passes
+  NotchCascade wide;
+  wide.set(set);
+  double passed = 0.0;
+  for (std::size_t n = 0; n < 2000; ++n) {
+    double y = wide.process(LOAD + shake(n, 0.01)) - LOAD;
+    if (n >= 1000)
+      passed += y * y;
+  }
+  EXPECT_GT(rms(passed, 1000), 0.8 * SHAKE_AMPLITUDE / std::numbers::sqrt2);
+}
+
+TEST(NotchCascade, EmptySetPassesSamples) {
+  NotchCascade cascade;
+  EXPECT_EQ(cascade.size(), 0u);
+  EXPECT_DOUBLE_EQ(cascade.process(1337.0), 1337.0);
+}
+
+TEST(VibrationAnalyzer, FindsTheDisturbance) {
+  constexpr double CYCLES = 0.0625;
+
+  std::array<float, VIBRATION_WINDOW> samples{};
+  for (std::size_t n = 0; n < samples.size(); ++n)
+    samples[n] = static_cast<float>(LOAD + shake(n, CYCLES));
+
+  VibrationAnalyzer analyzer;
+  std::array<VibrationPeak, VIBRATION_NOTCHES> peaks{};
+  ASSERT_GE(analyzer.analyze(samples.data(), peaks), 1u);
+  EXPECT_NEAR(peaks[0].frequency, CYCLES, 0.5 / VIBRATION_WINDOW);
+  EXPECT_NEAR(peaks[0].amplitude, SHAKE_AMPLITUDE, 0.2 * SHAKE_AMPLITUDE);
+}
+
+TEST(VibrationAnalyzer, SteadyLoadHasNoDisturbance) {
+  std::array<float, VIBRATION_WINDOW> samples{};
+  samples.fill(static_cast<float>(LOAD));
+
+  VibrationAnalyzer analyzer;
+  std::array<VibrationPeak, VIBRATION_NOTCHES> peaks{};
+  EXPECT_EQ(analyzer.analyze(samples.data(), peaks), 0u);
+}
+
+TEST(VibrationFilter, NotchesAShakingPlatform) {
+  constexpr std::size_t SAMPLES = 3000; // One minute at 50 Hz
+
+  VibrationFilter filter;
+  auto now = std::chrono::steady_clock::now();
+  auto period = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(1.0 / SAMPLE_RATE));
+
+  double before = 0.0;
+  double after = 0.0;
+  std::size_t counted = 0;
+  for (std::size_t n = 0; n < SAMPLES; ++n) {
+    now += period;
+    auto raw = static_cast<int32_t>(std::lround(LOAD + shake(n)));
+    int32_t filtered = filter.filter(raw, now);
+
+    // Give the worker time for every handed window
+    if (n % VIBRATION_HOP == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    if (n >= SAMPLES / 2) {
+      before += (raw - LOAD) * (raw - LOAD);
+      after += (filtered - LOAD) * (filtered - LOAD);
+      ++counted;
+    }
+  }
+
+  EXPECT_LT(rms(after, counted), 0.1 * rms(before, counted));
+}
+
+TEST(VibrationFilter, DisabledPassesSamples) {
+  VibrationFilter filter;
+  filter.setEnabled(false);
+
+  auto now = std::chrono::steady_clock::now();
+  for (std::size_t n = 0; n < 1000; ++n) {
+    now += std::chrono::milliseconds(20);
+    auto raw = static_cast<int32_t>(std::lround(LOAD + shake(n)));
+    ASSERT_EQ(filter.filter(raw, now), raw);
+  }
+}
+
+TEST(VibrationFilter, SteadyLoadPassesUnchanged) {
+  VibrationFilter filter;
+  auto now = std::chrono::steady_clock::now();
+  for (std::size_t n = 0; n < 1000; ++n) {
+    now += std::chrono::milliseconds(20);
+    ASSERT_EQ(filter.filter(1337, now), 1337);
+    if (n % VIBRATION_HOP == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
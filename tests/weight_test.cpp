@@ -0,0 +1,283 @@
+// Weight pipeline and the indicator line parser of Device.
+#include <gtest/gtest.h>
+
+#include <pty.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <string_view>
+#include <thread>
+
+#include "Config.hpp"
+#include "Device.hpp"
+#include "IoLoop.hpp"
+#include "WeightPipeline.hpp"
+
+namespace {
+
+// Longest wait for the reader to take written lines
+constexpr std::chrono::seconds READ_TIMEOUT{2};
+
+// Feed one raw value until the motion window is full of it
+WeightReading settle(WeightPipeline &pipeline, int32_t raw) {
+  WeightReading reading;
+  for (std::size_t i = 0; i < MOTION_WINDOW; ++i)
+    reading = pipeline.process(raw);
+  return reading;
+}
+
+std::string_view format(const WeightReading &reading, char *text) {
+  return {text, formatWeight(reading, text, WEIGHT_TEXT_LENGTH)};
+}
+
+} // namespace
+
+TEST(WeightPipeline, StableOnceTheMotionWindowIsFull) {
+  WeightPipeline pipeline;
+  EXPECT_FALSE(pipeline.process(1000).stable);
+  EXPECT_TRUE(settle(pipeline, 1000).stable);
+
+  // A jump beyond the motion band is motion again
+  EXPECT_FALSE(pipeline.process(1100).stable);
+}
+
+TEST(WeightPipeline, TareWaitsForAStableSample) {
+  WeightPipeline pipeline;
+  pipeline.requestTare();
+
+  WeightReading moving = pipeline.process(500);
+  EXPECT_EQ(moving.tare, 0);
+  EXPECT_EQ(moving.net, 500);
+
+  WeightReading tared = settle(pipeline, 500);
+  EXPECT_EQ(tared.tare, 500);
+  EXPECT_EQ(tared.net, 0);
+  EXPECT_EQ(tared.gross, 500);
+
+  WeightReading loaded = settle(pipeline, 1837);
+  EXPECT_EQ(loaded.net, 1337);
+  EXPECT_EQ(loaded.gross, 1837);
+}
+
+TEST(WeightPipeline, ZeroTrackingFollowsDriftOnAnEmptyPlatform) {
+  WeightPipeline pipeline;
+  WeightReading reading;
+  for (int i = 0; i < 200; ++i)
+    reading = pipeline.process(2);
+  EXPECT_EQ(reading.gross, 0);
+
+  // A load outside the band is never tracked away
+  WeightPipeline loaded;
+  for (int i = 0; i < 200; ++i)
+    reading = loaded.process(50);
+  EXPECT_EQ(reading.gross, 50);
+}
+
+TEST(WeightPipeline, RangeChecks) {
+  WeightPipeline pipeline;
+  char text[WEIGHT_TEXT_LENGTH];
+
+  WeightReading over = pipeline.process(MAX_WEIGHT + 1);
+  EXPECT_TRUE(over.overload);
+  EXPECT_FALSE(over.valid());
+  EXPECT_EQ(format(over, text), "OL");
+
+  WeightReading under = pipeline.process(MIN_WEIGHT - 1);
+  EXPECT_TRUE(under.underload);
+  EXPECT_EQ(format(under, text), "UL");
+
+  WeightReading stale = pipeline.process(1000);
+  stale.stale = true;
+  EXPECT_EQ(format(stale, text), "---");
+}
+
+TEST(WeightPipeline, ConvertsToKilogramsAndPounds) {
+  char text[WEIGHT_TEXT_LENGTH];
+
+  WeightConfig config;
+  config.unit = WeightUnit::KILOGRAM;
+  WeightPipeline kilograms(config);
+  WeightReading reading = kilograms.process(1337);
+  EXPECT_EQ(reading.value, 1337);
+  EXPECT_EQ(reading.decimals, 3);
+  EXPECT_EQ(format(reading, text), "1.337");
+  EXPECT_EQ(format(kilograms.process(-5), text), "-0.005");
+
+  // 1000 g are 2.20462 lb
+  config.unit = WeightUnit::POUND;
+  WeightPipeline pounds(config);
+  EXPECT_EQ(format(pounds.process(1000), text), "2.205");
+}
+
+TEST(WeightPipeline, DivisionAndRounding) {
+  WeightConfig config;
+  config.division = 5;
+  WeightPipeline nearest(config);
+  EXPECT_EQ(nearest.process(1337).value, 1335);
+  EXPECT_EQ(nearest.process(1338).value, 1340);
+  EXPECT_EQ(nearest.process(-1338).value, -1340);
+
+  config.rounding = WeightRounding::DOWN;
+  WeightPipeline down(config);
+  EXPECT_EQ(down.process(1339).value, 1335);
+  EXPECT_EQ(down.process(-1339).value, -1335);
+}
+
+TEST(WeightPipeline, ConfigureKeepsTare) {
+  WeightPipeline pipeline;
+  pipeline.requestTare();
+  settle(pipeline, 500);
+
+  WeightConfig config;
+  config.unit = WeightUnit::KILOGRAM;
+  pipeline.configure(config);
+
+  WeightReading reading = pipeline.process(1500);
+  EXPECT_EQ(reading.tare, 500);
+  EXPECT_EQ(reading.value, 1000);
+  EXPECT_EQ(reading.unit, WeightUnit::KILOGRAM);
+}
+
+TEST(FormatWeight, RejectsShortBuffers) {
+  char text[WEIGHT_TEXT_LENGTH - 1];
+  WeightReading reading;
+  EXPECT_EQ(formatWeight(reading, text, sizeof(text)), 0u);
+  EXPECT_EQ(text[0], '\0');
+}
+
+TEST(WeightSettings, ParsedFromTheConfiguration) {
+  char path[] = "/tmp/ppw-weight-XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+
+  std::ofstream(path) << "unit = lb\ndivision = 5\nrounding = down\n";
+  AppConfig config;
+  EXPECT_TRUE(loadConfig(path, config));
+
+  WeightConfig weight = toWeightConfig(config);
+  EXPECT_EQ(weight.unit, WeightUnit::POUND);
+  EXPECT_EQ(weight.division, 5);
+  EXPECT_EQ(weight.rounding, WeightRounding::DOWN);
+  EXPECT_EQ(weight.motionBand, WeightConfig{}.motionBand);
+
+  // Unknown units and steps are rejected, the old configuration is kept
+  for (const char *invalid : {"unit = oz\n", "division = 0\n",
+                              "rounding = up\n"}) {
+    std::ofstream(path) << invalid;
+    AppConfig kept = config;
+    EXPECT_FALSE(loadConfig(path, kept)) << invalid;
+    EXPECT_EQ(kept, config);
+  }
+  std::remove(path);
+}
+
+/**
+ * @brief A Device reading indicator lines from a pty.
+ */
+class DeviceLines : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char name[64];
+    ASSERT_EQ(openpty(&master, &slave, name, nullptr, nullptr), 0);
+
+    AppConfig config;
+    config.port = name;
+    config.vibrationFilter = false; // Samples reach the pipeline as sent.
+
+    device.emplace(io, config);
+    io.start();
+  }
+
+  void TearDown() override {
+    device.reset();
+    close(master);
+    close(slave);
+  }
+
+  void send(std::string_view lines) {
+    ASSERT_EQ(write(master, lines.data(), lines.size()),
+              static_cast<ssize_t>(lines.size()));
+  }
+
+  // Waits until the reader counted the weights and errors
+  LinkStatus waitFor(uint64_t frames, uint64_t errors) {
+    auto giveUp = std::chrono::steady_clock::now() + READ_TIMEOUT;
+    LinkStatus status = device->getLinkStatus();
+    while ((status.frames < frames || status.errors < errors) &&
+           std::chrono::steady_clock::now() < giveUp) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      status = device->getLinkStatus();
+    }
+    return status;
+  }
+
+  int master = -1;
+  int slave = -1;
+  IoLoop io;
+  std::optional<Device> device;
+};
+
+TEST_F(DeviceLines, ParsesPaddedAndSignedWeights) {
+  send("1200\n");
+  LinkStatus status = waitFor(1, 0);
+  EXPECT_EQ(status.frames, 1u);
+  EXPECT_EQ(device->getReading().gross, 1200);
+
+  send("  +1300\r\n");
+  status = waitFor(2, 0);
+  EXPECT_EQ(status.frames, 2u);
+  EXPECT_EQ(status.errors, 0u);
+  EXPECT_EQ(device->getReading().gross, 1300);
+
+  send("-150\n");
+  waitFor(3, 0);
+  EXPECT_EQ(device->getReading().gross, -150);
+}
+
+TEST_F(DeviceLines, CountsGarbageAsErrors) {
+  send("12a4\n");
+  send("99999999999\n"); // Beyond int32_t
+  LinkStatus status = waitFor(0, 2);
+  EXPECT_EQ(status.frames, 0u);
+  EXPECT_EQ(status.errors, 2u);
+
+  // The next good line is taken as usual
+  send("1337\n");
+  status = waitFor(1, 2);
+  EXPECT_EQ(status.frames, 1u);
+  EXPECT_EQ(device->getReading().gross, 1337);
+  EXPECT_EQ(status.state, LinkState::ONLINE);
+}
+
+TEST_F(DeviceLines, WeightConfigAppliesToTheNextSample) {
+  send("1337\n");
+  waitFor(1, 0);
+  EXPECT_EQ(device->getReading().unit, WeightUnit::GRAM);
+
+  WeightConfig config;
+  config.unit = WeightUnit::KILOGRAM;
+  config.division = 10;
+  device->setWeightConfig(config);
+
+  send("1337\n");
+  waitFor(2, 0);
+  WeightReading reading = device->getReading();
+  EXPECT_EQ(reading.unit, WeightUnit::KILOGRAM);
+  EXPECT_EQ(reading.decimals, 3);
+  EXPECT_EQ(reading.value, 1340);
+}
+
+TEST_F(DeviceLines, ReadingTurnsStaleWhenTheIndicatorFallsSilent) {
+  send("1000\n");
+  waitFor(1, 0);
+  EXPECT_FALSE(device->getReading().stale);
+
+  std::this_thread::sleep_for(LINK_STALE_AFTER +
+                              std::chrono::milliseconds(50));
+  EXPECT_TRUE(device->getReading().stale);
+}
@@ -15,10 +15,11 @@ set(CMAKE_SYSROOT "${SYSROOT}")
 set(CMAKE_SYSROOT_COMPILE "${SYSROOT}")
 set(CMAKE_SYSROOT_LINK "${SYSROOT}")
 
-# Force flags
+# Force flags, tuned for the Pi 5 (Cortex-A76)
 set(RPI TRUE)
-set(CMAKE_C_FLAGS "--sysroot=${SYSROOT} ${CMAKE_C_FLAGS}")
-set(CMAKE_CXX_FLAGS "--sysroot=${SYSROOT} ${CMAKE_CXX_FLAGS}")
+set(PI_CPU_FLAGS "-mcpu=cortex-a76")
+set(CMAKE_C_FLAGS "--sysroot=${SYSROOT} ${PI_CPU_FLAGS} ${CMAKE_C_FLAGS}")
+set(CMAKE_CXX_FLAGS "--sysroot=${SYSROOT} ${PI_CPU_FLAGS} ${CMAKE_CXX_FLAGS}")
 
 # Find libraries in the sysroot
 set(CMAKE_FIND_ROOT_PATH 
@@ -0,0 +1,83 @@
+// Writes the newest frame of the shared-memory mirror as a binary PPM.
+//
+//   ssh pi mirror-dump > frame.ppm
+//   mirror-dump 5 > frames.ppm    (one frame a second, 5 of them)
+//
+// The application publishes frames when mirror_fps in ppw.conf is not 0.
+// Reading never blocks it; a frame rewritten during the copy is read again.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "FrameMirror.hpp"
+
+namespace {
+
+// ARGB8888 rows to RGB, as PPM stores them
+bool writePpm(const MirrorHeader &header, const std::vector<uint8_t> &pixels,
+              std::vector<uint8_t> &rgb) {
+  std::printf("P6\n%d %d\n255\n", header.width, header.height);
+
+  rgb.resize(static_cast<std::size_t>(header.width) * 3);
+  for (int y = 0; y < header.height; ++y) {
+    const uint8_t *row = pixels.data() + static_cast<std::size_t>(y) *
+                                             static_cast<std::size_t>(
+                                                 header.pitch);
+    for (int x = 0; x < header.width; ++x) {
+      uint32_t argb = 0;
+      std::memcpy(&argb, row + x * 4, sizeof(argb));
+      rgb[x * 3] = static_cast<uint8_t>(argb >> 16);
+      rgb[x * 3 + 1] = static_cast<uint8_t>(argb >> 8);
+      rgb[x * 3 + 2] = static_cast<uint8_t>(argb);
+    }
+    if (std::fwrite(rgb.data(), 1, rgb.size(), stdout) != rgb.size())
+      return false;
+  }
+  return std::fflush(stdout) == 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int count = argc > 1 ? std::atoi(argv[1]) : 1;
+  if (count <= 0) {
+    std::cerr << "usage: mirror-dump [frames]\n";
+    return EXIT_FAILURE;
+  }
+
+  FrameMirrorReader reader;
+  if (!reader.open()) {
+    std::cerr << "[Mirror] No mirror at /dev/shm" << MIRROR_NAME
+              << ", is mirror_fps set?\n";
+    return EXIT_FAILURE;
+  }
+
+  const MirrorHeader &header = *reader.getHeader();
+  std::vector<uint8_t> pixels(static_cast<std::size_t>(header.pitch) *
+                              static_cast<std::size_t>(header.height));
+  std::vector<uint8_t> rgb;
+
+  for (int i = 0; i < count; ++i) {
+    if (i > 0)
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    MirrorFrame frame;
+    if (!reader.copyLatest(pixels.data(), frame)) {
+      std::cerr << "[Mirror] No complete frame yet\n";
+      return EXIT_FAILURE;
+    }
+
+    std::cerr << "[Mirror] Frame " << frame.frame << ", changed "
+              << frame.dirty.w << "x" << frame.dirty.h << " at "
+              << frame.dirty.x << "," << frame.dirty.y << "\n";
+    if (!writePpm(header, pixels, rgb))
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}